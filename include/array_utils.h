@@ -9,11 +9,30 @@
  */
 class ArrayUtils {
 public:
+  // when one list is this many times larger than the other, galloping beats a linear merge
+  static constexpr size_t GALLOPING_SIZE_RATIO = 32;
+
   // Fast scalar scheme designed by N. Kurz. Returns the size of out (intersected set)
+  // Dispatches to a galloping or a vectorized kernel depending on list sizes and CPU support.
   static size_t and_scalar(const uint32_t *A, const size_t lenA, const uint32_t *B, const size_t lenB, uint32_t **out);
 
+  // Same as `and_scalar` but writes into a caller provided buffer of at least min(lenA, lenB) elements
+  static size_t and_into(const uint32_t *A, const size_t lenA, const uint32_t *B, const size_t lenB, uint32_t *out);
+
   static size_t or_scalar(const uint32_t *A, const size_t lenA, const uint32_t *B, const size_t lenB, uint32_t **out);
 
   static size_t exclude_scalar(const uint32_t *src, const size_t lenSrc, const uint32_t *filter, const size_t lenFilter,
                               uint32_t **out);
-};
\ No newline at end of file
+
+  // Returns index of the first element in arr[from, len) that is >= target (or `len` when there is none)
+  static size_t gallop_lower_bound(const uint32_t *arr, size_t from, size_t len, uint32_t target);
+
+  // individual kernels: exposed for tests and benchmarks
+
+  static size_t and_merge(const uint32_t *A, const size_t lenA, const uint32_t *B, const size_t lenB, uint32_t *out);
+
+  static size_t and_galloping(const uint32_t *small, const size_t lenSmall,
+                              const uint32_t *large, const size_t lenLarge, uint32_t *out);
+
+  static size_t and_vector(const uint32_t *A, const size_t lenA, const uint32_t *B, const size_t lenB, uint32_t *out);
+};
@@ -8,6 +8,8 @@
 #include "array.h"
 #include "sorted_array.h"
 
+class filter_iterator_t;
+
 #define IGNORE_PRINTF 1
 
 #ifdef __cplusplus
@@ -45,6 +47,7 @@ typedef struct {
     uint8_t num_children;
     uint8_t partial_len;
     unsigned char partial[MAX_PREFIX_LEN];
+    uint32_t max_token_count;
     int64_t max_score;
 } art_node;
 
@@ -272,9 +275,45 @@ int art_iter_prefix(art_tree *t, const unsigned char *prefix, int prefix_len, ar
  */
 int art_fuzzy_search(art_tree *t, const unsigned char *term, const int term_len, const int min_cost, const int max_cost,
                      const int max_words, const token_ordering token_order, const bool prefix,
-                     const uint32_t *filter_ids, size_t filter_ids_length,
+                     filter_iterator_t* filter_it,
                      std::vector<art_leaf *> &results, const std::set<std::string>& exclude_leaves = {});
 
+/**
+ * Collects every leaf that matches the term within the fuzzy distances, unranked and regardless of filters.
+ * Returns false, leaving `candidates` empty, when there are more than `max_leaves` of them.
+ */
+bool art_fuzzy_candidates(art_tree *t, const unsigned char *term, const int term_len, const int min_cost,
+                          const int max_cost, const bool prefix, const size_t max_leaves,
+                          std::vector<art_leaf *>& candidates);
+
+/**
+ * Same as art_fuzzy_search, but picks the results from candidates found earlier by art_fuzzy_candidates.
+ * The candidates must have been collected since the last time a key was inserted into or deleted from the tree.
+ */
+int art_fuzzy_search_candidates(art_tree *t, const std::vector<art_leaf *>& candidates,
+                                const unsigned char *term, const int term_len, const int min_cost,
+                                const int max_words, const token_ordering token_order, const bool prefix,
+                                filter_iterator_t* filter_it,
+                                std::vector<art_leaf *> &results, const std::set<std::string>& exclude_leaves);
+
+/**
+ * Collects the `max_results` leaves under `root` that have the highest frequency or max score, in that order.
+ * The subtree aggregates of a node are upper bounds of its leaves, so nodes are expanded best-first and the search
+ * stops as soon as enough leaves are found.
+ */
+int art_topk_iter(const art_node *root, token_ordering token_order, size_t max_results,
+                  filter_iterator_t* filter_it,
+                  const std::set<std::string>& exclude_leaves, const art_leaf* exact_leaf,
+                  std::vector<art_leaf *>& results);
+
+/**
+ * Collects the nodes under which all keys are within [min_cost, max_cost] edit distance of the term. Edit distances
+ * are computed bit-parallel for terms of up to 64 bytes; `bit_parallel = false` forces a full DP row per character.
+ */
+void art_fuzzy_nodes(art_tree *t, const unsigned char *term, const int term_len, const int min_cost,
+                     const int max_cost, const bool prefix, const bool bit_parallel,
+                     std::vector<const art_node*>& nodes);
+
 void encode_int32(int32_t n, unsigned char *chars);
 
 void encode_int64(int64_t n, unsigned char *chars);
@@ -155,6 +155,11 @@ private:
     static Option<bool> parse_pinned_hits(const std::string& pinned_hits_str,
                                    std::map<size_t, std::vector<std::string>>& pinned_hits);
 
+    // cursor of a hit for `search_after`: its scores and seq_id, encoded to be passed back verbatim
+    static std::string get_search_after_cursor(const KV* kv);
+
+    static Option<bool> parse_search_after_cursor(const std::string& search_after, int64_t* scores, uint64_t& key);
+
     Index* init_index();
 
     static std::vector<char> to_char_array(const std::vector<std::string>& strs);
@@ -257,6 +262,12 @@ public:
 
     Option<bool> get_document_from_store(const uint32_t& seq_id, nlohmann::json & document) const;
 
+    // fetches the documents of all the keys in one batched store lookup: `document_ops[i]` is the outcome for
+    // `seq_id_keys[i]`
+    void get_documents_from_store(const std::vector<std::string>& seq_id_keys,
+                                  std::vector<nlohmann::json>& documents,
+                                  std::vector<Option<bool>>& document_ops) const;
+
     Option<uint32_t> index_in_memory(nlohmann::json & document, uint32_t seq_id,
                                      const index_operation_t op, const DIRTY_VALUES& dirty_values);
 
@@ -265,8 +276,11 @@ public:
 
     const Index* _get_index() const;
 
-    bool facet_value_to_string(const facet &a_facet, const facet_count_t &facet_count, const nlohmann::json &document,
-                               std::string &value) const;
+    // parses a range facet of the form `field(start..end, ...)`: either bound of a range can be omitted
+    Option<bool> parse_range_facet(const std::string& facet_str, std::vector<facet>& facets) const;
+
+    // converts the indexed text of a facet value into the value returned in facet results
+    void facet_value_to_string(const facet &a_facet, const std::string& indexed_value, std::string &value) const;
 
     static void populate_result_kvs(Topster *topster, std::vector<std::vector<KV *>> &result_kvs);
 
@@ -329,7 +343,12 @@ public:
                                   const size_t max_extra_prefix = INT16_MAX,
                                   const size_t max_extra_suffix = INT16_MAX,
                                   const size_t facet_query_num_typos = 2,
-                                  const size_t filter_curated_hits_option = 2) const;
+                                  const size_t filter_curated_hits_option = 2,
+                                  const size_t facet_sample_percent = 100,
+                                  const size_t facet_sample_threshold = 0,
+                                  const std::string& search_after = "",
+                                  const std::string& typeahead_session = "",
+                                  const bool explain_filter = false) const;
 
     Option<bool> get_filter_ids(const std::string & simple_filter_query,
                                 std::vector<std::pair<size_t, uint32_t*>>& index_ids);
@@ -342,6 +361,10 @@ public:
 
     size_t get_num_documents() const;
 
+    void get_filter_cache_stats(filter_cache_stats_t& stats) const;
+
+    void get_fuzzy_cache_stats(fuzzy_cache_stats_t& stats) const;
+
     DIRTY_VALUES parse_dirty_values_option(std::string& dirty_values) const;
 
     std::vector<char> get_symbols_to_index();
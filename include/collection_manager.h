@@ -158,6 +158,12 @@ public:
 
     nlohmann::json get_collection_summaries() const;
 
+    // stats of the filter result caches of all collections
+    nlohmann::json get_filter_cache_stats() const;
+
+    // stats of the fuzzy candidate caches of all collections
+    nlohmann::json get_fuzzy_cache_stats() const;
+
     Option<nlohmann::json> drop_collection(const std::string& collection_name, const bool remove_from_store = true);
 
     uint32_t get_next_collection_id() const;
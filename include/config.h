@@ -50,6 +50,8 @@ private:
 
     uint32_t thread_pool_size;
 
+    uint32_t multi_search_concurrency;
+
     bool enable_access_logging;
 
     int disk_used_max_percentage;
@@ -69,6 +71,7 @@ protected:
         this->num_collections_parallel_load = 0;  // will be set dynamically if not overridden
         this->num_documents_parallel_load = 1000;
         this->thread_pool_size = 0; // will be set dynamically if not overridden
+        this->multi_search_concurrency = 4;
         this->ssl_refresh_interval_seconds = 8 * 60 * 60;
         this->enable_access_logging = false;
         this->disk_used_max_percentage = 100;
@@ -241,6 +244,10 @@ public:
         return this->thread_pool_size;
     }
 
+    size_t get_multi_search_concurrency() const {
+        return this->multi_search_concurrency;
+    }
+
     size_t get_ssl_refresh_interval_seconds() const {
         return this->ssl_refresh_interval_seconds;
     }
@@ -352,6 +359,10 @@ public:
             this->thread_pool_size = std::stoi(get_env("TYPESENSE_THREAD_POOL_SIZE"));
         }
 
+        if(!get_env("TYPESENSE_MULTI_SEARCH_CONCURRENCY").empty()) {
+            this->multi_search_concurrency = std::stoi(get_env("TYPESENSE_MULTI_SEARCH_CONCURRENCY"));
+        }
+
         if(!get_env("TYPESENSE_SSL_REFRESH_INTERVAL_SECONDS").empty()) {
             this->ssl_refresh_interval_seconds = std::stoi(get_env("TYPESENSE_SSL_REFRESH_INTERVAL_SECONDS"));
         }
@@ -487,6 +498,10 @@ public:
             this->thread_pool_size = (int) reader.GetInteger("server", "thread-pool-size", 0);
         }
 
+        if(reader.Exists("server", "multi-search-concurrency")) {
+            this->multi_search_concurrency = (int) reader.GetInteger("server", "multi-search-concurrency", 4);
+        }
+
         if(reader.Exists("server", "ssl-refresh-interval-seconds")) {
             this->ssl_refresh_interval_seconds = (int) reader.GetInteger("server", "ssl-refresh-interval-seconds", 8 * 60 * 60);
         }
@@ -604,6 +619,10 @@ public:
             this->thread_pool_size = options.get<uint32_t>("thread-pool-size");
         }
 
+        if(options.exist("multi-search-concurrency")) {
+            this->multi_search_concurrency = options.get<uint32_t>("multi-search-concurrency");
+        }
+
         if(options.exist("ssl-refresh-interval-seconds")) {
             this->ssl_refresh_interval_seconds = options.get<uint32_t>("ssl-refresh-interval-seconds");
         }
@@ -26,6 +26,14 @@ bool get_search(const std::shared_ptr<http_req>& req, const std::shared_ptr<http
 
 bool post_multi_search(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
 
+// Runs the searches of a multi search request with at most `concurrency` of them in flight on the thread pool, and
+// returns their results in the order of the searches. The calling thread also picks up searches, so the request
+// makes progress even when all the threads of the pool are busy. `search_req_params` are updated by the searches.
+void run_multi_searches(std::vector<std::map<std::string, std::string>>& search_req_params,
+                        const std::vector<nlohmann::json>& embedded_params_vec,
+                        ThreadPool* thread_pool, size_t concurrency,
+                        std::vector<nlohmann::json>& search_results);
+
 bool get_export_documents(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
 
 bool post_add_document(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res);
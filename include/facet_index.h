@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "sparsepp.h"
+
+/*
+    Facet values of a field, stored as ordinals.
+
+    Every distinct facet hash of the field is given a dense uint32 ordinal, and the values of each document are
+    stored as a packed array of ordinals in a column indexed by seq_id. This lets facet counts be accumulated in a
+    flat array indexed by ordinal instead of a hash map keyed by the facet hash.
+
+    The column is split into chunks of `CHUNK_SIZE` consecutive seq_ids: the ordinals of all documents of a chunk
+    are kept together in a single array, along with the offset of each document's values.
+
+    Ordinals are reference counted by the number of times they occur across documents, and the ordinals of values
+    that are no longer present in any document are reused. The text of every value is kept along with its ordinal
+    so that facet results can be rendered without reading documents back from the store.
+*/
+class facet_index_t {
+public:
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+private:
+    struct chunk_t {
+        // values of the document at `offset` are `ordinals[offsets[offset]..offsets[offset+1])`
+        uint32_t offsets[CHUNK_SIZE + 1] = {};
+        std::vector<uint32_t> ordinals;
+
+        // documents that have an entry, even an empty one
+        uint64_t present[CHUNK_SIZE / 64] = {};
+        size_t num_docs = 0;
+    };
+
+    // facet hash => ordinal
+    spp::sparse_hash_map<uint64_t, uint32_t> hash_ordinals;
+
+    // indexed by ordinal
+    std::vector<uint64_t> ordinal_hashes;
+    std::vector<std::string> ordinal_values;
+    std::vector<uint32_t> ordinal_refs;
+
+    std::vector<uint32_t> free_ordinals;
+
+    // chunks without any documents are not allocated
+    std::vector<chunk_t*> chunks;
+
+    size_t total_docs = 0;
+
+    uint32_t acquire_ordinal(uint64_t hash, const std::string& value);
+
+    void release_ordinal(uint32_t ordinal);
+
+public:
+
+    facet_index_t() = default;
+
+    facet_index_t(const facet_index_t&) = delete;
+
+    facet_index_t& operator=(const facet_index_t&) = delete;
+
+    ~facet_index_t();
+
+    // Replaces the facet values of `seq_id`, keeping their order. `values` holds the text of each hash: when a
+    // hash is already known, its text is replaced by the one given.
+    void upsert(uint32_t seq_id, const std::vector<uint64_t>& hashes, const std::vector<std::string>& values);
+
+    void erase(uint32_t seq_id);
+
+    bool contains(uint32_t seq_id) const;
+
+    // Returns the ordinals of the values of `seq_id`, in the order they were given, and sets `num_values` to
+    // their count. Returns nullptr when the document has no values.
+    inline const uint32_t* get_ordinals(const uint32_t seq_id, uint32_t& num_values) const {
+        const size_t chunk_index = seq_id / CHUNK_SIZE;
+        if(chunk_index >= chunks.size() || chunks[chunk_index] == nullptr) {
+            num_values = 0;
+            return nullptr;
+        }
+
+        const chunk_t* chunk = chunks[chunk_index];
+        const size_t offset = seq_id % CHUNK_SIZE;
+        num_values = chunk->offsets[offset + 1] - chunk->offsets[offset];
+
+        return (num_values == 0) ? nullptr : chunk->ordinals.data() + chunk->offsets[offset];
+    }
+
+    inline uint64_t get_hash(const uint32_t ordinal) const {
+        return ordinal_hashes[ordinal];
+    }
+
+    // text of the value with the given hash: returns false when the value is not present in any document
+    bool get_value(uint64_t hash, std::string& value) const;
+
+    // upper bound of the ordinals in use: size of a flat array indexed by ordinal
+    inline size_t ordinal_space() const {
+        return ordinal_hashes.size();
+    }
+
+    // number of distinct values present in documents
+    size_t num_values() const;
+
+    size_t num_docs() const;
+};
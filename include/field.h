@@ -40,6 +40,10 @@ namespace fields {
     static const std::string sort = "sort";
     static const std::string infix = "infix";
     static const std::string locale = "locale";
+    static const std::string sort_index = "sort_index";
+
+    // value of `sort_index`: maintains the seq_ids of the field sorted by value
+    static const std::string presorted = "presorted";
 }
 
 struct field {
@@ -51,6 +55,7 @@ struct field {
     std::string locale;
     bool sort;
     bool infix;
+    bool presorted = false;
 
     field() {}
 
@@ -250,6 +255,10 @@ struct field {
             field_val[fields::sort] = field.sort;
             field_val[fields::infix] = field.infix;
 
+            if(field.presorted) {
+                field_val[fields::sort_index] = fields::presorted;
+            }
+
             field_val[fields::locale] = field.locale;
 
             fields_json.push_back(field_val);
@@ -526,9 +535,15 @@ public:
 
 struct facet_count_t {
     uint32_t count = 0;
-    // used to fetch the actual document and value for representation
-    uint32_t doc_id = 0;
-    uint32_t array_pos = 0;
+};
+
+// bucket of a range facet, e.g. `10..50` in `facet_by=price(0..10,10..50,50..)`
+struct facet_range_t {
+    std::string label;
+
+    // inclusive bounds, in the int64 encoding of the field's values in the numerical index
+    int64_t start = INT64_MIN;
+    int64_t end = INT64_MAX;
 };
 
 struct facet_stats_t {
@@ -550,9 +565,30 @@ struct facet {
 
     facet_stats_t stats;
 
+    // counts indexed by the ordinals of the field's facet values: used instead of `result_map` when counting
+    // over large result sets, and folded into `result_map` once all results are counted
+    std::vector<uint32_t> ordinal_counts;
+
+    // whether the counts were estimated from a sample of `sample_size` results
+    bool sampled = false;
+    size_t sample_size = 0;
+
+    // numerical field faceted into buckets of values: `range_counts` holds the number of results in each range
+    std::vector<facet_range_t> ranges;
+    std::vector<uint32_t> range_counts;
+
     explicit facet(const std::string& field_name): field_name(field_name) {
 
     }
+
+    facet(const std::string& field_name, const std::vector<facet_range_t>& ranges):
+            field_name(field_name), ranges(ranges) {
+
+    }
+
+    bool is_range_facet() const {
+        return !ranges.empty();
+    }
 };
 
 struct facet_info_t {
@@ -573,48 +609,3 @@ struct facet_value_t {
     std::string highlighted;
     uint32_t count;
 };
-
-struct facet_hash_values_t {
-    uint32_t length = 0;
-    uint64_t* hashes = nullptr;
-
-    facet_hash_values_t() {
-        length = 0;
-        hashes = nullptr;
-    }
-
-    facet_hash_values_t(facet_hash_values_t&& hash_values) noexcept {
-        length = hash_values.length;
-        hashes = hash_values.hashes;
-
-        hash_values.length = 0;
-        hash_values.hashes = nullptr;
-    }
-
-    facet_hash_values_t& operator=(facet_hash_values_t&& other) noexcept {
-        if (this != &other) {
-            delete[] hashes;
-
-            hashes = other.hashes;
-            length = other.length;
-
-            other.hashes = nullptr;
-            other.length = 0;
-        }
-
-        return *this;
-    }
-
-    ~facet_hash_values_t() {
-        delete [] hashes;
-        hashes = nullptr;
-    }
-
-    uint64_t size() const {
-        return length;
-    }
-
-    uint64_t back() const {
-        return hashes[length - 1];
-    }
-};
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "id_bitmap.h"
+
+/*
+    Iterator over the sorted IDs that satisfy a filter expression.
+
+    Filter expressions are evaluated as a tree of iterators: a leaf represents a single filter clause and inner nodes
+    combine their children. Leaves are materialized only when they have to drive the iteration. When a leaf is only
+    used to check candidates produced elsewhere (another clause, or the documents matching the query's tokens), it
+    can verify a given ID directly (e.g. by looking up the document's value) without computing all of its matching IDs.
+*/
+class filter_iterator_t {
+public:
+    virtual ~filter_iterator_t() = default;
+
+    [[nodiscard]] virtual bool valid() = 0;
+
+    [[nodiscard]] virtual uint32_t id() = 0;
+
+    virtual void next() = 0;
+
+    // moves to the first ID that is >= `id`
+    virtual void skip_to(uint32_t id) = 0;
+
+    // moves back to the first ID
+    virtual void reset() = 0;
+
+    // Checks whether `id` satisfies the filter. Does not move the iterator: IDs can be checked in any order, and
+    // concurrently from many threads.
+    virtual bool contains(uint32_t id) = 0;
+
+    // approximate number of IDs the iterator will produce: used for picking the iterator that drives an AND
+    [[nodiscard]] virtual size_t estimate() const = 0;
+
+    // Called when the iterator will only be used to check the IDs of another iterator producing about
+    // `num_candidates` IDs: lets it decide between checking every candidate and materializing itself.
+    virtual void plan_checks(size_t num_candidates) {}
+
+    // collects all remaining IDs
+    void to_vector(std::vector<uint32_t>& ids);
+};
+
+class filter_leaf_iterator_t: public filter_iterator_t {
+public:
+    typedef std::function<void(id_bitmap_t&)> materializer_t;
+    typedef std::function<bool(uint32_t)> checker_t;
+
+private:
+    materializer_t materializer;
+    checker_t checker;
+    size_t estimated_ids;
+
+    // relative cost of checking a single ID compared to producing an ID during materialization
+    size_t check_cost;
+    bool use_checker;
+
+    // checks made so far: once they have cost about as much as materializing, the leaf is materialized instead
+    std::atomic<size_t> num_checks{0};
+
+    std::once_flag materialize_flag;
+    std::atomic<bool> materialized{false};
+    std::shared_ptr<const id_bitmap_t> bitmap;
+    std::unique_ptr<id_bitmap_t::iterator_t> it;
+
+    void materialize();
+
+    id_bitmap_t::iterator_t& iterator();
+
+public:
+    // `checker` is optional: when it's not given, the leaf will be materialized to check IDs
+    filter_leaf_iterator_t(materializer_t materializer, checker_t checker, size_t estimated_ids,
+                           size_t check_cost = 1);
+
+    // leaf over IDs that are already known, e.g. from a cache
+    explicit filter_leaf_iterator_t(std::shared_ptr<const id_bitmap_t> ids);
+
+    [[nodiscard]] bool valid() override;
+
+    [[nodiscard]] uint32_t id() override;
+
+    void next() override;
+
+    void skip_to(uint32_t id) override;
+
+    void reset() override;
+
+    bool contains(uint32_t id) override;
+
+    [[nodiscard]] size_t estimate() const override;
+
+    void plan_checks(size_t num_candidates) override;
+
+    [[nodiscard]] bool is_materialized() const;
+
+    [[nodiscard]] bool uses_checker() const;
+};
+
+class filter_and_iterator_t: public filter_iterator_t {
+private:
+    // the child with the smallest estimate drives the iteration, while the others only check its IDs
+    std::vector<std::unique_ptr<filter_iterator_t>> children;
+
+    // the driving child is positioned on the first match only when the iteration starts, so that an iterator that
+    // is only used for checking IDs does not materialize it
+    bool started = false;
+
+    void start();
+
+    // moves the driving child to the next ID accepted by all children
+    void advance_to_match();
+
+public:
+    explicit filter_and_iterator_t(std::vector<std::unique_ptr<filter_iterator_t>>&& children);
+
+    [[nodiscard]] bool valid() override;
+
+    [[nodiscard]] uint32_t id() override;
+
+    void next() override;
+
+    void skip_to(uint32_t id) override;
+
+    void reset() override;
+
+    bool contains(uint32_t id) override;
+
+    [[nodiscard]] size_t estimate() const override;
+};
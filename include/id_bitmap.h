@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+    Roaring style bitmap of document IDs.
+
+    The 32-bit ID space is split into chunks of 2^16 IDs keyed by the upper 16 bits of the ID. Each chunk is stored
+    either as a sorted array of the lower 16 bits (sparse chunks) or as a fixed 2^16 bit set (dense chunks), so that
+    AND/OR/ANDNOT operations can be done chunk-wise without decoding the IDs.
+*/
+class id_bitmap_t {
+public:
+    // a chunk with more than these many IDs is stored as a bit set (same cut-off as roaring bitmaps)
+    static constexpr size_t ARRAY_CONTAINER_MAX_SIZE = 4096;
+    static constexpr size_t BITSET_NUM_WORDS = (1 << 16) / 64;
+
+    struct container_t {
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+
+        // exactly one of these is populated
+        std::vector<uint16_t> array;
+        std::vector<uint64_t> bits;
+
+        bool is_bitset() const {
+            return !bits.empty();
+        }
+
+        bool contains(uint16_t low) const;
+
+        bool add(uint16_t low);
+
+        bool remove(uint16_t low);
+
+        // converts between array and bit set forms based on the cardinality
+        void optimize();
+
+        void to_bitset();
+
+        void to_array();
+
+        void or_with(const container_t& other);
+
+        void and_with(const container_t& other);
+
+        void and_not(const container_t& other);
+    };
+
+    // Iterates the IDs of a bitmap in ascending order without decoding them: the bitmap must not be modified
+    // while it's being iterated.
+    class iterator_t {
+    private:
+        const std::vector<container_t>* containers;
+        size_t container_index = 0;
+
+        // index into the array of an array container, or bit position within a bit set container
+        uint32_t position = 0;
+
+        // moves to the first ID of the current or a later container whose lower 16 bits are >= `low`
+        void seek(uint32_t low);
+
+    public:
+        explicit iterator_t(const std::vector<container_t>* containers);
+
+        [[nodiscard]] bool valid() const;
+
+        [[nodiscard]] uint32_t id() const;
+
+        void next();
+
+        // moves to the first ID that is >= `id`
+        void skip_to(uint32_t id);
+    };
+
+private:
+
+    // ordered by `key`
+    std::vector<container_t> containers;
+
+    size_t container_index(uint16_t key) const;
+
+public:
+
+    id_bitmap_t() = default;
+
+    id_bitmap_t(const uint32_t* ids, size_t num_ids);
+
+    void add(uint32_t id);
+
+    // `ids` must be sorted
+    void add_many(const uint32_t* ids, size_t num_ids);
+
+    void remove(uint32_t id);
+
+    bool contains(uint32_t id) const;
+
+    bool empty() const;
+
+    uint32_t cardinality() const;
+
+    // returns 0 when the bitmap is empty
+    uint32_t first_id() const;
+
+    // returns UINT32_MAX when the bitmap is empty
+    uint32_t last_id() const;
+
+    size_t num_containers() const;
+
+    // approximate number of bytes used by the bitmap
+    size_t memory_used() const;
+
+    void or_with(const id_bitmap_t& other);
+
+    void and_with(const id_bitmap_t& other);
+
+    void and_not(const id_bitmap_t& other);
+
+    bool contains_atleast_one(const uint32_t* target_ids, size_t target_ids_size) const;
+
+    // sorted IDs of the bitmap
+    void to_vector(std::vector<uint32_t>& ids) const;
+
+    // returns a sorted array of `cardinality()` elements which must be freed with `delete []`
+    uint32_t* uncompress() const;
+
+    void clear();
+
+    [[nodiscard]] iterator_t new_iterator() const;
+};
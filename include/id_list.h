@@ -122,6 +122,8 @@ public:
 
     uint32_t first_id();
 
+    uint32_t last_id();
+
     block_t* block_of(uint32_t id);
 
     bool contains(uint32_t id);
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <vector>
 #include "id_list.h"
+#include "id_bitmap.h"
 #include "threadpool.h"
 
 #define IS_COMPACT_IDS(x) (((uintptr_t)(x) & 1))
@@ -10,6 +11,10 @@
 #define RAW_IDS_PTR(x) ((void*)((uintptr_t)(x) & ~1))
 #define COMPACT_IDS_PTR(x) ((compact_id_list_t*)((uintptr_t)(x) & ~1))
 
+#define IS_BITMAP_IDS(x) (((uintptr_t)(x) & 2))
+#define SET_BITMAP_IDS(x) ((void*)((uintptr_t)(x) | 2))
+#define BITMAP_IDS_PTR(x) ((id_bitmap_t*)((uintptr_t)(x) & ~2))
+
 struct compact_id_list_t {
     // structured to get 4 byte alignment for `ids`
     uint8_t length = 0;
@@ -41,6 +46,7 @@ struct compact_id_list_t {
 class ids_t {
 private:
 
+    // bitmaps are expanded too, since the block intersection needs an `id_list_t` for every list
     static void to_expanded_id_lists(const std::vector<void*>& raw_id_lists, std::vector<id_list_t*>& id_lists,
                                      std::vector<id_list_t*>& expanded_id_lists);
 
@@ -48,6 +54,12 @@ public:
     static constexpr size_t COMPACT_LIST_THRESHOLD_LENGTH = 64;
     static constexpr size_t MAX_BLOCK_ELEMENTS = 256;
 
+    // A full list with at least these many IDs is converted into a bitmap when it is dense enough, i.e. when at
+    // least 1 out of every `BITMAP_DENSITY_RATIO` IDs within its [first, last] range is present.
+    // The bitmap is converted back into a full list when its size drops below half the threshold.
+    static constexpr size_t BITMAP_THRESHOLD_LENGTH = 8192;
+    static constexpr size_t BITMAP_DENSITY_RATIO = 16;
+
     struct block_intersector_t {
         std::vector<id_list_t*> id_lists;
         std::vector<id_list_t*> expanded_id_lists;
@@ -102,6 +114,15 @@ public:
     static void intersect(const std::vector<void*>& id_lists, std::vector<uint32_t>& result_ids);
 
     static uint32_t* uncompress(void*& obj);
+
+    // adds all IDs of `obj` to the given bitmap
+    static void merge(const void* obj, id_bitmap_t& bitmap);
+
+    // adds all IDs of the lists to the given bitmap: IDs of lists that aren't bitmaps are sorted and added at once,
+    // since adding the lists one by one merges the same array containers again and again
+    static void merge(const std::vector<void*>& id_lists, id_bitmap_t& bitmap);
+
+    static bool is_dense(size_t num_ids, uint32_t first_id, uint32_t last_id);
 };
 
 template<class T>
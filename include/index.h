@@ -6,6 +6,7 @@
 #include <mutex>
 #include <shared_mutex>
 #include <condition_variable>
+#include <chrono>
 #include <art.h>
 #include <number.h>
 #include <sparsepp.h>
@@ -17,22 +18,25 @@
 #include <set>
 #include "string_utils.h"
 #include "num_tree.h"
+#include "sort_values.h"
+#include "facet_index.h"
+#include "filter_iterator.h"
 #include "magic_enum.hpp"
 #include "match_score.h"
 #include "posting_list.h"
 #include "threadpool.h"
 #include "adi_tree.h"
-#include "tsl/htrie_set.h"
+#include "infix_index.h"
 #include <tsl/htrie_map.h>
 #include "id_list.h"
 #include "synonym_index.h"
+#include "lru/lru.hpp"
 
-static constexpr size_t ARRAY_FACET_DIM = 4;
-using facet_map_t = spp::sparse_hash_map<uint32_t, facet_hash_values_t>;
-using array_mapped_facet_t = std::array<facet_map_t*, ARRAY_FACET_DIM>;
+class S2Region;
 
-static constexpr size_t ARRAY_INFIX_DIM = 4;
-using array_mapped_infix_t = std::vector<tsl::htrie_set<char>*>;
+// infix searches that verify more candidate tokens than this are split across the thread pool
+static constexpr size_t INFIX_PARALLEL_CANDIDATES = 1 << 14;
+static constexpr size_t INFIX_SEARCH_CONCURRENCY = 4;
 
 struct token_t {
     size_t position;
@@ -72,6 +76,102 @@ struct search_field_t {
     size_t weight;
 };
 
+using presorted_ids_t = std::set<std::pair<int64_t, uint32_t>>;
+
+// IDs matching a filter clause, along with the write epochs they were computed at
+struct cached_filter_result_t {
+    std::shared_ptr<const id_bitmap_t> ids;
+    uint64_t field_epoch = 0;
+    uint64_t docs_epoch = 0;
+};
+
+// Facet counts of a filter-only (wildcard) query, along with the write epoch of the index they were computed at
+struct cached_facet_result_t {
+    spp::sparse_hash_map<uint64_t, facet_count_t> result_map;
+    facet_stats_t stats;
+    std::vector<uint32_t> range_counts;
+    uint64_t write_epoch = 0;
+};
+
+// (token, typo cost, prefix) => candidate leaves of the token
+using token_leaves_t = spp::sparse_hash_map<std::string, std::vector<art_leaf*>>;
+
+// State of the previous query of a type-ahead session, which the session's next keystroke can reuse as long as
+// nothing was written to the index in between
+struct typeahead_session_t {
+    uint64_t write_epoch = 0;
+    std::chrono::steady_clock::time_point expires_at;
+
+    // filter clauses of the query, which the candidates depend on
+    std::string filter_key;
+
+    // search fields, typo and prefix settings, filter and phrases => candidates of the query's tokens
+    std::string candidates_key;
+    token_leaves_t token_leaves;
+};
+
+// Leaves of a field's tree within a typo cost of a token, along with the dictionary epoch of the field they were
+// collected at. They are unranked and unfiltered, since ranks and filters change without tokens being added or removed.
+struct fuzzy_candidates_t {
+    uint64_t dictionary_epoch = 0;
+    std::vector<art_leaf*> leaves;
+};
+
+// Group ids of documents for a combination of group_by fields, keyed by seq_id
+struct group_id_column_t {
+    std::vector<std::string> group_by_fields;
+    sort_values_t group_ids;
+};
+
+struct filter_cache_stats_t {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t num_entries = 0;
+    size_t memory_used_bytes = 0;
+};
+
+struct fuzzy_cache_stats_t {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t num_entries = 0;
+    size_t memory_used_bytes = 0;
+};
+
+// Smallest and largest sort value seen in every block of `BLOCK_SIZE` consecutive seq_ids.
+// Bounds are only widened (never shrunk on update or delete), so they always remain valid.
+struct seq_id_block_bounds_t {
+    static constexpr size_t BLOCK_SIZE = 256;
+
+    std::vector<int64_t> mins;
+    std::vector<int64_t> maxs;
+
+    void update(const uint32_t seq_id, const int64_t value) {
+        const size_t block_id = seq_id / BLOCK_SIZE;
+
+        if(block_id >= maxs.size()) {
+            mins.resize(block_id + 1, INT64_MAX);
+            maxs.resize(block_id + 1, INT64_MIN);
+        }
+
+        mins[block_id] = std::min(mins[block_id], value);
+        maxs[block_id] = std::max(maxs[block_id], value);
+    }
+
+    // a block without any values returns an empty (min > max) range
+    void get(const uint32_t seq_id, int64_t& min, int64_t& max) const {
+        const size_t block_id = seq_id / BLOCK_SIZE;
+
+        if(block_id >= maxs.size()) {
+            min = INT64_MAX;
+            max = INT64_MIN;
+            return;
+        }
+
+        min = mins[block_id];
+        max = maxs[block_id];
+    }
+};
+
 struct query_tokens_t {
     std::vector<token_t> q_include_tokens;
     std::vector<std::vector<std::string>> q_exclude_tokens;
@@ -299,6 +399,20 @@ enum infix_t {
     off
 };
 
+// How a filter clause is evaluated: the most selective clause is iterated, while the others either verify its IDs
+// or are materialized once checking IDs against them gets costlier than computing their matches.
+enum class filter_strategy_t {
+    scan,
+    verify,
+    materialize
+};
+
+struct filter_clause_plan_t {
+    std::string field_name;
+    size_t estimated_ids;
+    filter_strategy_t strategy;
+};
+
 struct search_args {
     std::vector<query_tokens_t> field_query_tokens;
     std::vector<search_field_t> search_fields;
@@ -334,6 +448,9 @@ struct search_args {
     const size_t facet_query_num_typos;
     const bool filter_curated_hits;
     const bool split_join_tokens;
+    const size_t facet_sample_percent;
+    const size_t facet_sample_threshold;
+    const std::string typeahead_session;
     tsl::htrie_map<char, token_leaf> qtoken_set;
 
     spp::sparse_hash_set<uint64_t> groups_processed;
@@ -343,6 +460,10 @@ struct search_args {
     std::vector<std::vector<KV*>> raw_result_kvs;
     std::vector<std::vector<KV*>> override_result_kvs;
 
+    // order and evaluation strategy of the filter clauses, only recorded for `explain_filter`
+    const bool explain_filter;
+    std::vector<filter_clause_plan_t> filter_plan;
+
     search_args(std::vector<query_tokens_t> field_query_tokens, std::vector<search_field_t> search_fields,
                 std::vector<filter> filters, std::vector<facet>& facets,
                 std::vector<std::pair<uint32_t, uint32_t>>& included_ids, std::vector<uint32_t> excluded_ids,
@@ -354,7 +475,9 @@ struct search_args {
                 size_t concurrency, const std::vector<const override_t*>& dynamic_overrides, size_t search_cutoff_ms,
                 size_t min_len_1typo, size_t min_len_2typo, size_t max_candidates, const std::vector<infix_t>& infixes,
                 const size_t max_extra_prefix, const size_t max_extra_suffix, const size_t facet_query_num_typos,
-                const bool filter_curated_hits, const bool split_join_tokens) :
+                const bool filter_curated_hits, const bool split_join_tokens, const size_t facet_sample_percent,
+                const size_t facet_sample_threshold, const std::string& typeahead_session,
+                const bool explain_filter) :
             field_query_tokens(field_query_tokens),
             search_fields(search_fields), filters(filters), facets(facets),
             included_ids(included_ids), excluded_ids(excluded_ids), sort_fields_std(sort_fields_std),
@@ -368,7 +491,9 @@ struct search_args {
             min_len_1typo(min_len_1typo), min_len_2typo(min_len_2typo), max_candidates(max_candidates),
             infixes(infixes), max_extra_prefix(max_extra_prefix), max_extra_suffix(max_extra_suffix),
             facet_query_num_typos(facet_query_num_typos), filter_curated_hits(filter_curated_hits),
-            split_join_tokens(split_join_tokens) {
+            split_join_tokens(split_join_tokens), facet_sample_percent(facet_sample_percent),
+            facet_sample_threshold(facet_sample_threshold), typeahead_session(typeahead_session),
+            explain_filter(explain_filter) {
 
         const size_t topster_size = std::max((size_t)1, max_hits);  // needs to be atleast 1 since scoring is mandatory
         topster = new Topster(topster_size, group_limit);
@@ -399,6 +524,9 @@ enum class DIRTY_VALUES {
 struct offsets_facet_hashes_t {
     std::unordered_map<std::string, std::vector<uint32_t>> offsets;
     std::vector<uint64_t> facet_hashes;
+
+    // indexed text of each facet value, aligned with `facet_hashes`
+    std::vector<std::string> facet_values;
 };
 
 struct index_record {
@@ -468,21 +596,97 @@ private:
     // geo_array_field => (seq_id => values) used for exact filtering of geo array records
     spp::sparse_hash_map<std::string, spp::sparse_hash_map<uint32_t, int64_t*>*> geo_array_index;
 
-    // facet_field => (seq_id => values)
-    spp::sparse_hash_map<std::string, array_mapped_facet_t> facet_index_v3;
+    // facet_field => (seq_id => value ordinals)
+    spp::sparse_hash_map<std::string, facet_index_t*> facet_index_v4;
+
+    // facets are counted by ordinal when the field has at most these many distinct values per result to count
+    static constexpr size_t FACET_ORDINALS_PER_RESULT = 4;
+
+    // Relative costs used to pick how range facets are counted: looking up the value of each result in the sort
+    // index, vs. adding an id to a bitmap when the ids of each range in the numerical index are intersected with
+    // the results. Ranges spanning more than `RANGE_FACET_MAX_TREE_VALUES` distinct values are always looked up.
+    static constexpr size_t RANGE_FACET_LOOKUP_COST = 4;
+    static constexpr size_t RANGE_FACET_MAX_TREE_VALUES = 4096;
 
     // sort_field => (seq_id => value)
-    spp::sparse_hash_map<std::string, spp::sparse_hash_map<uint32_t, int64_t>*> sort_index;
+    spp::sparse_hash_map<std::string, sort_values_t*> sort_index;
+
+    // sort_field => (seq_id block => min/max value) used for skipping candidates that can't make it to the topster
+    spp::sparse_hash_map<std::string, seq_id_block_bounds_t*> sort_block_bounds;
+
+    // presorted sort_field => (value, seq_id) pairs in ascending order, walked by wildcard queries sorted on the field
+    spp::sparse_hash_map<std::string, presorted_ids_t*> presorted_index;
 
     // str_sort_field => adi_tree_t
     spp::sparse_hash_map<std::string, adi_tree_t*> str_sort_index;
 
-    // infix field => value
-    spp::sparse_hash_map<std::string, array_mapped_infix_t> infix_index;
+    // infix field => tokens and their trigrams
+    spp::sparse_hash_map<std::string, infix_index_t*> infix_index;
 
     // this is used for wildcard queries
     id_list_t* seq_ids;
 
+    static constexpr size_t FILTER_RESULT_CACHE_CAPACITY = 256;
+
+    // normalized filter clause => matching IDs
+    mutable LRU::Cache<std::string, cached_filter_result_t> filter_result_cache;
+
+    // field => number of writes to the field's index, used to invalidate cached filter results
+    // (the `id` field counts additions and removals of documents)
+    spp::sparse_hash_map<std::string, uint64_t> field_write_epochs;
+
+    // number of writes to any field of the index, used to invalidate cached facet counts
+    uint64_t write_epoch = 0;
+
+    static constexpr size_t FACET_RESULT_CACHE_CAPACITY = 256;
+
+    // facets with more distinct values than this in the results are not cached
+    static constexpr size_t FACET_RESULT_CACHE_MAX_VALUES = 10000;
+
+    // filter clauses + facet field => facet counts of wildcard queries
+    mutable LRU::Cache<std::string, std::shared_ptr<const cached_facet_result_t>> facet_result_cache;
+
+    static constexpr size_t GROUP_ID_COLUMN_CAPACITY = 8;
+
+    // group_by fields => group ids of all documents: built on first use and kept up to date on writes
+    mutable LRU::Cache<std::string, std::shared_ptr<group_id_column_t>> group_id_columns;
+    mutable std::mutex group_id_columns_mutex;
+
+    static constexpr size_t TYPEAHEAD_SESSION_CAPACITY = 1024;
+
+    // a session is forgotten when it's not continued within this time
+    static constexpr size_t TYPEAHEAD_SESSION_TTL_MS = 30 * 1000;
+
+    // session id => state of the session's last query
+    mutable LRU::Cache<std::string, std::shared_ptr<const typeahead_session_t>> typeahead_sessions;
+
+    // guards the caches and the type-ahead sessions along with the write epochs
+    mutable std::mutex filter_cache_mutex;
+    mutable size_t filter_cache_hits = 0;
+    mutable size_t filter_cache_misses = 0;
+
+    static constexpr size_t FUZZY_CACHE_NUM_SHARDS = 16;
+    static constexpr size_t FUZZY_CACHE_SHARD_CAPACITY = 256;
+
+    // tokens with more candidates than this, like prefixes of a character or two, are not cached
+    static constexpr size_t FUZZY_CACHE_MAX_LEAVES = 10000;
+
+    // A shard of the fuzzy candidate cache has its own lock, so that concurrent searches don't contend on one
+    struct fuzzy_cache_shard_t {
+        std::mutex mutex;
+        LRU::Cache<std::string, std::shared_ptr<const fuzzy_candidates_t>> candidates{FUZZY_CACHE_SHARD_CAPACITY};
+        size_t hits = 0;
+        size_t misses = 0;
+    };
+
+    // (field, token, typo cost, prefix) => candidate leaves, sharded on the hash of the key
+    mutable std::array<fuzzy_cache_shard_t, FUZZY_CACHE_NUM_SHARDS> fuzzy_cache_shards;
+
+    // field => number of times tokens were added to or removed from the field's tree: unlike the write epochs,
+    // this does not change when documents are merely added to or removed from the postings of existing tokens
+    spp::sparse_hash_map<std::string, uint64_t> field_dictionary_epochs;
+    mutable std::mutex dictionary_epochs_mutex;
+
     std::vector<char> symbols_to_index;
 
     std::vector<char> token_separators;
@@ -491,10 +695,10 @@ private:
 
     // used as sentinels
 
-    static spp::sparse_hash_map<uint32_t, int64_t> text_match_sentinel_value;
-    static spp::sparse_hash_map<uint32_t, int64_t> seq_id_sentinel_value;
-    static spp::sparse_hash_map<uint32_t, int64_t> geo_sentinel_value;
-    static spp::sparse_hash_map<uint32_t, int64_t> str_sentinel_value;
+    static sort_values_t text_match_sentinel_value;
+    static sort_values_t seq_id_sentinel_value;
+    static sort_values_t geo_sentinel_value;
+    static sort_values_t str_sentinel_value;
 
     // Internal utility functions
 
@@ -513,11 +717,17 @@ private:
 
     void log_leaves(int cost, const std::string &token, const std::vector<art_leaf *> &leaves) const;
 
+    // adds the number of results that fall into each range of a range facet to `a_facet.range_counts`
+    void compute_range_facet_counts(facet& a_facet, const uint32_t* result_ids, size_t results_size) const;
+
     void do_facets(std::vector<facet> & facets, facet_query_t & facet_query,
                    const std::vector<facet_info_t>& facet_infos,
                    size_t group_limit, const std::vector<std::string>& group_by_fields,
                    const uint32_t* result_ids, size_t results_size) const;
 
+    // folds the counts accumulated by ordinal into the `result_map` of each facet
+    void fold_ordinal_facet_counts(std::vector<facet>& facets) const;
+
     bool static_filter_query_eval(const override_t* override, std::vector<std::string>& tokens,
                                   std::vector<filter>& filters) const;
 
@@ -531,7 +741,10 @@ private:
                              std::set<std::string>& absorbed_tokens,
                              std::vector<std::string>& field_absorbed_tokens) const;
 
-    static void aggregate_topster(Topster* agg_topster, Topster* index_topster);
+    void compute_sort_score_bounds(const std::vector<sort_by>& sort_fields, const int* sort_order,
+                                   const std::array<sort_values_t*, 3>& field_values,
+                                   const std::array<const seq_id_block_bounds_t*, 3>& block_bounds,
+                                   uint32_t seq_id, int64_t text_match_score, int64_t* bounds) const;
 
     void search_field(const uint8_t & field_id,
                       const std::vector<token_t>& query_tokens,
@@ -564,7 +777,7 @@ private:
 
     void search_all_candidates(const size_t num_search_fields,
                                const std::vector<search_field_t>& the_fields,
-                               const uint32_t* filter_ids, size_t filter_ids_length,
+                               filter_iterator_t* filter_it,
                                const uint32_t* exclude_token_ids, size_t exclude_token_ids_size,
                                const std::vector<sort_by>& sort_fields,
                                std::vector<tok_candidates>& token_candidates_vec,
@@ -584,7 +797,7 @@ private:
                                const size_t max_candidates,
                                int syn_orig_num_tokens,
                                const int* sort_order,
-                               std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
+                               std::array<sort_values_t*, 3>& field_values,
                                const std::vector<size_t>& geopoint_indices,
                                std::set<uint64>& query_hashes,
                                std::vector<uint32_t>& id_buff) const;
@@ -613,6 +826,87 @@ private:
     void do_filtering(uint32_t*& filter_ids, uint32_t& filter_ids_length, const std::vector<filter>& filters,
                       const bool enable_short_circuit) const;
 
+    // returns a lazily evaluated iterator over the IDs matching all the filter clauses
+    // when `filter_plan` is given, the order in which the clauses are evaluated is recorded into it
+    std::unique_ptr<filter_iterator_t> new_filter_iterator(const std::vector<filter>& filters,
+                                                           std::vector<filter_clause_plan_t>* filter_plan = nullptr) const;
+
+    // returns a lazily evaluated iterator over the IDs matching a filter clause (nullptr if field isn't indexed)
+    std::unique_ptr<filter_leaf_iterator_t> new_filter_iterator(const filter& a_filter) const;
+
+    // returns an iterator over a sorted array of IDs, which must outlive the iterator
+    static std::unique_ptr<filter_leaf_iterator_t> new_ids_filter_iterator(const uint32_t* ids, size_t ids_length);
+
+    void compute_filter_ids(const filter& a_filter, id_bitmap_t& result_bitmap) const;
+
+    void compute_string_filter_matches(const filter& a_filter, const field& f, id_bitmap_t& matched_ids) const;
+
+    // also collects the posting lists of the tokens of every value that can be matched
+    size_t estimate_string_filter_ids(const filter& a_filter, const field& f,
+                                      std::vector<std::vector<void*>>& value_posting_lists) const;
+
+    size_t estimate_numeric_filter_ids(const filter& a_filter, const field& f) const;
+
+    // number of IDs found in the geo cells that cover the regions (a superset of the matching IDs)
+    size_t estimate_geo_filter_ids(const std::string& field_name,
+                                   const std::vector<std::unique_ptr<S2Region>>& regions) const;
+
+    // returns nullptr when the polygon in the filter value is not valid
+    static S2Region* new_geo_filter_region(const std::string& filter_value);
+
+    static bool compare_filter_value(NUM_COMPARATOR comparator, int64_t doc_value, int64_t value);
+
+    // clauses that differ only in the order of their values share the same key
+    static std::string get_filter_cache_key(const filter& a_filter);
+
+    // returns nullptr when the result is not cached or stale, along with the current epochs to cache a result with
+    std::shared_ptr<const id_bitmap_t> get_cached_filter_ids(const std::string& cache_key, const filter& a_filter,
+                                                             uint64_t& field_epoch, uint64_t& docs_epoch) const;
+
+    void cache_filter_ids(const std::string& cache_key, uint64_t field_epoch, uint64_t docs_epoch,
+                          const id_bitmap_t& ids) const;
+
+    // returns nullptr when the counts are not cached or stale, along with the current epoch to cache counts with
+    std::shared_ptr<const cached_facet_result_t> get_cached_facet_result(const std::string& cache_key,
+                                                                         uint64_t& epoch) const;
+
+    void cache_facet_result(const std::string& cache_key, uint64_t epoch, const facet& a_facet) const;
+
+    void bump_write_epoch(const std::string& field_name);
+
+    void bump_dictionary_epoch(const std::string& field_name);
+
+    uint64_t get_dictionary_epoch(const std::string& field_name) const;
+
+    // Same as `art_fuzzy_search` on the field's tree, but with the candidates of the token served from the cache
+    void fuzzy_search_field(const std::string& field_name, const std::string& token, const int cost,
+                            const bool prefix_search, const token_ordering token_order,
+                            filter_iterator_t* filter_it,
+                            const std::set<std::string>& exclude_tokens, std::vector<art_leaf*>& leaves) const;
+
+    // returns nullptr when the session is unknown, expired or stale, along with the current epoch to save it with
+    std::shared_ptr<const typeahead_session_t> get_typeahead_session(const std::string& session_id,
+                                                                     uint64_t& epoch) const;
+
+    void save_typeahead_session(const std::string& session_id, std::shared_ptr<typeahead_session_t> session) const;
+
+    // key of the filter clauses regardless of their order
+    static std::string get_filters_cache_key(const std::vector<filter>& filters);
+
+    // Narrows down the candidates of a prefix token without typos from those of a shorter prefix in the session.
+    // Returns false when no shorter prefix was searched or when it did not find every matching token.
+    static bool narrow_typeahead_leaves(const token_leaves_t& session_leaves, const std::string& token,
+                                        const std::set<std::string>& exclude_tokens,
+                                        std::vector<art_leaf*>& leaves);
+
+    // returns the group id column of the fields, building it when it's not present
+    std::shared_ptr<const group_id_column_t> get_group_id_column(const std::vector<std::string>& group_by_fields) const;
+
+    // recomputes the group ids of the indexed records in every group id column
+    void update_group_ids(const std::vector<index_record>& records);
+
+    void erase_group_ids(uint32_t seq_id);
+
     void insert_doc(const int64_t score, art_tree *t, uint32_t seq_id,
                     const std::unordered_map<std::string, std::vector<uint32_t>> &token_to_offsets) const;
 
@@ -620,14 +914,16 @@ private:
                                             const std::vector<char>& symbols_to_index,
                                             const std::vector<char>& token_separators,
                                             std::unordered_map<std::string, std::vector<uint32_t>>& token_to_offsets,
-                                            std::vector<uint64_t>& facet_hashes);
+                                            std::vector<uint64_t>& facet_hashes,
+                                            std::vector<std::string>& facet_values);
 
     static void tokenize_string_array_with_facets(const std::vector<std::string>& strings, bool is_facet,
                                            const field& a_field,
                                            const std::vector<char>& symbols_to_index,
                                            const std::vector<char>& token_separators,
                                            std::unordered_map<std::string, std::vector<uint32_t>>& token_to_offsets,
-                                           std::vector<uint64_t>& facet_hashes);
+                                           std::vector<uint64_t>& facet_hashes,
+                                           std::vector<std::string>& facet_values);
 
     void collate_included_ids(const std::vector<token_t>& q_included_tokens,
                               const std::map<size_t, std::map<size_t, uint32_t>> & included_ids_map,
@@ -680,6 +976,9 @@ public:
     enum {COMBINATION_MIN_LIMIT = 10};
     enum {MAX_CANDIDATES_DEFAULT = 4};
 
+    // most candidates looked up for a query token across the fields, which is all of them in practice
+    enum {FUZZY_SEARCH_MAX_WORDS = 100000};
+
     // If the number of results found is less than this threshold, Typesense will attempt to drop the tokens
     // in the query that have the least individual hits one by one until enough results are found.
     static const int DROP_TOKENS_THRESHOLD = 1;
@@ -699,6 +998,9 @@ public:
 
     static void concat_topster_ids(Topster* topster, spp::sparse_hash_map<uint64_t, std::vector<KV*>>& topster_ids);
 
+    // merges the KVs of `index_topster` into `agg_topster`: the KVs of a non-distinct `index_topster` are sorted
+    static void aggregate_topster(Topster* agg_topster, Topster* index_topster);
+
     int64_t score_results2(const std::vector<sort_by> & sort_fields, const uint16_t & query_index,
                            const size_t field_id, const bool field_is_array, const uint32_t total_cost,
                            int64_t& match_score,
@@ -714,7 +1016,7 @@ public:
                        Topster *topster, const std::vector<art_leaf *> &query_suggestion,
                        spp::sparse_hash_set<uint64_t> &groups_processed,
                        const uint32_t seq_id, const int sort_order[3],
-                       std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3> field_values,
+                       std::array<sort_values_t*, 3> field_values,
                        const std::vector<size_t>& geopoint_indices,
                        const size_t group_limit,
                        const std::vector<std::string> &group_by_fields, uint32_t token_bits,
@@ -729,15 +1031,21 @@ public:
 
     const spp::sparse_hash_map<std::string, num_tree_t*>& _get_numerical_index() const;
 
-    const spp::sparse_hash_map<std::string, array_mapped_infix_t>& _get_infix_index() const;
+    const spp::sparse_hash_map<std::string, infix_index_t*>& _get_infix_index() const;
 
     static int get_bounded_typo_cost(const size_t max_cost, const size_t token_len,
                                      size_t min_len_1typo, size_t min_len_2typo);
 
     static int64_t float_to_in64_t(float n);
 
+    // facet counts of a wildcard query depend only on its filter clauses, regardless of their order
+    static std::string get_facet_cache_key(const std::vector<filter>& filters, const facet& a_facet);
+
     uint64_t get_distinct_id(const std::vector<std::string>& group_by_fields, const uint32_t seq_id) const;
 
+    // group id of `seq_id` from a group id column: computed when the document is not in the column
+    uint64_t get_distinct_id(const group_id_column_t& group_id_column, uint32_t seq_id) const;
+
     static void compute_token_offsets_facets(index_record& record,
                                              const std::unordered_map<std::string, field>& search_schema,
                                              const std::vector<char>& local_token_separators,
@@ -774,7 +1082,9 @@ public:
                 size_t concurrency, size_t search_cutoff_ms, size_t min_len_1typo, size_t min_len_2typo,
                 size_t max_candidates, const std::vector<infix_t>& infixes, const size_t max_extra_prefix,
                 const size_t max_extra_suffix, const size_t facet_query_num_typos,
-                const bool filter_curated_hits, bool split_join_tokens) const;
+                const bool filter_curated_hits, bool split_join_tokens, const size_t facet_sample_percent,
+                const size_t facet_sample_threshold, std::vector<filter_clause_plan_t>* filter_plan,
+                const std::string& typeahead_session = "") const;
 
     void remove_field(uint32_t seq_id, const nlohmann::json& document, const std::string& field_name);
 
@@ -834,22 +1144,30 @@ public:
                          const std::vector<std::string>& group_by_fields, const std::set<uint32_t>& curated_ids,
                          const std::vector<uint32_t>& curated_ids_sorted, const uint32_t* exclude_token_ids,
                          size_t exclude_token_ids_size, const uint8_t field_id, const string& field,
-                         uint32_t*& all_result_ids, size_t& all_result_ids_len, const uint32_t* filter_ids,
-                         uint32_t filter_ids_length, const size_t concurrency,
+                         uint32_t*& all_result_ids, size_t& all_result_ids_len, filter_iterator_t* filter_it,
+                         const size_t concurrency,
                          const int* sort_order,
-                         std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
+                         std::array<sort_values_t*, 3>& field_values,
                          const std::vector<size_t>& geopoint_indices) const;
 
+    // Walks the presorted index of the sort field and scores only the documents that can make it to the topster.
+    // Returns false (without touching the topster) when the sort can't be served from a presorted index.
+    bool search_wildcard_presorted(const std::vector<sort_by>& sort_fields, Topster* topster,
+                                   std::vector<std::vector<art_leaf*>>& searched_queries, const size_t group_limit,
+                                   const uint32_t* filter_ids, uint32_t filter_ids_length, const int* sort_order,
+                                   std::array<sort_values_t*, 3>& field_values,
+                                   const std::vector<size_t>& geopoint_indices) const;
+
     void search_infix(const std::string& query, const std::string& field_name, std::vector<uint32_t>& ids,
                       size_t max_extra_prefix, size_t max_extra_suffix) const;
 
-    void curate_filtered_ids(const std::vector<filter>& filters, const std::set<uint32_t>& curated_ids,
-                             const uint32_t* exclude_token_ids, size_t exclude_token_ids_size, uint32_t*& filter_ids,
-                             uint32_t& filter_ids_length, const std::vector<uint32_t>& curated_ids_sorted) const;
+    // pulls the IDs passing the filter (all IDs when there is no filter) out of the iterator, less the excluded IDs
+    void curate_filtered_ids(filter_iterator_t* filter_it, const uint32_t* exclude_ids, size_t exclude_ids_size,
+                             std::vector<uint32_t>& filter_ids) const;
 
     void populate_sort_mapping(int* sort_order, std::vector<size_t>& geopoint_indices,
                                const std::vector<sort_by>& sort_fields_std,
-                               std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values) const;
+                               std::array<sort_values_t*, 3>& field_values) const;
 
     static void remove_matched_tokens(std::vector<std::string>& tokens, const std::set<std::string>& rule_token_set) ;
 
@@ -864,6 +1182,15 @@ public:
 
     size_t num_seq_ids() const;
 
+    // adds the stats of the filter result cache to `stats`
+    void get_filter_cache_stats(filter_cache_stats_t& stats) const;
+
+    void get_fuzzy_cache_stats(fuzzy_cache_stats_t& stats) const;
+
+    // indexed text of the facet values with the given hashes: values no longer present in any document are skipped
+    void get_facet_values(const std::string& field_name, const std::vector<uint64_t>& hashes,
+                          std::unordered_map<uint64_t, std::string>& values) const;
+
     void handle_exclusion(const size_t num_search_fields, std::vector<query_tokens_t>& field_query_tokens,
                           const std::vector<search_field_t>& search_fields, uint32_t*& exclude_token_ids,
                           size_t& exclude_token_ids_size) const;
@@ -874,9 +1201,9 @@ public:
                          std::vector<std::vector<art_leaf*>>& searched_queries, const size_t group_limit,
                          const std::vector<std::string>& group_by_fields, const size_t max_extra_prefix,
                          const size_t max_extra_suffix, const std::vector<token_t>& query_tokens, Topster* actual_topster,
-                         const uint32_t *filter_ids, size_t filter_ids_length,
+                         filter_iterator_t* filter_it,
                          const int sort_order[3],
-                         std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3> field_values,
+                         std::array<sort_values_t*, 3> field_values,
                          const std::vector<size_t>& geopoint_indices,
                          const std::vector<uint32_t>& curated_ids_sorted,
                          uint32_t*& all_result_ids, size_t& all_result_ids_len,
@@ -899,22 +1226,23 @@ public:
                            spp::sparse_hash_set<uint64_t>& groups_processed,
                            std::vector<std::vector<art_leaf*>>& searched_queries,
                            uint32_t*& all_result_ids, size_t& all_result_ids_len,
-                           const uint32_t* filter_ids, uint32_t filter_ids_length, 
+                           filter_iterator_t* filter_it,
                            std::set<uint64>& query_hashes,
                            const int* sort_order,
-                           std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
+                           std::array<sort_values_t*, 3>& field_values,
                            const std::vector<size_t>& geopoint_indices,
                            tsl::htrie_map<char, token_leaf>& qtoken_set) const;
 
+    // IDs matching the phrases in any of the fields are returned in an array that must be freed with `delete []`
     void do_phrase_search(const size_t num_search_fields, const std::vector<search_field_t>& search_fields,
                           std::vector<query_tokens_t>& field_query_tokens,
-                          uint32_t*& filter_ids, uint32_t& filter_ids_length) const;
+                          uint32_t*& phrase_match_ids, size_t& phrase_match_ids_size) const;
 
     void fuzzy_search_fields(const std::vector<search_field_t>& the_fields,
                              const std::vector<token_t>& query_tokens,
                              const uint32_t* exclude_token_ids,
                              size_t exclude_token_ids_size,
-                             const uint32_t* filter_ids, size_t filter_ids_length,
+                             filter_iterator_t* filter_it,
                              const std::vector<uint32_t>& curated_ids,
                              const std::vector<sort_by>& sort_fields,
                              const std::vector<uint32_t>& num_typos,
@@ -934,8 +1262,19 @@ public:
                              size_t min_len_2typo,
                              int syn_orig_num_tokens,
                              const int* sort_order,
-                             std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
-                             const std::vector<size_t>& geopoint_indices) const;
+                             std::array<sort_values_t*, 3>& field_values,
+                             const std::vector<size_t>& geopoint_indices,
+                             token_leaves_t* query_token_leaves = nullptr,
+                             const token_leaves_t* session_token_leaves = nullptr) const;
+
+    // Counts the documents containing the exact token in any of the fields, straight from the cardinalities of
+    // their posting lists. Ids are only materialized when `need_ids` is set or when the token is found in more than
+    // one field. Returns false, without any results, when the token can match other tokens (prefix or infix search)
+    // or when it does not match enough documents to stop at zero typos.
+    bool count_exact_token_matches(const std::vector<search_field_t>& the_fields, const size_t num_search_fields,
+                                   const token_t& token, const std::vector<bool>& prefixes,
+                                   const std::vector<infix_t>& infixes, const size_t typo_tokens_threshold,
+                                   const bool need_ids, uint32_t*& all_result_ids, size_t& all_result_ids_len) const;
 
     void find_across_fields(const std::vector<token_t>& query_tokens,
                               const size_t num_query_tokens,
@@ -943,7 +1282,7 @@ public:
                               const std::vector<bool>& prefixes,
                               const std::vector<search_field_t>& the_fields,
                               const size_t num_search_fields,
-                              const uint32_t* filter_ids, uint32_t filter_ids_length,
+                              filter_iterator_t* filter_it,
                               const uint32_t* exclude_token_ids,
                               size_t exclude_token_ids_size,
                               std::vector<uint32_t>& id_buff) const;
@@ -960,13 +1299,14 @@ public:
                               tsl::htrie_map<char, token_leaf>& qtoken_set,
                               const size_t group_limit,
                               const std::vector<std::string>& group_by_fields, bool prioritize_exact_match,
-                              const uint32_t* filter_ids, uint32_t filter_ids_length,
+                              const bool exhaustive_search,
+                              filter_iterator_t* filter_it,
                               const uint32_t total_cost,
                               const int syn_orig_num_tokens,
                               const uint32_t* exclude_token_ids,
                               size_t exclude_token_ids_size,
                               const int* sort_order,
-                              std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
+                              std::array<sort_values_t*, 3>& field_values,
                               const std::vector<size_t>& geopoint_indices,
                               std::vector<uint32_t>& id_buff,
                               uint32_t*& all_result_ids,
@@ -1000,7 +1340,7 @@ public:
                                   std::vector<filter>& filters) const;
 
     void compute_sort_scores(const std::vector<sort_by>& sort_fields, const int* sort_order,
-                             std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3> field_values,
+                             std::array<sort_values_t*, 3> field_values,
                              const std::vector<size_t>& geopoint_indices, uint32_t seq_id,
                              int64_t max_field_match_score,
                              int64_t* scores, int64_t& match_score_index) const;
@@ -1008,8 +1348,8 @@ public:
     void
     process_curated_ids(const std::vector<std::pair<uint32_t, uint32_t>>& included_ids,
                         const std::vector<uint32_t>& excluded_ids,
-                        const size_t group_limit, const bool filter_curated_hits, const uint32_t* filter_ids,
-                        uint32_t filter_ids_length, std::set<uint32_t>& curated_ids,
+                        const size_t group_limit, const bool filter_curated_hits, filter_iterator_t* filter_it,
+                        std::set<uint32_t>& curated_ids,
                         std::map<size_t, std::map<size_t, uint32_t>>& included_ids_map,
                         std::vector<uint32_t>& included_ids_vec) const;
 };
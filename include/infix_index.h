@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "sparsepp.h"
+#include "ids_t.h"
+#include "tsl/htrie_map.h"
+
+// Tokens of an infix field, along with an index from every trigram (3 consecutive bytes) of a token to the ids of
+// the tokens containing it, so that an infix search only has to verify the tokens sharing all the query's trigrams.
+class infix_index_t {
+private:
+    static constexpr size_t GRAM_LEN = 3;
+
+    tsl::htrie_map<char, uint32_t> token_ids;
+
+    // token id => token, the ids of erased tokens are left empty until they are reused
+    std::vector<std::string> tokens;
+    std::vector<uint32_t> free_token_ids;
+
+    // trigram => ids of the tokens containing it
+    spp::sparse_hash_map<uint32_t, void*> gram_token_ids;
+
+    static void get_grams(const std::string& token, std::vector<uint32_t>& grams);
+
+public:
+
+    ~infix_index_t();
+
+    void insert(const std::string& token);
+
+    void erase(const std::string& token);
+
+    // Finds the ids of the tokens that contain every trigram of the query. Returns false when the query is shorter
+    // than a trigram, in which case every token id below `num_token_ids()` is a candidate.
+    bool get_candidates(const std::string& query, std::vector<uint32_t>& candidate_ids) const;
+
+    // Token stored against the id, which is empty when the id is not in use
+    const std::string& get_token(uint32_t token_id) const;
+
+    size_t num_token_ids() const;
+
+    size_t num_grams() const;
+
+    size_t size() const;
+};
@@ -11,6 +11,9 @@ class num_tree_t {
 private:
     std::map<int64_t, void*> int64map;
 
+    // ORs the IDs of the `result` bitmap into the `ids` array
+    static void merge_into_array(const id_bitmap_t& result, uint32_t** ids, size_t& ids_len);
+
 public:
 
     ~num_tree_t();
@@ -19,11 +22,19 @@ public:
 
     void range_inclusive_search(int64_t start, int64_t end, uint32_t** ids, size_t& ids_len);
 
+    void range_inclusive_search(int64_t start, int64_t end, id_bitmap_t& result);
+
     size_t get(int64_t value, std::vector<uint32_t>& geo_result_ids);
 
     void search(NUM_COMPARATOR comparator, int64_t value, uint32_t** ids, size_t& ids_len);
 
+    void search(NUM_COMPARATOR comparator, int64_t value, id_bitmap_t& result);
+
     void remove(uint64_t value, uint32_t id);
 
+    // Number of IDs stored against values in [start, end]. Returns `SIZE_MAX` when more than `max_values`
+    // distinct values fall within the range, so that estimating a broad range stays cheap.
+    size_t count(int64_t start, int64_t end, size_t max_values);
+
     size_t size();
 };
\ No newline at end of file
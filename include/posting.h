@@ -37,6 +37,8 @@ struct compact_posting_list_t {
     [[nodiscard]] uint32_t num_ids() const;
 
     bool contains_atleast_one(const uint32_t* target_ids, size_t target_ids_size);
+
+    bool contains_atleast_one(filter_iterator_t* filter_it);
 };
 
 class posting_t {
@@ -96,6 +98,8 @@ public:
 
     static bool contains_atleast_one(const void* obj, const uint32_t* target_ids, size_t target_ids_size);
 
+    static bool contains_atleast_one(const void* obj, filter_iterator_t* filter_it);
+
     static void merge(const std::vector<void*>& posting_lists, std::vector<uint32_t>& result_ids);
 
     static void intersect(const std::vector<void*>& posting_lists, std::vector<uint32_t>& result_ids);
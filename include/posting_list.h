@@ -8,6 +8,8 @@
 
 typedef uint32_t last_id_t;
 
+class filter_iterator_t;
+
 struct result_iter_state_t {
     const uint32_t* excluded_result_ids = nullptr;
     const size_t excluded_result_ids_size = 0;
@@ -15,6 +17,9 @@ struct result_iter_state_t {
     const uint32_t* filter_ids = nullptr;
     const size_t filter_ids_length = 0;
 
+    // when given, IDs are checked against the filter instead of `filter_ids`
+    filter_iterator_t* filter_it = nullptr;
+
     size_t excluded_result_ids_index = 0;
     size_t filter_ids_index = 0;
     size_t index = 0;
@@ -25,6 +30,11 @@ struct result_iter_state_t {
                         const uint32_t* filter_ids, const size_t filter_ids_length) : excluded_result_ids(excluded_result_ids),
                                                                                       excluded_result_ids_size(excluded_result_ids_size),
                                                                                       filter_ids(filter_ids), filter_ids_length(filter_ids_length) {}
+
+    result_iter_state_t(const uint32_t* excluded_result_ids, size_t excluded_result_ids_size,
+                        filter_iterator_t* filter_it) : excluded_result_ids(excluded_result_ids),
+                                                        excluded_result_ids_size(excluded_result_ids_size),
+                                                        filter_it(filter_it) {}
 };
 
 /*
@@ -155,12 +165,18 @@ public:
 
     bool contains_atleast_one(const uint32_t* target_ids, size_t target_ids_size);
 
+    // Probes the IDs of the list against the filter when the list is the smaller one, otherwise skips through the
+    // list with the IDs of the filter (which moves the filter iterator).
+    bool contains_atleast_one(filter_iterator_t* filter_it);
+
     iterator_t new_iterator(block_t* start_block = nullptr, block_t* end_block = nullptr, uint32_t field_id = 0);
 
     static void merge(const std::vector<posting_list_t*>& posting_lists, std::vector<uint32_t>& result_ids);
 
     static void intersect(const std::vector<posting_list_t*>& posting_lists, std::vector<uint32_t>& result_ids);
 
+    static void block_intersect2(iterator_t& it1, iterator_t& it2, std::vector<uint32_t>& result_ids);
+
     template<class T>
     static bool block_intersect(
         std::vector<posting_list_t::iterator_t>& its,
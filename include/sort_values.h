@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "sparsepp.h"
+
+/*
+    Sort values of a field keyed by seq_id.
+
+    Values of sparse (mostly optional) fields are stored in a hash map. Since seq_ids are assigned sequentially,
+    values of fields that are present in most documents are stored in chunks of `CHUNK_SIZE` consecutive seq_ids
+    instead: each chunk is a flat array of values along with a bitmap of the seq_ids that have a value. This lets
+    a lookup be a couple of array accesses and keeps the values of neighbouring seq_ids close together in memory.
+
+    The representation is switched automatically based on the fraction of seq_ids that have a value.
+*/
+class sort_values_t {
+public:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    // the representation is only reconsidered when the number of values crosses a multiple of this
+    static constexpr size_t DENSITY_CHECK_INTERVAL = 1024;
+
+private:
+    struct chunk_t {
+        int64_t values[CHUNK_SIZE];
+        uint64_t present[CHUNK_SIZE / 64] = {};
+        size_t num_values = 0;
+    };
+
+    bool dense = false;
+    size_t num_values = 0;
+
+    // largest seq_id that was given a value + 1
+    size_t seq_id_span = 0;
+
+    spp::sparse_hash_map<uint32_t, int64_t> sparse_values;
+
+    // chunks without any values are not allocated
+    std::vector<chunk_t*> chunks;
+
+    void set_dense(uint32_t seq_id, int64_t value);
+
+    bool erase_dense(uint32_t seq_id);
+
+    void to_dense();
+
+    void to_sparse();
+
+    // called when the number of values crosses a multiple of `DENSITY_CHECK_INTERVAL`
+    void check_density();
+
+public:
+
+    sort_values_t() = default;
+
+    sort_values_t(const sort_values_t&) = delete;
+
+    sort_values_t& operator=(const sort_values_t&) = delete;
+
+    ~sort_values_t();
+
+    // inserts or overwrites the value of `seq_id`
+    void set(uint32_t seq_id, int64_t value);
+
+    void erase(uint32_t seq_id);
+
+    inline bool get(const uint32_t seq_id, int64_t& value) const {
+        if(dense) {
+            const size_t chunk_index = seq_id / CHUNK_SIZE;
+            if(chunk_index >= chunks.size() || chunks[chunk_index] == nullptr) {
+                return false;
+            }
+
+            const chunk_t* chunk = chunks[chunk_index];
+            const size_t offset = seq_id % CHUNK_SIZE;
+
+            if((chunk->present[offset / 64] & (1ULL << (offset % 64))) == 0) {
+                return false;
+            }
+
+            value = chunk->values[offset];
+            return true;
+        }
+
+        const auto it = sparse_values.find(seq_id);
+        if(it == sparse_values.end()) {
+            return false;
+        }
+
+        value = it->second;
+        return true;
+    }
+
+    inline bool contains(const uint32_t seq_id) const {
+        int64_t value;
+        return get(seq_id, value);
+    }
+
+    size_t size() const;
+
+    bool is_dense() const;
+};
@@ -158,6 +158,40 @@ public:
         return StoreStatus::ERROR;
     }
 
+    // Fetches the values of many keys in a single batched lookup, which lets RocksDB share the work of finding
+    // the keys and read the data blocks of different keys in parallel.
+    void multi_get(const std::vector<std::string>& keys, std::vector<std::string>& values,
+                   std::vector<StoreStatus>& statuses) const {
+        std::vector<rocksdb::Slice> key_slices(keys.begin(), keys.end());
+        std::vector<rocksdb::PinnableSlice> pinned_values(keys.size());
+        std::vector<rocksdb::Status> key_statuses(keys.size());
+
+        {
+            std::shared_lock lock(mutex);
+            db->MultiGet(rocksdb::ReadOptions(), db->DefaultColumnFamily(), keys.size(),
+                         key_slices.data(), pinned_values.data(), key_statuses.data());
+        }
+
+        values.resize(keys.size());
+        statuses.resize(keys.size());
+
+        for(size_t i = 0; i < keys.size(); i++) {
+            const rocksdb::Status& status = key_statuses[i];
+
+            if(status.ok()) {
+                values[i].assign(pinned_values[i].data(), pinned_values[i].size());
+                statuses[i] = StoreStatus::FOUND;
+            } else if(status.IsNotFound()) {
+                values[i].clear();
+                statuses[i] = StoreStatus::NOT_FOUND;
+            } else {
+                LOG(ERROR) << "Error while fetching the key: " << keys[i] << " - status is: " << status.ToString();
+                values[i].clear();
+                statuses[i] = StoreStatus::ERROR;
+            }
+        }
+    }
+
     bool remove(const std::string& key) {
         std::shared_lock lock(mutex);
         rocksdb::Status status = db->Delete(write_options, key);
@@ -69,6 +69,9 @@ struct StringUtils {
 
     static void split_to_values(const std::string& vals_str, std::vector<std::string>& filter_values);
 
+    // splits a comma separated list of facet fields, leaving commas within the parentheses of range facets intact
+    static void split_facet(const std::string& facet_str, std::vector<std::string>& facets);
+
     // Adapted from: http://stackoverflow.com/a/36000453/131050
     static std::string & trim(std::string & str) {
         // right trim
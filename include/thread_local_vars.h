@@ -1,4 +1,5 @@
 #include <chrono>
+#include <cstddef>
 
 extern thread_local int64_t write_log_index;
 
@@ -6,4 +7,6 @@ extern thread_local int64_t write_log_index;
 // NOTE: if you fork off main search thread, care must be taken to initialize these from parent thread values
 extern thread_local std::chrono::high_resolution_clock::time_point search_begin;
 extern thread_local int64_t search_stop_ms;
-extern thread_local bool search_cutoff;
\ No newline at end of file
+extern thread_local bool search_cutoff;
+// number of seq_id blocks whose candidates were not scored because they could not have made it to the topster
+extern thread_local size_t search_blocks_skipped;
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <cstdio>
 #include <algorithm>
 #include <unordered_map>
+#include "sparsepp.h"
 
 struct KV {
     uint8_t field_id{};
@@ -97,6 +98,10 @@ struct KV {
 
 /*
 * Remembers the max-K elements seen so far using a min-heap
+*
+* Keys of the elements in the heap are tracked in a flat open addressing table (linear probing) so that a duplicate
+* key can be found without allocating. Once the heap is full, the minimum element is kept as a threshold which
+* candidates are compared against before their key is looked up.
 */
 struct Topster {
     const uint32_t MAX_SIZE;
@@ -105,11 +110,157 @@ struct Topster {
     KV *data;
     KV** kvs;
 
-    std::unordered_map<uint64_t, KV*> kv_map;
-
     spp::sparse_hash_map<uint64_t, Topster*> group_kv_map;
     size_t distinct;
 
+private:
+    // key => KV in `data`: empty slots are null
+    KV** key_slots;
+    size_t key_slots_mask;
+
+    // copy of the minimum element of a full heap
+    int64_t min_scores[3] = {};
+    uint64_t min_key = 0;
+
+    static inline size_t hash_key(const uint64_t key) {
+        // fibonacci hashing spreads sequential keys (seq_ids) across the table
+        return size_t((key * 11400714819323198485ULL) >> 32);
+    }
+
+    inline KV** find_key_slot(const uint64_t key) const {
+        size_t slot = hash_key(key) & key_slots_mask;
+        while(key_slots[slot] != nullptr) {
+            if(key_slots[slot]->key == key) {
+                return &key_slots[slot];
+            }
+            slot = (slot + 1) & key_slots_mask;
+        }
+
+        return nullptr;
+    }
+
+    inline void insert_key(KV* kv) {
+        size_t slot = hash_key(kv->key) & key_slots_mask;
+        while(key_slots[slot] != nullptr) {
+            slot = (slot + 1) & key_slots_mask;
+        }
+
+        key_slots[slot] = kv;
+    }
+
+    inline void erase_key(const uint64_t key) {
+        KV** found_slot = find_key_slot(key);
+        if(found_slot == nullptr) {
+            return ;
+        }
+
+        // shift back the entries that follow in the same probe sequence, so that no tombstones are needed
+        size_t hole = found_slot - key_slots;
+        size_t slot = (hole + 1) & key_slots_mask;
+
+        while(key_slots[slot] != nullptr) {
+            const size_t home = hash_key(key_slots[slot]->key) & key_slots_mask;
+
+            // entry can fill the hole if its home slot is not cyclically within (hole, slot]
+            if(((slot - home) & key_slots_mask) >= ((slot - hole) & key_slots_mask)) {
+                key_slots[hole] = key_slots[slot];
+                hole = slot;
+            }
+
+            slot = (slot + 1) & key_slots_mask;
+        }
+
+        key_slots[hole] = nullptr;
+    }
+
+    // when set, only KVs ordered strictly after the cursor are admitted
+    bool has_cursor = false;
+    int64_t cursor_scores[3] = {};
+    uint64_t cursor_key = 0;
+
+    // a document can be scored more than once: once any of its KVs is at or before the cursor, it has already been
+    // paged through and none of its KVs are admitted
+    spp::sparse_hash_set<uint64_t> cursor_skipped_keys;
+
+    // whether a KV was ever turned away for lack of room
+    bool overflowed = false;
+
+    // whether a skipped key was taken out of the heap after it overflowed: a KV turned away earlier could then
+    // have belonged in the heap
+    bool cursor_lossy = false;
+
+    inline bool is_after_cursor(const KV* kv) const {
+        return std::tie(kv->scores[0], kv->scores[1], kv->scores[2], kv->key) <
+               std::tie(cursor_scores[0], cursor_scores[1], cursor_scores[2], cursor_key);
+    }
+
+    void sift_down(size_t heap_op_index) {
+        while ((2 * heap_op_index + 1) < size) {
+            uint32_t next = (2 * heap_op_index + 1);  // left child
+            if (next+1 < size && is_greater(kvs[next], kvs[next + 1])) {
+                // for min heap we compare with the minimum of children
+                next++;  // right child (2n + 2)
+            }
+
+            if (is_greater(kvs[heap_op_index], kvs[next])) {
+                swapMe(&kvs[heap_op_index], &kvs[next]);
+            } else {
+                break;
+            }
+
+            heap_op_index = next;
+        }
+    }
+
+    void sift_up(size_t heap_op_index) {
+        while(heap_op_index > 0) {
+            uint32_t parent = (heap_op_index - 1) / 2;
+            if (is_greater(kvs[parent], kvs[heap_op_index])) {
+                swapMe(&kvs[heap_op_index], &kvs[parent]);
+                heap_op_index = parent;
+            } else {
+                break;
+            }
+        }
+    }
+
+    // removes the KV of the key from the heap, if present
+    void remove(const uint64_t key) {
+        KV** found_slot = find_key_slot(key);
+        if(found_slot == nullptr) {
+            return ;
+        }
+
+        const size_t heap_op_index = (*found_slot)->array_index;
+        erase_key(key);
+        size--;
+        cursor_lossy = cursor_lossy || overflowed;
+
+        if(heap_op_index != size) {
+            // fill the hole with the last element, which could have to move either way
+            swapMe(&kvs[heap_op_index], &kvs[size]);
+            sift_down(heap_op_index);
+            sift_up(heap_op_index);
+        }
+    }
+
+    void skip_key(const uint64_t key) {
+        if(cursor_skipped_keys.insert(key).second) {
+            remove(key);
+        }
+    }
+
+    inline void update_threshold() {
+        if(size >= MAX_SIZE && size != 0) {
+            min_scores[0] = kvs[0]->scores[0];
+            min_scores[1] = kvs[0]->scores[1];
+            min_scores[2] = kvs[0]->scores[2];
+            min_key = kvs[0]->key;
+        }
+    }
+
+public:
+
     explicit Topster(size_t capacity): Topster(capacity, 0) {
     }
 
@@ -129,17 +280,33 @@ struct Topster {
             data[i].distinct_key = 0;
             kvs[i] = &data[i];
         }
+
+        // at most half full
+        size_t num_key_slots = 16;
+        while(num_key_slots < capacity * 2) {
+            num_key_slots *= 2;
+        }
+
+        key_slots = new KV*[num_key_slots]();
+        key_slots_mask = num_key_slots - 1;
     }
 
+    Topster(const Topster&) = delete;
+
+    Topster& operator=(const Topster&) = delete;
+
     ~Topster() {
         delete[] data;
         delete[] kvs;
+        delete[] key_slots;
+
         for(auto& kv: group_kv_map) {
             delete kv.second;
         }
 
         data = nullptr;
         kvs = nullptr;
+        key_slots = nullptr;
 
         group_kv_map.clear();
     }
@@ -154,20 +321,32 @@ struct Topster {
         (*b)->array_index = a_index;
     }
 
-    bool add(KV* kv) {
-        /*LOG(INFO) << "kv_map size: " << kv_map.size() << " -- kvs[0]: " << kvs[0]->scores[kvs[0]->match_score_index];
-        for(auto& mkv: kv_map) {
-            LOG(INFO) << "kv key: " << mkv.first << " => " << mkv.second->scores[mkv.second->match_score_index];
-        }*/
-
-        bool less_than_min_heap = (size >= MAX_SIZE) && is_smaller(kv, kvs[0]);
-        size_t heap_op_index = 0;
+    // whether the element can't make it into a full heap: checked without touching the heap or the key table
+    inline bool is_below_threshold(const KV* kv) const {
+        return size >= MAX_SIZE &&
+               std::tie(kv->scores[0], kv->scores[1], kv->scores[2], kv->key) <
+               std::tie(min_scores[0], min_scores[1], min_scores[2], min_key);
+    }
 
-        if(!distinct && less_than_min_heap) {
+    bool add(KV* kv) {
+        if(!distinct && is_below_threshold(kv)) {
             // for non-distinct, if incoming value is smaller than min-heap ignore
+            overflowed = true;
             return false;
         }
 
+        if(has_cursor) {
+            if(!is_after_cursor(kv)) {
+                skip_key(kv->key);
+                return false;
+            }
+
+            if(cursor_skipped_keys.count(kv->key) != 0) {
+                return false;
+            }
+        }
+
+        size_t heap_op_index = 0;
         bool SIFT_DOWN = true;
 
         if(distinct) {
@@ -184,10 +363,7 @@ struct Topster {
             return true;
 
         } else { // not distinct
-            //LOG(INFO) << "Searching for key: " << kv->key;
-
-            const auto& found_it = kv_map.find(kv->key);
-            bool is_duplicate_key = (found_it != kv_map.end());
+            KV** found_slot = find_key_slot(kv->key);
 
             /*
                is_duplicate_key: SIFT_DOWN regardless of `size`.
@@ -196,21 +372,18 @@ struct Topster {
                    Else SIFT_DOWN
             */
 
-            if(is_duplicate_key) {
+            if(found_slot != nullptr) {
                 // Need to check if kv is greater than existing duplicate kv.
-                KV* existing_kv = found_it->second;
-                //LOG(INFO) << "existing_kv: " << existing_kv->key << " -> " << existing_kv->match_score;
+                KV* existing_kv = *found_slot;
 
                 bool smaller_than_existing = is_smaller(kv, existing_kv);
                 if(smaller_than_existing) {
                     return false;
                 }
 
+                // replace existing kv and sift down: the key continues to point to the same KV
                 SIFT_DOWN = true;
-
-                // replace existing kv and sift down
                 heap_op_index = existing_kv->array_index;
-                kv_map.erase(kvs[heap_op_index]->key);
             } else {  // not duplicate
 
                 if(size < MAX_SIZE) {
@@ -223,12 +396,14 @@ struct Topster {
                     // we have to replace min heap element since array is full
                     SIFT_DOWN = true;
                     heap_op_index = 0;
-                    kv_map.erase(kvs[heap_op_index]->key);
+                    erase_key(kvs[heap_op_index]->key);
+                    overflowed = true;
                 }
-            }
 
-            // kv will be copied into the pointer at heap_op_index
-            kv_map.emplace(kv->key, kvs[heap_op_index]);
+                // kv will be copied into the pointer at heap_op_index
+                kvs[heap_op_index]->key = kv->key;
+                insert_key(kvs[heap_op_index]);
+            }
         }
 
         // we have to replace the existing element in the heap and sift down
@@ -238,37 +413,54 @@ struct Topster {
         // sift up/down to maintain heap property
 
         if(SIFT_DOWN) {
-            while ((2 * heap_op_index + 1) < size) {
-                uint32_t next = (2 * heap_op_index + 1);  // left child
-                if (next+1 < size && is_greater(kvs[next], kvs[next + 1])) {
-                    // for min heap we compare with the minimum of children
-                    next++;  // right child (2n + 2)
-                }
-
-                if (is_greater(kvs[heap_op_index], kvs[next])) {
-                    swapMe(&kvs[heap_op_index], &kvs[next]);
-                } else {
-                    break;
-                }
-
-                heap_op_index = next;
-            }
+            sift_down(heap_op_index);
         } else {
-            // SIFT UP
-            while(heap_op_index > 0) {
-                uint32_t parent = (heap_op_index - 1) / 2;
-                if (is_greater(kvs[parent], kvs[heap_op_index])) {
-                    swapMe(&kvs[heap_op_index], &kvs[parent]);
-                    heap_op_index = parent;
-                } else {
-                    break;
-                }
-            }
+            sift_up(heap_op_index);
         }
 
+        update_threshold();
         return true;
     }
 
+    // Only KVs ordered strictly after the given scores and key are admitted from here on. Used for paging with a
+    // cursor: the heap then holds a single page however deep the page is.
+    void set_cursor(const int64_t* scores, const uint64_t key) {
+        has_cursor = true;
+        cursor_scores[0] = scores[0];
+        cursor_scores[1] = scores[1];
+        cursor_scores[2] = scores[2];
+        cursor_key = key;
+    }
+
+    void copy_cursor(const Topster& topster) {
+        if(topster.has_cursor) {
+            set_cursor(topster.cursor_scores, topster.cursor_key);
+        }
+    }
+
+    bool is_cursor_set() const {
+        return has_cursor;
+    }
+
+    // keys skipped by another topster with the same cursor are dropped from this one too
+    void skip_keys(const Topster& topster) {
+        for(const uint64_t key: topster.cursor_skipped_keys) {
+            skip_key(key);
+        }
+
+        cursor_lossy = cursor_lossy || topster.cursor_lossy;
+    }
+
+    // A heap of `MAX_SIZE` >= page size + `num_cursor_skipped()` can't lose any KV that belongs to the page, since
+    // at most `num_cursor_skipped()` of the KVs ahead of one turned away are ever taken out.
+    bool is_cursor_lossy() const {
+        return cursor_lossy;
+    }
+
+    size_t num_cursor_skipped() const {
+        return cursor_skipped_keys.size();
+    }
+
     static bool is_greater(const struct KV* i, const struct KV* j) {
         return std::tie(i->scores[0], i->scores[1], i->scores[2], i->key) >
                std::tie(j->scores[0], j->scores[1], j->scores[2], j->key);
@@ -292,6 +484,10 @@ struct Topster {
     }
 
     void clear(){
+        for(size_t i = 0; i < size; i++) {
+            erase_key(kvs[i]->key);
+        }
+
         size = 0;
     }
 
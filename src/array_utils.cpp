@@ -1,5 +1,111 @@
 #include "array_utils.h"
 #include <memory.h>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <sse2neon.h>
+#endif
+
+namespace {
+    typedef size_t (*and_kernel_t)(const uint32_t*, size_t, const uint32_t*, size_t, uint32_t*);
+
+#if defined(__x86_64__) || defined(__aarch64__)
+    // Compares blocks of 4 integers from each list against all 4 rotations of the other block.
+    // Needs only SSE2 on x86 and is mapped to NEON through sse2neon on ARM.
+    size_t and_sse(const uint32_t* A, const size_t lenA, const uint32_t* B, const size_t lenB, uint32_t* out) {
+        size_t i = 0, j = 0, count = 0;
+        const size_t stA = lenA & ~size_t(3);
+        const size_t stB = lenB & ~size_t(3);
+
+        while(i < stA && j < stB) {
+            const __m128i va = _mm_loadu_si128((const __m128i*)(A + i));
+            const __m128i vb = _mm_loadu_si128((const __m128i*)(B + j));
+
+            __m128i cmp = _mm_cmpeq_epi32(va, vb);
+            cmp = _mm_or_si128(cmp, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+            cmp = _mm_or_si128(cmp, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+            cmp = _mm_or_si128(cmp, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(cmp));
+            while(mask != 0) {
+                out[count++] = A[i + __builtin_ctz(mask)];
+                mask &= (mask - 1);
+            }
+
+            const uint32_t a_max = A[i + 3];
+            const uint32_t b_max = B[j + 3];
+
+            if(a_max <= b_max) {
+                i += 4;
+            }
+
+            if(b_max <= a_max) {
+                j += 4;
+            }
+        }
+
+        return count + ArrayUtils::and_merge(A + i, lenA - i, B + j, lenB - j, out + count);
+    }
+#endif
+
+#if defined(__x86_64__)
+    // Same scheme as `and_sse` on blocks of 8, compiled for AVX2 and picked only when the CPU supports it
+    __attribute__((target("avx2")))
+    size_t and_avx2(const uint32_t* A, const size_t lenA, const uint32_t* B, const size_t lenB, uint32_t* out) {
+        size_t i = 0, j = 0, count = 0;
+        const size_t stA = lenA & ~size_t(7);
+        const size_t stB = lenB & ~size_t(7);
+        const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+        while(i < stA && j < stB) {
+            const __m256i va = _mm256_loadu_si256((const __m256i*)(A + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(B + j));
+
+            __m256i cmp = _mm256_cmpeq_epi32(va, vb);
+            for(size_t r = 1; r < 8; r++) {
+                vb = _mm256_permutevar8x32_epi32(vb, rotate);
+                cmp = _mm256_or_si256(cmp, _mm256_cmpeq_epi32(va, vb));
+            }
+
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+            while(mask != 0) {
+                out[count++] = A[i + __builtin_ctz(mask)];
+                mask &= (mask - 1);
+            }
+
+            const uint32_t a_max = A[i + 7];
+            const uint32_t b_max = B[j + 7];
+
+            if(a_max <= b_max) {
+                i += 8;
+            }
+
+            if(b_max <= a_max) {
+                j += 8;
+            }
+        }
+
+        return count + and_sse(A + i, lenA - i, B + j, lenB - j, out + count);
+    }
+#endif
+
+    and_kernel_t select_vector_kernel() {
+#if defined(__x86_64__)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) {
+            return and_avx2;
+        }
+
+        return and_sse;
+#elif defined(__aarch64__)
+        return and_sse;
+#else
+        return ArrayUtils::and_merge;
+#endif
+    }
+}
 
 size_t ArrayUtils::and_scalar(const uint32_t *A, const size_t lenA,
                               const uint32_t *B, const size_t lenB, uint32_t **results) {
@@ -8,7 +114,38 @@ size_t ArrayUtils::and_scalar(const uint32_t *A, const size_t lenA,
   }
 
   *results = new uint32_t[std::min(lenA, lenB)];
-  uint32_t *out = *results;
+  return and_into(A, lenA, B, lenB, *results);
+}
+
+size_t ArrayUtils::and_into(const uint32_t *A, const size_t lenA,
+                            const uint32_t *B, const size_t lenB, uint32_t *out) {
+  if (lenA == 0 || lenB == 0) {
+    return 0;
+  }
+
+  // skewed sizes: probe the larger list for every element of the smaller one
+  if (lenA * GALLOPING_SIZE_RATIO < lenB) {
+    return and_galloping(A, lenA, B, lenB, out);
+  }
+
+  if (lenB * GALLOPING_SIZE_RATIO < lenA) {
+    return and_galloping(B, lenB, A, lenA, out);
+  }
+
+  return and_vector(A, lenA, B, lenB, out);
+}
+
+size_t ArrayUtils::and_vector(const uint32_t *A, const size_t lenA,
+                              const uint32_t *B, const size_t lenB, uint32_t *out) {
+  static const and_kernel_t kernel = select_vector_kernel();
+  return kernel(A, lenA, B, lenB, out);
+}
+
+size_t ArrayUtils::and_merge(const uint32_t *A, const size_t lenA,
+                             const uint32_t *B, const size_t lenB, uint32_t *out) {
+  if (lenA == 0 || lenB == 0) {
+    return 0;
+  }
 
   const uint32_t *const initout(out);
   const uint32_t *endA = A + lenA;
@@ -36,6 +173,49 @@ size_t ArrayUtils::and_scalar(const uint32_t *A, const size_t lenA,
   return (out - initout); // NOTREACHED
 }
 
+size_t ArrayUtils::and_galloping(const uint32_t *small, const size_t lenSmall,
+                                 const uint32_t *large, const size_t lenLarge, uint32_t *out) {
+  size_t count = 0;
+  size_t large_index = 0;
+
+  for(size_t i = 0; i < lenSmall; i++) {
+    large_index = gallop_lower_bound(large, large_index, lenLarge, small[i]);
+    if(large_index == lenLarge) {
+      break;
+    }
+
+    if(large[large_index] == small[i]) {
+      out[count++] = small[i];
+      large_index++;
+    }
+  }
+
+  return count;
+}
+
+size_t ArrayUtils::gallop_lower_bound(const uint32_t *arr, size_t from, const size_t len, const uint32_t target) {
+  if(from >= len || arr[from] >= target) {
+    return from;
+  }
+
+  // invariant: arr[lo] < target
+  size_t lo = from;
+  size_t step = 1;
+  size_t hi = lo + step;
+
+  while(hi < len && arr[hi] < target) {
+    lo = hi;
+    step <<= 1;
+    hi = lo + step;
+  }
+
+  if(hi > len) {
+    hi = len;
+  }
+
+  return std::lower_bound(arr + lo + 1, arr + hi, target) - arr;
+}
+
 // merges two sorted arrays and also removes duplicates
 size_t ArrayUtils::or_scalar(const uint32_t *A, const size_t lenA,
                              const uint32_t *B, const size_t lenB, uint32_t **out) {
@@ -124,6 +304,22 @@ size_t ArrayUtils::exclude_scalar(const uint32_t *A, const size_t lenA,
 
   uint32_t* results = new uint32_t[lenA];
 
+  if(lenA * GALLOPING_SIZE_RATIO < lenB) {
+    // filter list is much larger: gallop through it instead of walking every element
+    for(indexA = 0; indexA < lenA; indexA++) {
+      indexB = gallop_lower_bound(B, indexB, lenB, A[indexA]);
+      if(indexB == lenB || B[indexB] != A[indexA]) {
+        results[res_index++] = A[indexA];
+      }
+    }
+
+    *out = new uint32_t[res_index];
+    memcpy(*out, results, res_index * sizeof(uint32_t));
+    delete[] results;
+
+    return res_index;
+  }
+
   while (indexA < lenA && indexB < lenB) {
     if (A[indexA] < B[indexB]) {
       results[res_index] = A[indexA];
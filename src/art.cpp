@@ -19,6 +19,7 @@
 #include <list>
 #include <stdint.h>
 #include <posting.h>
+#include "filter_iterator.h"
 #include "art.h"
 #include "logger.h"
 
@@ -48,56 +49,70 @@ static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *
 void art_int_fuzzy_recurse(art_node *n, int depth, const unsigned char* int_str, int int_str_len,
                            NUM_COMPARATOR comparator, std::vector<const art_leaf *> &results);
 
+static art_leaf* minimum(const art_node *n);
+
+// Ties are broken on the key, so that the order of equally ranked leaves does not depend on the order of traversal
+static bool compare_art_leaf_key(const art_leaf *a, const art_leaf *b) {
+    int cmp = memcmp(a->key, b->key, std::min(a->key_len, b->key_len));
+    return (cmp != 0) ? (cmp < 0) : (a->key_len < b->key_len);
+}
+
 bool compare_art_leaf_frequency(const art_leaf *a, const art_leaf *b) {
-    return posting_t::num_ids(a->values) > posting_t::num_ids(b->values);
+    uint32_t a_value = posting_t::num_ids(a->values), b_value = posting_t::num_ids(b->values);
+    return (a_value != b_value) ? (a_value > b_value) : compare_art_leaf_key(a, b);
 }
 
 bool compare_art_leaf_score(const art_leaf *a, const art_leaf *b) {
-    return a->max_score > b->max_score;
+    return (a->max_score != b->max_score) ? (a->max_score > b->max_score) : compare_art_leaf_key(a, b);
 }
 
-bool compare_art_node_frequency(const art_node *a, const art_node *b) {
-    uint32_t a_value = 0, b_value = 0;
-
-    if(IS_LEAF(a)) {
-        art_leaf* al = (art_leaf *) LEAF_RAW(a);
-        a_value = posting_t::num_ids(al->values);
+// Number of ids of a leaf, or the largest number of ids of any leaf under a node
+static uint32_t get_token_count(const art_node* n) {
+    if(IS_LEAF(n)) {
+        art_leaf* l = (art_leaf *) LEAF_RAW(n);
+        return posting_t::num_ids(l->values);
     }
 
-    if(IS_LEAF(b)) {
-        art_leaf* bl = (art_leaf *) LEAF_RAW(b);
-        b_value = posting_t::num_ids(bl->values);
+    return n->max_token_count;
+}
+
+static int64_t get_max_score(const art_node* n) {
+    if(IS_LEAF(n)) {
+        art_leaf* l = (art_leaf *) LEAF_RAW(n);
+        return l->max_score;
     }
 
-    return a_value > b_value;
+    return n->max_score;
 }
 
-bool compare_art_node_score(const art_node* a, const art_node* b) {
-    int64_t a_value = std::numeric_limits<int64_t>::min(), b_value = std::numeric_limits<int64_t>::min();
+// Aggregates are only ever raised: once a leaf is deleted or loses ids, they remain upper bounds of the subtree
+static void update_max_aggregates(art_node* n, const art_node* child) {
+    n->max_score = MAX(n->max_score, get_max_score(child));
+    n->max_token_count = MAX(n->max_token_count, get_token_count(child));
+}
 
-    if(IS_LEAF(a)) {
-        art_leaf* al = (art_leaf *) LEAF_RAW(a);
-        a_value = al->max_score;
-    } else {
-        a_value = a->max_score;
-    }
+bool compare_art_node_frequency(const art_node *a, const art_node *b) {
+    return get_token_count(a) > get_token_count(b);
+}
 
-    if(IS_LEAF(b)) {
-        art_leaf* bl = (art_leaf *) LEAF_RAW(b);
-        b_value = bl->max_score;
-    } else {
-        b_value = b->max_score;
-    }
+bool compare_art_node_score(const art_node* a, const art_node* b) {
+    return get_max_score(a) > get_max_score(b);
+}
 
-    return a_value > b_value;
+// On ties, entries are popped in order of the smallest key under them: a leaf is then only popped once every
+// equally ranked leaf with a smaller key has been reached, so the top-k do not depend on the order of traversal
+static bool compare_art_node_min_key_pq(const art_node* a, const art_node* b) {
+    return compare_art_leaf_key(minimum(b), minimum(a));
 }
 
 bool compare_art_node_frequency_pq(const art_node *a, const art_node *b) {
-    return !compare_art_node_frequency(a, b);
+    uint32_t a_value = get_token_count(a), b_value = get_token_count(b);
+    return (a_value != b_value) ? (a_value < b_value) : compare_art_node_min_key_pq(a, b);
 }
 
 bool compare_art_node_score_pq(const art_node* a, const art_node* b) {
-    return !compare_art_node_score(a, b);
+    int64_t a_value = get_max_score(a), b_value = get_max_score(b);
+    return (a_value != b_value) ? (a_value < b_value) : compare_art_node_min_key_pq(a, b);
 }
 
 /**
@@ -124,6 +139,7 @@ static art_node* alloc_node(uint8_t type) {
     }
     n->type = type;
     n->max_score = 0;
+    n->max_token_count = 0;
     return n;
 }
 
@@ -466,6 +482,7 @@ static void copy_header(art_node *dest, art_node *src) {
     dest->num_children = src->num_children;
     dest->partial_len = src->partial_len;
     dest->max_score = src->max_score;
+    dest->max_token_count = src->max_token_count;
     memcpy(dest->partial, src->partial, min(MAX_PREFIX_LEN, src->partial_len));
 }
 
@@ -473,7 +490,7 @@ static void add_child256(art_node256 *n, art_node **ref, unsigned char c, void *
     (void)ref;
     n->n.num_children++;
     n->children[c] = (art_node *) child;
-    n->n.max_score = MAX(n->n.max_score, ((art_leaf *) LEAF_RAW(child))->max_score);
+    update_max_aggregates((art_node *) n, (const art_node *) child);
 }
 
 static void add_child48(art_node48 *n, art_node **ref, unsigned char c, void *child) {
@@ -483,7 +500,7 @@ static void add_child48(art_node48 *n, art_node **ref, unsigned char c, void *ch
         n->children[pos] = (art_node *) child;
         n->keys[c] = pos + 1;
         n->n.num_children++;
-        n->n.max_score = MAX(n->n.max_score, ((art_leaf *) LEAF_RAW(child))->max_score);
+        update_max_aggregates((art_node *) n, (const art_node *) child);
     } else {
         art_node256 *new_n = (art_node256*)alloc_node(NODE256);
         for (int i=0;i<256;i++) {
@@ -524,7 +541,7 @@ static void add_child16(art_node16 *n, art_node **ref, unsigned char c, void *ch
         n->keys[idx] = c;
         n->children[idx] = (art_node *) child;
         n->n.num_children++;
-        n->n.max_score = MAX(n->n.max_score, ((art_leaf *) LEAF_RAW(child))->max_score);
+        update_max_aggregates((art_node *) n, (const art_node *) child);
 
     } else {
         art_node48 *new_n = (art_node48*)alloc_node(NODE48);
@@ -557,7 +574,7 @@ static void add_child4(art_node4 *n, art_node **ref, unsigned char c, void *chil
         n->keys[idx] = c;
         n->children[idx] = (art_node *) child;
         n->n.num_children++;
-        n->n.max_score = MAX(n->n.max_score, ((art_leaf *) LEAF_RAW(child))->max_score);
+        update_max_aggregates((art_node *) n, (const art_node *) child);
 
     } else {
         art_node16 *new_n = (art_node16*)alloc_node(NODE16);
@@ -710,7 +727,11 @@ static void* recursive_insert(art_node* n, art_node** ref, const unsigned char*
     // Find a child to recurse to
     art_node **child = find_child(n, key[depth]);
     if (child) {
-        return recursive_insert(*child, child, key, key_len, docs_max_score, documents, depth + 1, path, old);
+        void* old_values = recursive_insert(*child, child, key, key_len, docs_max_score, documents, depth + 1,
+                                            path, old);
+        // the child could have been replaced, and an existing leaf could have more ids now
+        update_max_aggregates(n, *child);
+        return old_values;
     }
 
     // No child, node goes within us
@@ -931,22 +952,11 @@ void* art_delete(art_tree *t, const unsigned char *key, int key_len) {
     return NULL;
 }
 
-/*static uint32_t get_score(art_node* child) {
-    if (IS_LEAF(child)) {
-        art_leaf *l = (art_leaf *) LEAF_RAW(child);
-        return l->values->ids.getLength();
-    }
-
-    return child->max_token_count;
-}*/
-
 int art_topk_iter(const art_node *root, token_ordering token_order, size_t max_results,
-                  const uint32_t* filter_ids, size_t filter_ids_length,
+                  filter_iterator_t* filter_it,
                   const std::set<std::string>& exclude_leaves, const art_leaf* exact_leaf,
                   std::vector<art_leaf *>& results) {
 
-    printf("INSIDE art_topk_iter: root->type: %d\n", root->type);
-
     std::priority_queue<const art_node *, std::vector<const art_node *>,
             decltype(&compare_art_node_score_pq)> q(compare_art_node_score_pq);
 
@@ -957,72 +967,61 @@ int art_topk_iter(const art_node *root, token_ordering token_order, size_t max_r
 
     q.push(root);
 
-    while(!q.empty() && results.size() < max_results*4) {
+    // leaves are popped in descending order of score, so the first `max_results` of them are the top-k
+    size_t num_results = 0;
+
+    while(!q.empty() && num_results < max_results) {
         art_node *n = (art_node *) q.top();
         q.pop();
 
-        /*if (IS_LEAF(n)) {
-            art_leaf *l = (art_leaf *) LEAF_RAW(n);
-            LOG(INFO) << "Top node (leaf) score: " << l->max_score;
-        } else {
-            LOG(INFO) << "Top node score: " << n->max_score;
-        }*/
-
         if (!n) continue;
         if (IS_LEAF(n)) {
             art_leaf *l = (art_leaf *) LEAF_RAW(n);
-            //LOG(INFO) << "END LEAF SCORE: " << l->max_score;
 
-            if(filter_ids_length == 0) {
+            if(l == exact_leaf) {
+                continue;
+            }
+
+            // we will push leaf only if filter matches with leaf IDs
+            if(filter_it != nullptr && !posting_t::contains_atleast_one(l->values, filter_it)) {
+                continue;
+            }
+
+            if(!exclude_leaves.empty()) {
                 std::string tok(reinterpret_cast<char*>(l->key), l->key_len - 1);
-                if(exclude_leaves.count(tok) != 0 || l == exact_leaf) {
+                if(exclude_leaves.count(tok) != 0) {
                     continue;
                 }
-                results.push_back(l);
-            } else {
-                // we will push leaf only if filter matches with leaf IDs
-                bool found_atleast_one = posting_t::contains_atleast_one(l->values, filter_ids, filter_ids_length);
-                if(found_atleast_one) {
-                    std::string tok(reinterpret_cast<char*>(l->key), l->key_len - 1);
-                    if(exclude_leaves.count(tok) != 0 || l == exact_leaf) {
-                        continue;
-                    }
-                    results.push_back(l);
-                }
             }
 
+            results.push_back(l);
+            num_results++;
             continue;
         }
 
         int idx;
         switch (n->type) {
             case NODE4:
-                //LOG(INFO)  << "NODE4, SCORE: " << n->max_score;
                 for (int i=0; i < n->num_children; i++) {
-                    art_node* child = ((art_node4*)n)->children[i];
-                    q.push(child);
+                    q.push(((art_node4*)n)->children[i]);
                 }
                 break;
 
             case NODE16:
-                //LOG(INFO)  << "NODE16, SCORE: " << n->max_score;
                 for (int i=0; i < n->num_children; i++) {
                     q.push(((art_node16*)n)->children[i]);
                 }
                 break;
 
             case NODE48:
-                //LOG(INFO)  << "NODE48, SCORE: " << n->max_score;
                 for (int i=0; i < 256; i++) {
                     idx = ((art_node48*)n)->keys[i];
                     if (!idx) continue;
-                    art_node *child = ((art_node48*)n)->children[idx - 1];
-                    q.push(child);
+                    q.push(((art_node48*)n)->children[idx - 1]);
                 }
                 break;
 
             case NODE256:
-                //LOG(INFO)  << "NODE256, SCORE: " << n->max_score;
                 for (int i=0; i < 256; i++) {
                     if (!((art_node256*)n)->children[i]) continue;
                     q.push(((art_node256*)n)->children[i]);
@@ -1030,16 +1029,10 @@ int art_topk_iter(const art_node *root, token_ordering token_order, size_t max_r
                 break;
 
             default:
-                printf("ABORTING BECAUSE OF UNKNOWN NODE TYPE: %d\n", n->type);
                 abort();
         }
     }
 
-    /*LOG(INFO) << "leaf results.size: " << results.size()
-              << ", filter_ids_length: " << filter_ids_length
-              << ", num_large_lists: " << num_large_lists;*/
-
-    printf("OUTSIDE art_topk_iter: results size: %d\n", results.size());
     return 0;
 }
 
@@ -1297,8 +1290,9 @@ static inline void rotate(int &i, int &j, int &k) {
 }
 
 // -1: return without adding, 0 : continue iteration, 1: return after adding
+template<typename cost_row_t>
 static inline int fuzzy_search_state(const bool prefix, int key_index, bool last_key_char,
-                                     int term_len, const int* cost_row, int min_cost, int max_cost) {
+                                     int term_len, const cost_row_t& cost_row, int min_cost, int max_cost) {
 
     // a) iter_len < term_len: "pltninum" (term) on "pst" (key)
     // b) term_len < iter_len: "pst" (term) on "pltninum" (key)
@@ -1483,48 +1477,253 @@ static void art_fuzzy_recurse(unsigned char p, unsigned char c, const art_node *
     art_fuzzy_children(c, n, depth, term, term_len, rows[i], rows[j], min_cost, max_cost, prefix, results);
 }
 
-/**
- * Returns leaves that match a given string within a fuzzy distance of max_cost.
- */
-int art_fuzzy_search(art_tree *t, const unsigned char *term, const int term_len, const int min_cost, const int max_cost,
-                     const int max_words, const token_ordering token_order, const bool prefix,
-                     const uint32_t *filter_ids, size_t filter_ids_length,
-                     std::vector<art_leaf *> &results, const std::set<std::string>& exclude_leaves) {
+// Terms of up to 64 bytes have their edit distance rows computed bit-parallel (Myers, with Hyyrö's extension for
+// transpositions): a row is kept as the +1/-1 differences between adjacent columns, so that advancing it by a key
+// character takes a handful of word operations instead of a pass over all the columns.
+#define FUZZY_BITS_MAX_TERM_LEN 64
+
+struct fuzzy_bits_term_t {
+    uint64_t match_masks[256];   // bit `x` of `match_masks[c]` is set when term[x] == c
+    uint64_t term_mask;
+};
+
+struct fuzzy_bits_row_t {
+    uint64_t pos_deltas;         // bit `x` is set when row[x+1] - row[x] == +1
+    uint64_t neg_deltas;         // bit `x` is set when row[x+1] - row[x] == -1
+    uint64_t zero_diagonals;     // diagonal steps of the last advance that kept the cost unchanged
+    uint64_t prev_match_mask;    // match mask of the previous key character
+    int first_cost;              // row[0], i.e. the number of key characters consumed
+
+    int operator[](const int column) const {
+        const uint64_t mask = (column == FUZZY_BITS_MAX_TERM_LEN) ? UINT64_MAX : ((1ULL << column) - 1);
+        return first_cost + __builtin_popcountll(pos_deltas & mask) - __builtin_popcountll(neg_deltas & mask);
+    }
+};
+
+// Same recurrence as `levenshtein_dist()`, including when a transposition is considered
+static inline void levenshtein_bits(const int depth, const unsigned char c, const fuzzy_bits_term_t& bterm,
+                                    fuzzy_bits_row_t& row) {
+    const uint64_t match_mask = bterm.match_masks[c];
+    const uint64_t transpositions = (depth > 1) ?
+                                    (((~row.zero_diagonals & match_mask) << 1) & row.prev_match_mask) : 0;
+
+    const uint64_t zero_diagonals = (((match_mask & row.pos_deltas) + row.pos_deltas) ^ row.pos_deltas) |
+                                    match_mask | row.neg_deltas | transpositions;
+
+    const uint64_t pos_horizontal = row.neg_deltas | ~(zero_diagonals | row.pos_deltas);
+    const uint64_t neg_horizontal = row.pos_deltas & zero_diagonals;
+
+    // cost of the empty term prefix always grows by one
+    const uint64_t pos_shifted = (pos_horizontal << 1) | 1;
+    const uint64_t neg_shifted = neg_horizontal << 1;
+
+    row.pos_deltas = (neg_shifted | ~(zero_diagonals | pos_shifted)) & bterm.term_mask;
+    row.neg_deltas = (pos_shifted & zero_diagonals) & bterm.term_mask;
+    row.zero_diagonals = zero_diagonals;
+    row.prev_match_mask = match_mask;
+    row.first_cost++;
+}
+
+static void art_fuzzy_bits_recurse(unsigned char c, const art_node *n, int depth, const unsigned char *term,
+                                   const int term_len, const fuzzy_bits_term_t& bterm, fuzzy_bits_row_t row,
+                                   const int min_cost, const int max_cost, const bool prefix,
+                                   std::vector<const art_node *> &results);
+
+static inline void art_fuzzy_bits_children(const art_node *n, int depth, const unsigned char *term, const int term_len,
+                                           const fuzzy_bits_term_t& bterm, const fuzzy_bits_row_t& row,
+                                           const int min_cost, const int max_cost, const bool prefix,
+                                           std::vector<const art_node *> &results) {
+    // children are visited in the same (descending) order as `art_fuzzy_children()`
+    switch (n->type) {
+        case NODE4:
+            for (int i=n->num_children-1; i >= 0; i--) {
+                art_fuzzy_bits_recurse(((art_node4*)n)->keys[i], ((art_node4*)n)->children[i], depth, term, term_len,
+                                       bterm, row, min_cost, max_cost, prefix, results);
+            }
+            break;
+        case NODE16:
+            for (int i=n->num_children-1; i >= 0; i--) {
+                art_fuzzy_bits_recurse(((art_node16*)n)->keys[i], ((art_node16*)n)->children[i], depth, term, term_len,
+                                       bterm, row, min_cost, max_cost, prefix, results);
+            }
+            break;
+        case NODE48:
+            for (int i=255; i >= 0; i--) {
+                int ix = ((art_node48*)n)->keys[i];
+                if (!ix) continue;
+                art_fuzzy_bits_recurse((unsigned char) i, ((art_node48*)n)->children[ix - 1], depth, term, term_len,
+                                       bterm, row, min_cost, max_cost, prefix, results);
+            }
+            break;
+        case NODE256:
+            for (int i=255; i >= 0; i--) {
+                if (!((art_node256*)n)->children[i]) continue;
+                art_fuzzy_bits_recurse((unsigned char) i, ((art_node256*)n)->children[i], depth, term, term_len,
+                                       bterm, row, min_cost, max_cost, prefix, results);
+            }
+            break;
+        default:
+            abort();
+    }
+}
+
+// Mirrors `art_fuzzy_recurse()` step for step, only the rows are advanced with `levenshtein_bits()`
+static void art_fuzzy_bits_recurse(unsigned char c, const art_node *n, int depth, const unsigned char *term,
+                                   const int term_len, const fuzzy_bits_term_t& bterm, fuzzy_bits_row_t row,
+                                   const int min_cost, const int max_cost, const bool prefix,
+                                   std::vector<const art_node *> &results) {
+    if (!n) return ;
+
+    if(depth == -1) {
+        // root node
+        depth = 0;
+    } else {
+        // check indexed char first
+        bool last_key_char = (c == '\0');
+
+        if(!prefix || !last_key_char) {
+            levenshtein_bits(depth, c, bterm, row);
+        }
+
+        int action = fuzzy_search_state(prefix, depth, last_key_char, term_len, row, min_cost, max_cost);
+        if(1 == action) {
+            results.push_back(n);
+            return;
+        }
+
+        if(action == -1) {
+            return;
+        }
+
+        depth++;
+    }
+
+    if(IS_LEAF(n)) {
+        art_leaf *l = (art_leaf *) LEAF_RAW(n);
+
+        // look past term_len to deal with trailing typo, e.g. searching "pltinum" on "platinum" @ max_cost = 1
+        const int iter_len = std::min(int(l->key_len), term_len + max_cost);
+
+        if(depth >= iter_len) {
+            // when a preceding partial node completely contains the whole leaf (e.g. "[raspberr]y" on "raspberries")
+            int action = fuzzy_search_state(prefix, depth, true, term_len, row, min_cost, max_cost);
+            if(action == 1) {
+                results.push_back(n);
+            }
+
+            return;
+        }
+
+        while(depth < iter_len) {
+            c = l->key[depth];
+            bool last_key_char = (c == '\0');
+
+            if(!prefix || !last_key_char) {
+                levenshtein_bits(depth, c, bterm, row);
+            }
+
+            int action = fuzzy_search_state(prefix, depth, last_key_char, term_len, row, min_cost, max_cost);
+            if(action == 1) {
+                results.push_back(n);
+                return;
+            }
+
+            if(action == -1) {
+                return;
+            }
+
+            depth++;
+        }
+
+        return ;
+    }
+
+    int partial_len = min(MAX_PREFIX_LEN, n->partial_len);
+
+    for (int idx = 0; idx < partial_len; idx++) {
+        levenshtein_bits(depth, n->partial[idx], bterm, row);
+
+        int action = fuzzy_search_state(prefix, depth, false, term_len, row, min_cost, max_cost);
+        if(action == 1) {
+            results.push_back(n);
+            return;
+        }
+
+        if(action == -1) {
+            return;
+        }
+
+        depth++;
+    }
+
+    // Some intermediate path may have been left out if partial_len is truncated: progress the levenshtein matrix
+    while(partial_len < n->partial_len && depth < term_len) {
+        levenshtein_bits(depth, term[depth], bterm, row);
+
+        int action = fuzzy_search_state(prefix, depth, false, term_len, row, min_cost, max_cost);
+        if(action == 1) {
+            results.push_back(n);
+            return;
+        }
+
+        if(action == -1) {
+            return;
+        }
+
+        depth++;
+        partial_len++;
+    }
+
+    art_fuzzy_bits_children(n, depth, term, term_len, bterm, row, min_cost, max_cost, prefix, results);
+}
+
+void art_fuzzy_nodes(art_tree *t, const unsigned char *term, const int term_len, const int min_cost,
+                     const int max_cost, const bool prefix, const bool bit_parallel,
+                     std::vector<const art_node*>& nodes) {
+    if(t->root == nullptr) {
+        return ;
+    }
+
+    if(bit_parallel && term_len <= FUZZY_BITS_MAX_TERM_LEN) {
+        fuzzy_bits_term_t bterm{};
+        for(int i = 0; i < term_len; i++) {
+            bterm.match_masks[term[i]] |= (1ULL << i);
+        }
+
+        bterm.term_mask = (term_len == FUZZY_BITS_MAX_TERM_LEN) ? UINT64_MAX : ((1ULL << term_len) - 1);
+
+        // row[x] = x: the first `x` term characters are all inserted
+        fuzzy_bits_row_t row{bterm.term_mask, 0, 0, 0, 0};
+
+        if(IS_LEAF(t->root)) {
+            art_leaf *l = (art_leaf *) LEAF_RAW(t->root);
+            art_fuzzy_bits_recurse(l->key[0], t->root, 0, term, term_len, bterm, row, min_cost, max_cost, prefix, nodes);
+        } else {
+            // send depth as -1 to indicate that this is a root node
+            art_fuzzy_bits_recurse(0, t->root, -1, term, term_len, bterm, row, min_cost, max_cost, prefix, nodes);
+        }
+
+        return ;
+    }
 
-    std::vector<const art_node*> nodes;
     int irow[term_len + 1];
     int jrow[term_len + 1];
     for (int i = 0; i <= term_len; i++){
         irow[i] = jrow[i] = i;
     }
 
-    //auto begin = std::chrono::high_resolution_clock::now();
-
     if(IS_LEAF(t->root)) {
         art_leaf *l = (art_leaf *) LEAF_RAW(t->root);
         art_fuzzy_recurse(0, l->key[0], t->root, 0, term, term_len, irow, jrow, min_cost, max_cost, prefix, nodes);
     } else {
-        if(t->root == nullptr) {
-            return 0;
-        }
-
         // send depth as -1 to indicate that this is a root node
         art_fuzzy_recurse(0, 0, t->root, -1, term, term_len, irow, jrow, min_cost, max_cost, prefix, nodes);
     }
+}
 
-    //long long int time_micro = microseconds(std::chrono::high_resolution_clock::now() - begin).count();
-    //!LOG(INFO) << "Time taken for fuzz: " << time_micro << "us, size of nodes: " << nodes.size();
-
-    //auto begin = std::chrono::high_resolution_clock::now();
-
-    size_t key_len = prefix ? term_len + 1 : term_len;
-    art_leaf* exact_leaf = (art_leaf *) art_search(t, term, key_len);
-    //LOG(INFO) << "exact_leaf: " << exact_leaf << ", term: " << term << ", term_len: " << term_len;
-
-    for(auto node: nodes) {
-        art_topk_iter(node, token_order, max_words, filter_ids, filter_ids_length, exclude_leaves, exact_leaf, results);
-    }
-
+// Orders the leaves found, with the exact match of the term first
+static void rank_fuzzy_results(art_leaf* exact_leaf, const int min_cost, const int max_words,
+                               const token_ordering token_order, std::vector<art_leaf *>& results) {
     if(token_order == FREQUENCY) {
         std::sort(results.begin(), results.end(), compare_art_leaf_frequency);
     } else {
@@ -1538,18 +1737,152 @@ int art_fuzzy_search(art_tree *t, const unsigned char *term, const int term_len,
     if(results.size() > max_words) {
         results.resize(max_words);
     }
+}
+
+/**
+ * Returns leaves that match a given string within a fuzzy distance of max_cost.
+ */
+int art_fuzzy_search(art_tree *t, const unsigned char *term, const int term_len, const int min_cost, const int max_cost,
+                     const int max_words, const token_ordering token_order, const bool prefix,
+                     filter_iterator_t* filter_it,
+                     std::vector<art_leaf *> &results, const std::set<std::string>& exclude_leaves) {
+
+    std::vector<const art_node*> nodes;
+
+    //auto begin = std::chrono::high_resolution_clock::now();
+
+    if(t->root == nullptr) {
+        return 0;
+    }
+
+    art_fuzzy_nodes(t, term, term_len, min_cost, max_cost, prefix, true, nodes);
+
+    //long long int time_micro = microseconds(std::chrono::high_resolution_clock::now() - begin).count();
+    //!LOG(INFO) << "Time taken for fuzz: " << time_micro << "us, size of nodes: " << nodes.size();
+
+    //auto begin = std::chrono::high_resolution_clock::now();
+
+    size_t key_len = prefix ? term_len + 1 : term_len;
+    art_leaf* exact_leaf = (art_leaf *) art_search(t, term, key_len);
+    //LOG(INFO) << "exact_leaf: " << exact_leaf << ", term: " << term << ", term_len: " << term_len;
+
+    for(auto node: nodes) {
+        art_topk_iter(node, token_order, max_words, filter_it, exclude_leaves, exact_leaf, results);
+    }
+
+    rank_fuzzy_results(exact_leaf, min_cost, max_words, token_order, results);
 
     /*auto time_micro = microseconds(std::chrono::high_resolution_clock::now() - begin).count();
 
     if(time_micro > 1000) {
         LOG(INFO) << "Time taken for art_topk_iter: " << time_micro
-                  << "us, size of nodes: " << nodes.size()
-                  << ", filter_ids_length: " << filter_ids_length;
+                  << "us, size of nodes: " << nodes.size();
     }*/
 
     return 0;
 }
 
+static bool collect_leaves(const art_node* n, const size_t max_leaves, std::vector<art_leaf*>& leaves) {
+    if(!n) {
+        return true;
+    }
+
+    if(IS_LEAF(n)) {
+        leaves.push_back((art_leaf *) LEAF_RAW(n));
+        return leaves.size() <= max_leaves;
+    }
+
+    switch (n->type) {
+        case NODE4:
+            for (int i=0; i < n->num_children; i++) {
+                if(!collect_leaves(((art_node4*)n)->children[i], max_leaves, leaves)) return false;
+            }
+            break;
+
+        case NODE16:
+            for (int i=0; i < n->num_children; i++) {
+                if(!collect_leaves(((art_node16*)n)->children[i], max_leaves, leaves)) return false;
+            }
+            break;
+
+        case NODE48:
+            for (int i=0; i < 256; i++) {
+                int idx = ((art_node48*)n)->keys[i];
+                if (!idx) continue;
+                if(!collect_leaves(((art_node48*)n)->children[idx - 1], max_leaves, leaves)) return false;
+            }
+            break;
+
+        case NODE256:
+            for (int i=0; i < 256; i++) {
+                if (!((art_node256*)n)->children[i]) continue;
+                if(!collect_leaves(((art_node256*)n)->children[i], max_leaves, leaves)) return false;
+            }
+            break;
+
+        default:
+            abort();
+    }
+
+    return true;
+}
+
+bool art_fuzzy_candidates(art_tree *t, const unsigned char *term, const int term_len, const int min_cost,
+                          const int max_cost, const bool prefix, const size_t max_leaves,
+                          std::vector<art_leaf *>& candidates) {
+    if(t->root == nullptr) {
+        return true;
+    }
+
+    std::vector<const art_node*> nodes;
+    art_fuzzy_nodes(t, term, term_len, min_cost, max_cost, prefix, true, nodes);
+
+    for(auto node: nodes) {
+        if(!collect_leaves(node, max_leaves, candidates)) {
+            candidates.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int art_fuzzy_search_candidates(art_tree *t, const std::vector<art_leaf *>& candidates,
+                                const unsigned char *term, const int term_len, const int min_cost,
+                                const int max_words, const token_ordering token_order, const bool prefix,
+                                filter_iterator_t* filter_it,
+                                std::vector<art_leaf *> &results, const std::set<std::string>& exclude_leaves) {
+    if(t->root == nullptr) {
+        return 0;
+    }
+
+    size_t key_len = prefix ? term_len + 1 : term_len;
+    art_leaf* exact_leaf = (art_leaf *) art_search(t, term, key_len);
+
+    // same selection as the top-k iteration, which finds every candidate when there are fewer than `max_words`
+    for(art_leaf* l: candidates) {
+        if(l == exact_leaf) {
+            continue;
+        }
+
+        if(filter_it != nullptr && !posting_t::contains_atleast_one(l->values, filter_it)) {
+            continue;
+        }
+
+        if(!exclude_leaves.empty()) {
+            std::string tok(reinterpret_cast<char*>(l->key), l->key_len - 1);
+            if(exclude_leaves.count(tok) != 0) {
+                continue;
+            }
+        }
+
+        results.push_back(l);
+    }
+
+    rank_fuzzy_results(exact_leaf, min_cost, max_words, token_order, results);
+    return 0;
+}
+
 void encode_int32(int32_t n, unsigned char *chars) {
     unsigned char symbols[16] = {
       0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
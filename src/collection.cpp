@@ -169,6 +169,11 @@ nlohmann::json Collection::get_summary_json() const {
         field_json[fields::index] = coll_field.index;
         field_json[fields::sort] = coll_field.sort;
         field_json[fields::infix] = coll_field.infix;
+
+        if(coll_field.presorted) {
+            field_json[fields::sort_index] = fields::presorted;
+        }
+
         field_json[fields::locale] = coll_field.locale;
 
         fields_arr.push_back(field_json);
@@ -749,7 +754,12 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
                                   const size_t max_extra_prefix,
                                   const size_t max_extra_suffix,
                                   const size_t facet_query_num_typos,
-                                  const size_t filter_curated_hits_option) const {
+                                  const size_t filter_curated_hits_option,
+                                  const size_t facet_sample_percent,
+                                  const size_t facet_sample_threshold,
+                                  const std::string& search_after,
+                                  const std::string& typeahead_session,
+                                  const bool explain_filter) const {
 
     std::shared_lock lock(mutex);
 
@@ -757,6 +767,7 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
     search_stop_ms = search_stop_millis;
     search_begin = std::chrono::high_resolution_clock::now();
     search_cutoff = false;
+    search_blocks_skipped = 0;
 
     if(raw_query != "*" && search_fields.empty()) {
         return Option<nlohmann::json>(400, "No search fields specified for the query.");
@@ -772,6 +783,29 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
                                       std::to_string(GROUP_LIMIT_MAX) + ".");
     }
 
+    if(facet_sample_percent == 0 || facet_sample_percent > 100) {
+        return Option<nlohmann::json>(400, "Value of `facet_sample_percent` must be between 1 and 100.");
+    }
+
+    int64_t search_after_scores[3] = {0};
+    uint64_t search_after_key = 0;
+
+    if(!search_after.empty()) {
+        if(!group_by_fields.empty()) {
+            return Option<nlohmann::json>(400, "Parameter `search_after` cannot be used with `group_by`.");
+        }
+
+        if(page != 1) {
+            return Option<nlohmann::json>(400, "Parameter `search_after` cannot be used with `page`.");
+        }
+
+        Option<bool> search_after_op = parse_search_after_cursor(search_after, search_after_scores,
+                                                                 search_after_key);
+        if(!search_after_op.ok()) {
+            return Option<nlohmann::json>(search_after_op.code(), search_after_op.error());
+        }
+    }
+
     if(!search_fields.empty() && search_fields.size() != num_typos.size()) {
         if(num_typos.size() != 1) {
             return Option<nlohmann::json>(400, "Number of weights in `num_typos` does not match "
@@ -867,6 +901,14 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
 
     // validate facet fields
     for(const std::string & field_name: facet_fields) {
+        if(field_name.find('(') != std::string::npos) {
+            Option<bool> range_facet_op = parse_range_facet(field_name, facets);
+            if(!range_facet_op.ok()) {
+                return Option<nlohmann::json>(range_facet_op.code(), range_facet_op.error());
+            }
+            continue;
+        }
+
         if(search_schema.count(field_name) == 0 || !search_schema.at(field_name).facet) {
             std::string error = "Could not find a facet field named `" + field_name + "` in the schema.";
             return Option<nlohmann::json>(404, error);
@@ -938,6 +980,14 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
         }
     }
 
+    // bucketing reorders the hits by scores other than the ones a cursor holds
+    const bool text_match_bucketed = (match_score_index >= 0 &&
+                                      sort_fields_std[match_score_index].text_match_buckets > 1);
+
+    if(!search_after.empty() && text_match_bucketed) {
+        return Option<nlohmann::json>(400, "Parameter `search_after` cannot be used with `text_match` buckets.");
+    }
+
     // check for valid pagination
     if(page < 1) {
         std::string message = "Page must be an integer of value greater than 0.";
@@ -964,6 +1014,11 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
         max_hits = std::min(std::max((page * per_page), max_hits), get_num_documents());
     }
 
+    if(!search_after.empty()) {
+        // hits before the cursor are never admitted, so only a page worth of hits has to be kept
+        max_hits = std::min(per_page, get_num_documents());
+    }
+
     if(token_order == NOT_SET) {
         if(default_sorting_field.empty()) {
             token_order = FREQUENCY;
@@ -997,6 +1052,17 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
     curate_results(query, enable_overrides, pre_segmented_query, pinned_hits, hidden_hits,
                    included_ids, excluded_ids, filter_overrides, filter_curated_hits);
 
+    if(!search_after.empty()) {
+        // Pinned hits on cursor pages: pinned hits are returned only on the first page, at their pinned positions.
+        // Pages fetched with a `search_after` cursor exclude them, rather than ranking them again like any other
+        // hit, so that a pinned hit is never returned twice while paging.
+        for(const auto& included_id: included_ids) {
+            excluded_ids.push_back(included_id.first);
+        }
+
+        included_ids.clear();
+    }
+
     if(filter_curated_hits_option == 0 || filter_curated_hits_option == 1) {
         // When query param has explicit value set, override level configuration takes lower precedence.
         filter_curated_hits = bool(filter_curated_hits_option);
@@ -1074,21 +1140,50 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
     // search all indices
 
     size_t index_id = 0;
-    search_args* search_params = new search_args(field_query_tokens, weighted_search_fields,
-                                                 filters, facets, included_ids, excluded_ids,
-                                                 sort_fields_std, facet_query, num_typos, max_facet_values, max_hits,
-                                                 per_page, page, token_order, prefixes,
-                                                 drop_tokens_threshold, typo_tokens_threshold,
-                                                 group_by_fields, group_limit, default_sorting_field,
-                                                 prioritize_exact_match,
-                                                 exhaustive_search, 4, filter_overrides,
-                                                 search_stop_millis,
-                                                 min_len_1typo, min_len_2typo, max_candidates, infixes,
-                                                 max_extra_prefix, max_extra_suffix, facet_query_num_typos,
-                                                 filter_curated_hits, split_join_tokens);
-
+    // facet counts accumulate into `facets`, so a search that is run again has to start from the requested facets
+    const std::vector<facet> requested_facets = search_after.empty() ? std::vector<facet>() : facets;
+
+    const auto create_search_params = [&](const size_t topster_size) {
+        search_args* search_params = new search_args(field_query_tokens, weighted_search_fields,
+                                                     filters, facets, included_ids, excluded_ids,
+                                                     sort_fields_std, facet_query, num_typos, max_facet_values,
+                                                     topster_size, per_page, page, token_order, prefixes,
+                                                     drop_tokens_threshold, typo_tokens_threshold,
+                                                     group_by_fields, group_limit, default_sorting_field,
+                                                     prioritize_exact_match,
+                                                     exhaustive_search, 4, filter_overrides,
+                                                     search_stop_millis,
+                                                     min_len_1typo, min_len_2typo, max_candidates, infixes,
+                                                     max_extra_prefix, max_extra_suffix, facet_query_num_typos,
+                                                     filter_curated_hits, split_join_tokens, facet_sample_percent,
+                                                     facet_sample_threshold, typeahead_session,
+                                                     explain_filter);
+
+        if(!search_after.empty()) {
+            search_params->topster->set_cursor(search_after_scores, search_after_key);
+        }
+
+        return search_params;
+    };
+
+    search_args* search_params = create_search_params(max_hits);
     index->run_search(search_params);
 
+    if(search_params->topster->is_cursor_lossy()) {
+        // A document scored both before and after the cursor was taken out of a full topster, so a hit turned away
+        // earlier could belong on the page. With room for every skipped document, none can be crowded out.
+        max_hits = per_page + search_params->topster->num_cursor_skipped();
+        delete search_params;
+
+        // facets can't be assigned, since their field name is const
+        facets.clear();
+        for(const facet& a_facet: requested_facets) {
+            facets.push_back(a_facet);
+        }
+        search_params = create_search_params(max_hits);
+        index->run_search(search_params);
+    }
+
     // for grouping we have to re-aggregate
 
     Topster& topster = *search_params->topster;
@@ -1114,7 +1209,7 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
         total_found = search_params->all_result_ids_len;
     }
 
-    if(match_score_index >= 0 && sort_fields_std[match_score_index].text_match_buckets > 1) {
+    if(text_match_bucketed) {
         size_t num_buckets = sort_fields_std[match_score_index].text_match_buckets;
 
         const size_t max_kvs_bucketed = std::min<size_t>(DEFAULT_TOPSTER_SIZE, raw_result_kvs.size());
@@ -1234,6 +1329,19 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
         index_symbols[uint8_t(c)] = 1;
     }
 
+    // fetch the documents of all the hits on the page in a single batch
+    std::vector<std::string> hit_seq_id_keys;
+    for(long result_kvs_index = start_result_index; result_kvs_index <= end_result_index; result_kvs_index++) {
+        for(const KV* field_order_kv: result_group_kvs[result_kvs_index]) {
+            hit_seq_id_keys.push_back(get_seq_id_key((uint32_t) field_order_kv->key));
+        }
+    }
+
+    std::vector<nlohmann::json> hit_documents;
+    std::vector<Option<bool>> hit_document_ops;
+    get_documents_from_store(hit_seq_id_keys, hit_documents, hit_document_ops);
+    size_t hit_index = 0;
+
     // construct results array
     for(long result_kvs_index = start_result_index; result_kvs_index <= end_result_index; result_kvs_index++) {
         const std::vector<KV*> & kv_group = result_group_kvs[result_kvs_index];
@@ -1246,10 +1354,9 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
         nlohmann::json& hits_array = group_limit ? group_hits["hits"] : result["hits"];
 
         for(const KV* field_order_kv: kv_group) {
-            const std::string& seq_id_key = get_seq_id_key((uint32_t) field_order_kv->key);
-
-            nlohmann::json document;
-            const Option<bool> & document_op = get_document_from_store(seq_id_key, document);
+            nlohmann::json& document = hit_documents[hit_index];
+            const Option<bool> & document_op = hit_document_ops[hit_index];
+            hit_index++;
 
             if(!document_op.ok()) {
                 LOG(ERROR) << "Document fetch error. " << document_op.error();
@@ -1356,6 +1463,27 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
         facet_result["field_name"] = a_facet.field_name;
         facet_result["counts"] = nlohmann::json::array();
 
+        if(a_facet.sampled) {
+            facet_result["sampled"] = true;
+            facet_result["sample_size"] = a_facet.sample_size;
+        }
+
+        if(a_facet.is_range_facet()) {
+            // ranges are returned in the order they were requested, including the empty ones
+            for(size_t ri = 0; ri < a_facet.ranges.size(); ri++) {
+                nlohmann::json facet_value_count = nlohmann::json::object();
+                facet_value_count["value"] = a_facet.ranges[ri].label;
+                facet_value_count["highlighted"] = a_facet.ranges[ri].label;
+                facet_value_count["count"] = (ri < a_facet.range_counts.size()) ? a_facet.range_counts[ri] : 0;
+                facet_result["counts"].push_back(facet_value_count);
+            }
+
+            facet_result["stats"] = nlohmann::json::object();
+            facet_result["stats"]["total_values"] = a_facet.ranges.size();
+            result["facet_counts"].push_back(facet_result);
+            continue;
+        }
+
         std::vector<std::pair<int64_t, facet_count_t>> facet_hash_counts;
         for (const auto & kv : a_facet.result_map) {
             facet_hash_counts.emplace_back(kv);
@@ -1370,27 +1498,27 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
 
         std::vector<facet_value_t> facet_values;
 
+        // remap facet value hashes with actual strings
+        std::vector<uint64_t> top_facet_hashes;
+        for(size_t fi = 0; fi < max_facets; fi++) {
+            top_facet_hashes.push_back(facet_hash_counts[fi].first);
+        }
+
+        std::unordered_map<uint64_t, std::string> indexed_facet_values;
+        index->get_facet_values(a_facet.field_name, top_facet_hashes, indexed_facet_values);
+
         for(size_t fi = 0; fi < max_facets; fi++) {
-            // remap facet value hash with actual string
             auto & kv = facet_hash_counts[fi];
             auto & facet_count = kv.second;
 
-            // fetch actual facet value from representative doc id
-            const std::string& seq_id_key = get_seq_id_key((uint32_t) facet_count.doc_id);
-            nlohmann::json document;
-            const Option<bool> & document_op = get_document_from_store(seq_id_key, document);
-
-            if(!document_op.ok()) {
-                LOG(ERROR) << "Facet fetch error. " << document_op.error();
+            const auto indexed_value_it = indexed_facet_values.find(kv.first);
+            if(indexed_value_it == indexed_facet_values.end()) {
+                // value has been removed from all documents since it was counted
                 continue;
             }
 
             std::string value;
-            bool facet_found = facet_value_to_string(a_facet, facet_count, document, value);
-
-            if(!facet_found) {
-                continue;
-            }
+            facet_value_to_string(a_facet, indexed_value_it->second, value);
 
             std::unordered_map<std::string, size_t> ftoken_pos;
             std::vector<string>& ftokens = a_facet.hash_tokens[kv.first];
@@ -1507,10 +1635,37 @@ Option<nlohmann::json> Collection::search(const std::string & raw_query, const s
         result["facet_counts"].push_back(facet_result);
     }
 
+    if(explain_filter && !filters.empty()) {
+        result["filter_plan"] = nlohmann::json::array();
+
+        for(const auto& clause_plan: search_params->filter_plan) {
+            nlohmann::json clause_json;
+            clause_json["field"] = clause_plan.field_name;
+            clause_json["estimated_ids"] = clause_plan.estimated_ids;
+            clause_json["strategy"] = (clause_plan.strategy == filter_strategy_t::scan) ? "scan" :
+                                      (clause_plan.strategy == filter_strategy_t::verify) ? "verify" :
+                                                                                            "materialize";
+            result["filter_plan"].push_back(clause_json);
+        }
+    }
+
     // free search params
     delete search_params;
 
+    // a full page could be followed by more hits: cursor of its last hit that is ordered by its scores
+    if(group_limit == 0 && !text_match_bucketed && per_page != 0 &&
+       end_result_index - start_result_index + 1 == long(per_page)) {
+        for(long result_kvs_index = end_result_index; result_kvs_index >= start_result_index; result_kvs_index--) {
+            const KV* kv = result_group_kvs[result_kvs_index][0];
+            if(kv->match_score_index != CURATED_RECORD_IDENTIFIER) {
+                result["search_after"] = get_search_after_cursor(kv);
+                break;
+            }
+        }
+    }
+
     result["search_cutoff"] = search_cutoff;
+    result["blocks_skipped"] = search_blocks_skipped;
 
     result["request_params"] = nlohmann::json::object();;
     result["request_params"]["collection_name"] = name;
@@ -1764,67 +1919,120 @@ Option<bool> Collection::get_filter_ids(const std::string & simple_filter_query,
     return Option<bool>(true);
 }
 
-bool Collection::facet_value_to_string(const facet &a_facet, const facet_count_t &facet_count,
-                                       const nlohmann::json &document, std::string &value) const {
+Option<bool> Collection::parse_range_facet(const std::string& facet_str, std::vector<facet>& facets) const {
+    const size_t paren_pos = facet_str.find('(');
+
+    if(facet_str.back() != ')') {
+        return Option<bool>(400, "Range facet `" + facet_str + "` must be in the `field(start..end, ...)` format.");
+    }
+
+    std::string field_name = facet_str.substr(0, paren_pos);
+    StringUtils::trim(field_name);
 
-    if(document.count(a_facet.field_name) == 0) {
-        // check for field exists
-        if(search_schema.at(a_facet.field_name).optional) {
+    if(search_schema.count(field_name) == 0 || !search_schema.at(field_name).facet) {
+        std::string error = "Could not find a facet field named `" + field_name + "` in the schema.";
+        return Option<bool>(404, error);
+    }
+
+    const field& the_field = search_schema.at(field_name);
+
+    if(!the_field.is_integer() && !the_field.is_float()) {
+        return Option<bool>(400, "Range facet field `" + field_name + "` must be an integer or a float field.");
+    }
+
+    // bounds are encoded the same way as the values of the field in the numerical index
+    auto parse_bound = [&the_field](const std::string& bound_str, int64_t& bound) -> bool {
+        if(the_field.is_integer()) {
+            if(!StringUtils::is_int64_t(bound_str)) {
+                return false;
+            }
+
+            bound = std::stoll(bound_str);
+            return true;
+        }
+
+        if(!StringUtils::is_float(bound_str)) {
             return false;
         }
 
-        LOG(ERROR) << "Could not find field " << a_facet.field_name << " in document during faceting.";
-        LOG(ERROR) << "Facet field type: " << search_schema.at(a_facet.field_name).type;
-        LOG(ERROR) << "Actual document: " << document;
-        return false;
+        bound = Index::float_to_in64_t(std::stof(bound_str));
+        return true;
+    };
+
+    std::vector<std::string> range_strs;
+    StringUtils::split(facet_str.substr(paren_pos + 1, facet_str.size() - paren_pos - 2), range_strs, ",");
+
+    if(range_strs.empty()) {
+        return Option<bool>(400, "Range facet `" + facet_str + "` must be in the `field(start..end, ...)` format.");
     }
 
-    if(search_schema.at(a_facet.field_name).is_array()) {
-        size_t array_sz = document[a_facet.field_name].size();
-        if(facet_count.array_pos >= array_sz) {
-            LOG(ERROR) << "Facet field array size " << array_sz << " lesser than array pos " <<  facet_count.array_pos
-                       << " for facet field " << a_facet.field_name;
-            LOG(ERROR) << "Facet field type: " << search_schema.at(a_facet.field_name).type;
-            LOG(ERROR) << "Actual document: " << document;
-            return false;
+    std::vector<facet_range_t> ranges;
+
+    for(const std::string& range_str: range_strs) {
+        const size_t dots_pos = range_str.find("..");
+        if(dots_pos == std::string::npos) {
+            return Option<bool>(400, "Range `" + range_str + "` of facet `" + field_name +
+                                     "` must be in the `start..end` format.");
+        }
+
+        std::string start_str = range_str.substr(0, dots_pos);
+        std::string end_str = range_str.substr(dots_pos + 2);
+        StringUtils::trim(start_str);
+        StringUtils::trim(end_str);
+
+        facet_range_t range;
+        range.label = range_str;
+
+        int64_t bound;
+
+        if(!start_str.empty()) {
+            if(!parse_bound(start_str, bound)) {
+                return Option<bool>(400, "Range `" + range_str + "` of facet `" + field_name +
+                                         "` has an invalid start value.");
+            }
+
+            range.start = bound;
+        }
+
+        if(!end_str.empty()) {
+            if(!parse_bound(end_str, bound)) {
+                return Option<bool>(400, "Range `" + range_str + "` of facet `" + field_name +
+                                         "` has an invalid end value.");
+            }
+
+            // end of a range is exclusive
+            if(bound == INT64_MIN) {
+                return Option<bool>(400, "Range `" + range_str + "` of facet `" + field_name + "` is empty.");
+            }
+
+            range.end = bound - 1;
+        }
+
+        if(range.start > range.end) {
+            return Option<bool>(400, "Range `" + range_str + "` of facet `" + field_name + "` is empty.");
         }
+
+        ranges.push_back(range);
     }
 
-    if(search_schema.at(a_facet.field_name).type == field_types::STRING) {
-        value =  document[a_facet.field_name];
-    } else if(search_schema.at(a_facet.field_name).type == field_types::STRING_ARRAY) {
-        value = document[a_facet.field_name][facet_count.array_pos];
-    } else if(search_schema.at(a_facet.field_name).type == field_types::INT32) {
-        int32_t raw_val = document[a_facet.field_name].get<int32_t>();
-        value = std::to_string(raw_val);
-    } else if(search_schema.at(a_facet.field_name).type == field_types::INT32_ARRAY) {
-        int32_t raw_val = document[a_facet.field_name][facet_count.array_pos].get<int32_t>();
-        value = std::to_string(raw_val);
-    } else if(search_schema.at(a_facet.field_name).type == field_types::INT64) {
-        int64_t raw_val = document[a_facet.field_name].get<int64_t>();
-        value = std::to_string(raw_val);
-    } else if(search_schema.at(a_facet.field_name).type == field_types::INT64_ARRAY) {
-        int64_t raw_val = document[a_facet.field_name][facet_count.array_pos].get<int64_t>();
-        value = std::to_string(raw_val);
-    } else if(search_schema.at(a_facet.field_name).type == field_types::FLOAT) {
-        float raw_val = document[a_facet.field_name].get<float>();
-        value = StringUtils::float_to_str(raw_val);
+    facets.emplace_back(field_name, ranges);
+    return Option<bool>(true);
+}
+
+void Collection::facet_value_to_string(const facet &a_facet, const std::string& indexed_value,
+                                       std::string &value) const {
+    const std::string& field_type = search_schema.at(a_facet.field_name).type;
+    value = indexed_value;
+
+    if(field_type == field_types::FLOAT) {
         if(value != "0") {
             value.erase ( value.find_last_not_of('0') + 1, std::string::npos ); // remove trailing zeros
         }
-    } else if(search_schema.at(a_facet.field_name).type == field_types::FLOAT_ARRAY) {
-        float raw_val = document[a_facet.field_name][facet_count.array_pos].get<float>();
-        value = StringUtils::float_to_str(raw_val);
+    } else if(field_type == field_types::FLOAT_ARRAY) {
         value.erase ( value.find_last_not_of('0') + 1, std::string::npos );  // remove trailing zeros
-    } else if(search_schema.at(a_facet.field_name).type == field_types::BOOL) {
-        value = std::to_string(document[a_facet.field_name].get<bool>());
-        value = (value == "1") ? "true" : "false";
-    } else if(search_schema.at(a_facet.field_name).type == field_types::BOOL_ARRAY) {
-        value = std::to_string(document[a_facet.field_name][facet_count.array_pos].get<bool>());
+    } else if(field_type == field_types::BOOL || field_type == field_types::BOOL_ARRAY) {
         value = (value == "1") ? "true" : "false";
     }
-
-    return true;
 }
 
 void Collection::highlight_result(const std::string& raw_query, const field &search_field,
@@ -2354,6 +2562,14 @@ size_t Collection::get_num_documents() const {
     return num_documents.load();
 }
 
+void Collection::get_filter_cache_stats(filter_cache_stats_t& stats) const {
+    index->get_filter_cache_stats(stats);
+}
+
+void Collection::get_fuzzy_cache_stats(fuzzy_cache_stats_t& stats) const {
+    index->get_fuzzy_cache_stats(stats);
+}
+
 uint32_t Collection::get_collection_id() const {
     return collection_id.load();
 }
@@ -2466,6 +2682,37 @@ Option<bool> Collection::get_document_from_store(const std::string &seq_id_key,
     return Option<bool>(true);
 }
 
+void Collection::get_documents_from_store(const std::vector<std::string>& seq_id_keys,
+                                          std::vector<nlohmann::json>& documents,
+                                          std::vector<Option<bool>>& document_ops) const {
+    std::vector<std::string> json_doc_strs;
+    std::vector<StoreStatus> json_doc_statuses;
+    store->multi_get(seq_id_keys, json_doc_strs, json_doc_statuses);
+
+    documents.clear();
+    documents.resize(seq_id_keys.size());
+    document_ops.clear();
+    document_ops.reserve(seq_id_keys.size());
+
+    for(size_t i = 0; i < seq_id_keys.size(); i++) {
+        if(json_doc_statuses[i] != StoreStatus::FOUND) {
+            const std::string& seq_id = std::to_string(get_seq_id_from_key(seq_id_keys[i]));
+            document_ops.emplace_back(500, "Could not locate the JSON document for sequence ID: " + seq_id);
+            continue;
+        }
+
+        try {
+            documents[i] = nlohmann::json::parse(json_doc_strs[i]);
+        } catch(...) {
+            const std::string& seq_id = std::to_string(get_seq_id_from_key(seq_id_keys[i]));
+            document_ops.emplace_back(500, "Error while parsing stored document with sequence ID: " + seq_id);
+            continue;
+        }
+
+        document_ops.emplace_back(true);
+    }
+}
+
 const Index* Collection::_get_index() const {
     return index;
 }
@@ -2506,6 +2753,41 @@ Option<bool> Collection::parse_pinned_hits(const std::string& pinned_hits_str,
     return Option<bool>(true);
 }
 
+std::string Collection::get_search_after_cursor(const KV* kv) {
+    const std::string cursor = std::to_string(kv->scores[0]) + "," + std::to_string(kv->scores[1]) + "," +
+                               std::to_string(kv->scores[2]) + "," + std::to_string(kv->key);
+
+    // url safe alphabet, since the cursor is sent back as a query parameter
+    std::string encoded_cursor = StringUtils::base64_encode(cursor);
+    std::replace(encoded_cursor.begin(), encoded_cursor.end(), '+', '-');
+    std::replace(encoded_cursor.begin(), encoded_cursor.end(), '/', '_');
+
+    return encoded_cursor;
+}
+
+Option<bool> Collection::parse_search_after_cursor(const std::string& search_after, int64_t* scores,
+                                                   uint64_t& key) {
+    std::string encoded_cursor = search_after;
+    std::replace(encoded_cursor.begin(), encoded_cursor.end(), '-', '+');
+    std::replace(encoded_cursor.begin(), encoded_cursor.end(), '_', '/');
+
+    std::vector<std::string> cursor_parts;
+    StringUtils::split(StringUtils::base64_decode(encoded_cursor), cursor_parts, ",");
+
+    if(cursor_parts.size() != 4 || !StringUtils::is_int64_t(cursor_parts[0]) ||
+       !StringUtils::is_int64_t(cursor_parts[1]) || !StringUtils::is_int64_t(cursor_parts[2]) ||
+       !StringUtils::is_uint32_t(cursor_parts[3])) {
+        return Option<bool>(400, "Value of `search_after` is not a valid cursor.");
+    }
+
+    for(size_t i = 0; i < 3; i++) {
+        scores[i] = std::stoll(cursor_parts[i]);
+    }
+
+    key = std::stoul(cursor_parts[3]);
+    return Option<bool>(true);
+}
+
 Option<bool> Collection::add_synonym(const synonym_t& synonym) {
     std::shared_lock lock(mutex);
     return synonym_index->add_synonym(name, synonym);
@@ -53,6 +53,8 @@ Collection* CollectionManager::init_collection(const nlohmann::json & collection
             f.sort = field_obj[fields::sort];
         }
 
+        f.presorted = (field_obj.count(fields::sort_index) != 0 && field_obj[fields::sort_index] == fields::presorted);
+
         fields.push_back(f);
     }
 
@@ -601,6 +603,8 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
     const char *FACET_QUERY = "facet_query";
     const char *FACET_QUERY_NUM_TYPOS = "facet_query_num_typos";
     const char *MAX_FACET_VALUES = "max_facet_values";
+    const char *FACET_SAMPLE_PERCENT = "facet_sample_percent";
+    const char *FACET_SAMPLE_THRESHOLD = "facet_sample_threshold";
 
     const char *GROUP_BY = "group_by";
     const char *GROUP_LIMIT = "group_limit";
@@ -608,6 +612,8 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
     const char *LIMIT_HITS = "limit_hits";
     const char *PER_PAGE = "per_page";
     const char *PAGE = "page";
+    const char *SEARCH_AFTER = "search_after";
+    const char *TYPEAHEAD_SESSION = "typeahead_session";
     const char *RANK_TOKENS_BY = "rank_tokens_by";
     const char *INCLUDE_FIELDS = "include_fields";
     const char *EXCLUDE_FIELDS = "exclude_fields";
@@ -643,6 +649,9 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
     const char *EXHAUSTIVE_SEARCH = "exhaustive_search";
     const char *SPLIT_JOIN_TOKENS = "split_join_tokens";
 
+    // reports the order in which the filter clauses were evaluated
+    const char *EXPLAIN_FILTER = "explain_filter";
+
     // enrich params with values from embedded params
     for(auto& item: embedded_params.items()) {
         if(item.key() == "expires_at") {
@@ -691,6 +700,8 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
     spp::sparse_hash_set<std::string> exclude_fields;
 
     size_t max_facet_values = 10;
+    size_t facet_sample_percent = 100;
+    size_t facet_sample_threshold = 0;
     std::string simple_facet_query;
     size_t facet_query_num_typos = 2;
     size_t snippet_threshold = 30;
@@ -698,6 +709,8 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
     std::string highlight_full_fields;
     std::string pinned_hits_str;
     std::string hidden_hits_str;
+    std::string search_after;
+    std::string typeahead_session;
     std::vector<std::string> group_by_fields;
     size_t group_limit = 3;
     std::string highlight_start_tag = "<mark>";
@@ -712,6 +725,7 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
     bool exhaustive_search = false;
     size_t search_cutoff_ms = 3600000;
     bool split_join_tokens = true;
+    bool explain_filter = false;
     size_t max_candidates = 0;
     std::vector<infix_t> infixes;
     size_t max_extra_prefix = INT16_MAX;
@@ -723,6 +737,8 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
         {DROP_TOKENS_THRESHOLD, &drop_tokens_threshold},
         {TYPO_TOKENS_THRESHOLD, &typo_tokens_threshold},
         {MAX_FACET_VALUES, &max_facet_values},
+        {FACET_SAMPLE_PERCENT, &facet_sample_percent},
+        {FACET_SAMPLE_THRESHOLD, &facet_sample_threshold},
         {LIMIT_HITS, &limit_hits},
         {SNIPPET_THRESHOLD, &snippet_threshold},
         {HIGHLIGHT_AFFIX_NUM_TOKENS, &highlight_affix_num_tokens},
@@ -746,6 +762,8 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
         {HIGHLIGHT_END_TAG, &highlight_end_tag},
         {PINNED_HITS, &pinned_hits_str},
         {HIDDEN_HITS, &hidden_hits_str},
+        {SEARCH_AFTER, &search_after},
+        {TYPEAHEAD_SESSION, &typeahead_session},
     };
 
     std::unordered_map<std::string, bool*> bool_values = {
@@ -754,11 +772,11 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
         {EXHAUSTIVE_SEARCH, &exhaustive_search},
         {SPLIT_JOIN_TOKENS, &split_join_tokens},
         {ENABLE_OVERRIDES, &enable_overrides},
+        {EXPLAIN_FILTER, &explain_filter},
     };
 
     std::unordered_map<std::string, std::vector<std::string>*> str_list_values = {
         {QUERY_BY, &search_fields},
-        {FACET_BY, &facet_fields},
         {GROUP_BY, &group_by_fields},
         {INCLUDE_FIELDS, &include_fields_vec},
         {EXCLUDE_FIELDS, &exclude_fields_vec},
@@ -786,6 +804,10 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
             }
         }
 
+        else if(key == FACET_BY) {
+            StringUtils::split_facet(val, facet_fields);
+        }
+
         else {
             auto find_int_it = unsigned_int_values.find(key);
             if(find_int_it != unsigned_int_values.end()) {
@@ -903,7 +925,12 @@ Option<bool> CollectionManager::do_search(std::map<std::string, std::string>& re
                                                           max_extra_prefix,
                                                           max_extra_suffix,
                                                           facet_query_num_typos,
-                                                          filter_curated_hits_option
+                                                          filter_curated_hits_option,
+                                                          facet_sample_percent,
+                                                          facet_sample_threshold,
+                                                          search_after,
+                                                          typeahead_session,
+                                                          explain_filter
                                                         );
 
     uint64_t timeMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -948,6 +975,45 @@ nlohmann::json CollectionManager::get_collection_summaries() const {
     return json_summaries;
 }
 
+nlohmann::json CollectionManager::get_filter_cache_stats() const {
+    std::shared_lock lock(mutex);
+
+    filter_cache_stats_t stats;
+
+    for(Collection* collection: get_collections()) {
+        collection->get_filter_cache_stats(stats);
+    }
+
+    nlohmann::json stats_json;
+    stats_json["hits"] = stats.hits;
+    stats_json["misses"] = stats.misses;
+    stats_json["num_entries"] = stats.num_entries;
+    stats_json["memory_used_bytes"] = stats.memory_used_bytes;
+
+    return stats_json;
+}
+
+nlohmann::json CollectionManager::get_fuzzy_cache_stats() const {
+    std::shared_lock lock(mutex);
+
+    fuzzy_cache_stats_t stats;
+
+    for(Collection* collection: get_collections()) {
+        collection->get_fuzzy_cache_stats(stats);
+    }
+
+    const size_t num_lookups = stats.hits + stats.misses;
+
+    nlohmann::json stats_json;
+    stats_json["hits"] = stats.hits;
+    stats_json["misses"] = stats.misses;
+    stats_json["hit_rate"] = (num_lookups == 0) ? 0.0 : double(stats.hits) / num_lookups;
+    stats_json["num_entries"] = stats.num_entries;
+    stats_json["memory_used_bytes"] = stats.memory_used_bytes;
+
+    return stats_json;
+}
+
 Option<Collection*> CollectionManager::create_collection(nlohmann::json& req_json) {
     const char* NUM_MEMORY_SHARDS = "num_memory_shards";
     const char* SYMBOLS_TO_INDEX = "symbols_to_index";
@@ -277,6 +277,8 @@ bool get_stats_json(const std::shared_ptr<http_req>& req, const std::shared_ptr<
     nlohmann::json result;
     AppMetrics::get_instance().get("requests_per_second", "latency_ms", result);
     result["pending_write_batches"] = server->get_num_queued_writes();
+    result["filter_cache"] = CollectionManager::get_instance().get_filter_cache_stats();
+    result["fuzzy_cache"] = CollectionManager::get_instance().get_fuzzy_cache_stats();
 
     res->set_body(200, result.dump(2));
     return true;
@@ -393,6 +395,88 @@ bool get_search(const std::shared_ptr<http_req>& req, const std::shared_ptr<http
     return true;
 }
 
+struct multi_search_state_t {
+    std::vector<std::map<std::string, std::string>> search_req_params;
+    std::vector<nlohmann::json> embedded_params_vec;
+    std::vector<nlohmann::json> search_results;
+    size_t num_searches = 0;
+
+    std::atomic<size_t> next_search{0};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t num_searches_done = 0;
+};
+
+static void run_pending_multi_searches(const std::shared_ptr<multi_search_state_t>& state) {
+    const size_t num_searches = state->num_searches;
+    size_t i;
+
+    while((i = state->next_search++) < num_searches) {
+        nlohmann::json& search_result = state->search_results[i];
+        auto begin = std::chrono::high_resolution_clock::now();
+
+        try {
+            std::string results_json_str;
+            Option<bool> search_op = CollectionManager::do_search(state->search_req_params[i],
+                                                                  state->embedded_params_vec[i],
+                                                                  results_json_str);
+
+            if(search_op.ok()) {
+                search_result = nlohmann::json::parse(results_json_str);
+            } else {
+                search_result["error"] = search_op.error();
+                search_result["code"] = search_op.code();
+            }
+        } catch(const std::exception& e) {
+            LOG(ERROR) << "Multi search error: " << e.what();
+            search_result["error"] = "Search failed.";
+            search_result["code"] = 500;
+        }
+
+        if(search_result.count("error") != 0) {
+            // successful results carry their own `search_time_ms` unless it has been excluded
+            search_result["search_time_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::high_resolution_clock::now() - begin).count();
+        }
+
+        std::unique_lock lock(state->mutex);
+        state->num_searches_done++;
+        state->cv.notify_one();
+    }
+}
+
+void run_multi_searches(std::vector<std::map<std::string, std::string>>& search_req_params,
+                        const std::vector<nlohmann::json>& embedded_params_vec,
+                        ThreadPool* thread_pool, const size_t concurrency,
+                        std::vector<nlohmann::json>& search_results) {
+    // helpers that are dequeued only after the last search completes still hold on to the state
+    auto state = std::make_shared<multi_search_state_t>();
+    state->search_req_params = std::move(search_req_params);
+    state->embedded_params_vec = embedded_params_vec;
+    state->num_searches = state->search_req_params.size();
+    state->search_results.resize(state->num_searches);
+
+    const size_t num_searches = state->num_searches;
+    const size_t num_helpers = std::min(concurrency, num_searches);
+
+    for(size_t i = 1; thread_pool != nullptr && i < num_helpers; i++) {
+        thread_pool->enqueue([state]() {
+            run_pending_multi_searches(state);
+        });
+    }
+
+    run_pending_multi_searches(state);
+
+    std::unique_lock lock(state->mutex);
+    state->cv.wait(lock, [&state, num_searches]() {
+        return state->num_searches_done == num_searches;
+    });
+
+    search_req_params = std::move(state->search_req_params);
+    search_results = std::move(state->search_results);
+}
+
 bool post_multi_search(const std::shared_ptr<http_req>& req, const std::shared_ptr<http_res>& res) {
     const auto use_cache_it = req->params.find("use_cache");
     bool use_cache = (use_cache_it != req->params.end()) && (use_cache_it->second == "1" || use_cache_it->second == "true");
@@ -484,6 +568,9 @@ bool post_multi_search(const std::shared_ptr<http_req>& req, const std::shared_p
         return false;
     }
 
+    // parameters of all the searches are prepared upfront, so that a malformed search is rejected before any runs
+    std::vector<std::map<std::string, std::string>> all_search_req_params(searches.size());
+
     for(size_t i = 0; i < searches.size(); i++) {
         auto& search_params = searches[i];
 
@@ -492,7 +579,8 @@ bool post_multi_search(const std::shared_ptr<http_req>& req, const std::shared_p
             return false;
         }
 
-        req->params = orig_req_params;
+        auto& search_req_params = all_search_req_params[i];
+        search_req_params = orig_req_params;
 
         for(auto& search_item: search_params.items()) {
             if(search_item.key() == "cache_ttl") {
@@ -501,24 +589,25 @@ bool post_multi_search(const std::shared_ptr<http_req>& req, const std::shared_p
             }
 
             // overwrite = false since req params will contain embedded params and so has higher priority
-            bool populated = AuthManager::add_item_to_params(req->params, search_item, false);
+            bool populated = AuthManager::add_item_to_params(search_req_params, search_item, false);
             if(!populated) {
                 res->set_400("One or more search parameters are malformed.");
                 return false;
             }
         }
+    }
 
-        std::string results_json_str;
-        Option<bool> search_op = CollectionManager::do_search(req->params, req->embedded_params_vec[i], results_json_str);
+    std::vector<nlohmann::json> search_results;
+    run_multi_searches(all_search_req_params, req->embedded_params_vec,
+                       (server == nullptr) ? nullptr : server->get_thread_pool(),
+                       Config::get_instance().get_multi_search_concurrency(), search_results);
 
-        if(search_op.ok()) {
-            response["results"].push_back(nlohmann::json::parse(results_json_str));
-        } else {
-            nlohmann::json err_res;
-            err_res["error"] = search_op.error();
-            err_res["code"] = search_op.code();
-            response["results"].push_back(err_res);
-        }
+    for(auto& search_result: search_results) {
+        response["results"].push_back(std::move(search_result));
+    }
+
+    if(!all_search_req_params.empty()) {
+        req->params = all_search_req_params.back();
     }
 
     res->set_200(response.dump());
@@ -0,0 +1,148 @@
+#include "facet_index.h"
+
+facet_index_t::~facet_index_t() {
+    for(chunk_t* chunk: chunks) {
+        delete chunk;
+    }
+
+    chunks.clear();
+}
+
+uint32_t facet_index_t::acquire_ordinal(const uint64_t hash, const std::string& value) {
+    const auto it = hash_ordinals.find(hash);
+    if(it != hash_ordinals.end()) {
+        // like the sample document facet results used to be rendered from, the latest document represents the value
+        ordinal_values[it->second] = value;
+        ordinal_refs[it->second]++;
+        return it->second;
+    }
+
+    uint32_t ordinal;
+
+    if(!free_ordinals.empty()) {
+        ordinal = free_ordinals.back();
+        free_ordinals.pop_back();
+        ordinal_hashes[ordinal] = hash;
+        ordinal_values[ordinal] = value;
+        ordinal_refs[ordinal] = 1;
+    } else {
+        ordinal = ordinal_hashes.size();
+        ordinal_hashes.push_back(hash);
+        ordinal_values.push_back(value);
+        ordinal_refs.push_back(1);
+    }
+
+    hash_ordinals.emplace(hash, ordinal);
+    return ordinal;
+}
+
+void facet_index_t::release_ordinal(const uint32_t ordinal) {
+    if(--ordinal_refs[ordinal] != 0) {
+        return ;
+    }
+
+    hash_ordinals.erase(ordinal_hashes[ordinal]);
+    ordinal_hashes[ordinal] = 0;
+    std::string().swap(ordinal_values[ordinal]);
+    free_ordinals.push_back(ordinal);
+}
+
+void facet_index_t::upsert(const uint32_t seq_id, const std::vector<uint64_t>& hashes,
+                           const std::vector<std::string>& values) {
+    // acquire before releasing the old values so that unchanged values keep their ordinals
+    std::vector<uint32_t> new_ordinals;
+    new_ordinals.reserve(hashes.size());
+
+    for(size_t i = 0; i < hashes.size(); i++) {
+        new_ordinals.push_back(acquire_ordinal(hashes[i], values[i]));
+    }
+
+    erase(seq_id);
+
+    const size_t chunk_index = seq_id / CHUNK_SIZE;
+    if(chunk_index >= chunks.size()) {
+        chunks.resize(chunk_index + 1, nullptr);
+    }
+
+    if(chunks[chunk_index] == nullptr) {
+        chunks[chunk_index] = new chunk_t;
+    }
+
+    chunk_t* chunk = chunks[chunk_index];
+    const size_t offset = seq_id % CHUNK_SIZE;
+    const uint32_t start = chunk->offsets[offset];
+
+    chunk->ordinals.insert(chunk->ordinals.begin() + start, new_ordinals.begin(), new_ordinals.end());
+
+    for(size_t i = offset + 1; i <= CHUNK_SIZE; i++) {
+        chunk->offsets[i] += new_ordinals.size();
+    }
+
+    chunk->present[offset / 64] |= (1ULL << (offset % 64));
+    chunk->num_docs++;
+    total_docs++;
+}
+
+void facet_index_t::erase(const uint32_t seq_id) {
+    const size_t chunk_index = seq_id / CHUNK_SIZE;
+    if(chunk_index >= chunks.size() || chunks[chunk_index] == nullptr) {
+        return ;
+    }
+
+    chunk_t* chunk = chunks[chunk_index];
+    const size_t offset = seq_id % CHUNK_SIZE;
+    const uint64_t bit = (1ULL << (offset % 64));
+
+    if((chunk->present[offset / 64] & bit) == 0) {
+        return ;
+    }
+
+    chunk->present[offset / 64] &= ~bit;
+    total_docs--;
+
+    const uint32_t start = chunk->offsets[offset];
+    const uint32_t num_values = chunk->offsets[offset + 1] - start;
+
+    for(size_t i = start; i < start + num_values; i++) {
+        release_ordinal(chunk->ordinals[i]);
+    }
+
+    chunk->ordinals.erase(chunk->ordinals.begin() + start, chunk->ordinals.begin() + start + num_values);
+
+    for(size_t i = offset + 1; i <= CHUNK_SIZE; i++) {
+        chunk->offsets[i] -= num_values;
+    }
+
+    if(--chunk->num_docs == 0) {
+        delete chunk;
+        chunks[chunk_index] = nullptr;
+    }
+}
+
+bool facet_index_t::get_value(const uint64_t hash, std::string& value) const {
+    const auto it = hash_ordinals.find(hash);
+    if(it == hash_ordinals.end()) {
+        return false;
+    }
+
+    value = ordinal_values[it->second];
+    return true;
+}
+
+bool facet_index_t::contains(const uint32_t seq_id) const {
+    const size_t chunk_index = seq_id / CHUNK_SIZE;
+    if(chunk_index >= chunks.size() || chunks[chunk_index] == nullptr) {
+        return false;
+    }
+
+    const size_t offset = seq_id % CHUNK_SIZE;
+    return (chunks[chunk_index]->present[offset / 64] & (1ULL << (offset % 64))) != 0;
+}
+
+size_t facet_index_t::num_values() const {
+    return hash_ordinals.size();
+}
+
+size_t facet_index_t::num_docs() const {
+    return total_docs;
+}
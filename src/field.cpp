@@ -417,6 +417,29 @@ Option<bool> field::json_field_to_field(nlohmann::json& field_json, std::vector<
                                  field_json[fields::name].get<std::string>() + std::string("` should be a boolean."));
     }
 
+    if(field_json.count(fields::sort_index) != 0) {
+        if(!field_json.at(fields::sort_index).is_string() ||
+           field_json.at(fields::sort_index).get<std::string>() != fields::presorted) {
+            return Option<bool>(400, std::string("The `sort_index` property of the field `") +
+                                     field_json[fields::name].get<std::string>() +
+                                     std::string("` should be `") + fields::presorted + "`.");
+        }
+
+        const std::string& field_type = field_json[fields::type];
+        if(field_type != field_types::INT32 && field_type != field_types::INT64 &&
+           field_type != field_types::FLOAT && field_type != field_types::BOOL) {
+            return Option<bool>(400, std::string("The `sort_index` property of the field `") +
+                                     field_json[fields::name].get<std::string>() +
+                                     std::string("` is only supported for single valued numerical fields."));
+        }
+
+        if(field_json.count(fields::sort) != 0 && !field_json[fields::sort].get<bool>()) {
+            return Option<bool>(400, std::string("The `sort_index` property of the field `") +
+                                     field_json[fields::name].get<std::string>() +
+                                     std::string("` requires the field to be sortable."));
+        }
+    }
+
     if(field_json.count(fields::locale) != 0){
         if(!field_json.at(fields::locale).is_string()) {
             return Option<bool>(400, std::string("The `locale` property of the field `") +
@@ -520,5 +543,7 @@ Option<bool> field::json_field_to_field(nlohmann::json& field_json, std::vector<
                   field_json[fields::sort], field_json[fields::infix])
     );
 
+    the_fields.back().presorted = (field_json.count(fields::sort_index) != 0);
+
     return Option<bool>(true);
 }
@@ -0,0 +1,192 @@
+#include "filter_iterator.h"
+#include <algorithm>
+
+void filter_iterator_t::to_vector(std::vector<uint32_t>& ids) {
+    while(valid()) {
+        ids.push_back(id());
+        next();
+    }
+}
+
+/* leaf */
+
+filter_leaf_iterator_t::filter_leaf_iterator_t(materializer_t materializer, checker_t checker,
+                                               const size_t estimated_ids, const size_t check_cost):
+                                               materializer(std::move(materializer)), checker(std::move(checker)),
+                                               estimated_ids(estimated_ids), check_cost(check_cost) {
+    use_checker = bool(this->checker);
+}
+
+filter_leaf_iterator_t::filter_leaf_iterator_t(std::shared_ptr<const id_bitmap_t> ids):
+                                               estimated_ids(ids->cardinality()), check_cost(1), use_checker(false),
+                                               materialized(true), bitmap(std::move(ids)) {
+
+}
+
+void filter_leaf_iterator_t::materialize() {
+    if(materialized.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // IDs can be checked concurrently, so only one of the threads materializes the leaf
+    std::call_once(materialize_flag, [this]() {
+        auto result_bitmap = std::make_shared<id_bitmap_t>();
+        materializer(*result_bitmap);
+        bitmap = std::move(result_bitmap);
+        materialized.store(true, std::memory_order_release);
+    });
+}
+
+id_bitmap_t::iterator_t& filter_leaf_iterator_t::iterator() {
+    if(it == nullptr) {
+        materialize();
+        it.reset(new id_bitmap_t::iterator_t(bitmap->new_iterator()));
+    }
+
+    return *it;
+}
+
+bool filter_leaf_iterator_t::valid() {
+    return iterator().valid();
+}
+
+uint32_t filter_leaf_iterator_t::id() {
+    return iterator().id();
+}
+
+void filter_leaf_iterator_t::next() {
+    iterator().next();
+}
+
+void filter_leaf_iterator_t::skip_to(const uint32_t id) {
+    iterator().skip_to(id);
+}
+
+void filter_leaf_iterator_t::reset() {
+    if(it != nullptr) {
+        *it = bitmap->new_iterator();
+    }
+}
+
+bool filter_leaf_iterator_t::contains(const uint32_t id) {
+    if(use_checker && !materialized.load(std::memory_order_acquire) &&
+       num_checks.fetch_add(1, std::memory_order_relaxed) * check_cost <= estimated_ids) {
+        return checker(id);
+    }
+
+    materialize();
+    return bitmap->contains(id);
+}
+
+size_t filter_leaf_iterator_t::estimate() const {
+    return materialized.load(std::memory_order_acquire) ? bitmap->cardinality() : estimated_ids;
+}
+
+void filter_leaf_iterator_t::plan_checks(const size_t num_candidates) {
+    // checking is preferred when it's cheaper than producing all the IDs of the leaf
+    use_checker = bool(checker) && (num_candidates * check_cost <= estimated_ids);
+}
+
+bool filter_leaf_iterator_t::is_materialized() const {
+    return materialized.load(std::memory_order_acquire);
+}
+
+bool filter_leaf_iterator_t::uses_checker() const {
+    return use_checker && !is_materialized();
+}
+
+/* and */
+
+filter_and_iterator_t::filter_and_iterator_t(std::vector<std::unique_ptr<filter_iterator_t>>&& children):
+                                             children(std::move(children)) {
+    std::stable_sort(this->children.begin(), this->children.end(),
+                     [](const std::unique_ptr<filter_iterator_t>& a, const std::unique_ptr<filter_iterator_t>& b) {
+        return a->estimate() < b->estimate();
+    });
+
+    for(size_t i = 1; i < this->children.size(); i++) {
+        this->children[i]->plan_checks(this->children[0]->estimate());
+    }
+}
+
+void filter_and_iterator_t::start() {
+    if(started) {
+        return;
+    }
+
+    started = true;
+
+    if(!children.empty()) {
+        advance_to_match();
+    }
+}
+
+void filter_and_iterator_t::advance_to_match() {
+    auto& driver = children[0];
+
+    while(driver->valid()) {
+        const uint32_t candidate = driver->id();
+        bool matched = true;
+
+        for(size_t i = 1; i < children.size(); i++) {
+            if(!children[i]->contains(candidate)) {
+                matched = false;
+                break;
+            }
+        }
+
+        if(matched) {
+            return;
+        }
+
+        driver->next();
+    }
+}
+
+bool filter_and_iterator_t::valid() {
+    start();
+    return !children.empty() && children[0]->valid();
+}
+
+uint32_t filter_and_iterator_t::id() {
+    start();
+    return children[0]->id();
+}
+
+void filter_and_iterator_t::next() {
+    start();
+    children[0]->next();
+    advance_to_match();
+}
+
+void filter_and_iterator_t::skip_to(const uint32_t id) {
+    if(children.empty()) {
+        return;
+    }
+
+    started = true;
+    children[0]->skip_to(id);
+    advance_to_match();
+}
+
+void filter_and_iterator_t::reset() {
+    if(!children.empty()) {
+        children[0]->reset();
+    }
+
+    started = false;
+}
+
+bool filter_and_iterator_t::contains(const uint32_t id) {
+    for(auto& child: children) {
+        if(!child->contains(id)) {
+            return false;
+        }
+    }
+
+    return !children.empty();
+}
+
+size_t filter_and_iterator_t::estimate() const {
+    return children.empty() ? 0 : children[0]->estimate();
+}
@@ -0,0 +1,618 @@
+#include "id_bitmap.h"
+#include <algorithm>
+#include <iterator>
+
+/* container operations */
+
+bool id_bitmap_t::container_t::contains(const uint16_t low) const {
+    if(is_bitset()) {
+        return (bits[low >> 6] >> (low & 63)) & 1;
+    }
+
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+bool id_bitmap_t::container_t::add(const uint16_t low) {
+    if(is_bitset()) {
+        uint64_t& word = bits[low >> 6];
+        const uint64_t mask = uint64_t(1) << (low & 63);
+        if(word & mask) {
+            return false;
+        }
+
+        word |= mask;
+        cardinality++;
+        return true;
+    }
+
+    if(array.empty() || array.back() < low) {
+        array.push_back(low);
+    } else {
+        auto it = std::lower_bound(array.begin(), array.end(), low);
+        if(it != array.end() && *it == low) {
+            return false;
+        }
+
+        array.insert(it, low);
+    }
+
+    cardinality++;
+
+    if(cardinality > ARRAY_CONTAINER_MAX_SIZE) {
+        to_bitset();
+    }
+
+    return true;
+}
+
+bool id_bitmap_t::container_t::remove(const uint16_t low) {
+    if(is_bitset()) {
+        uint64_t& word = bits[low >> 6];
+        const uint64_t mask = uint64_t(1) << (low & 63);
+        if((word & mask) == 0) {
+            return false;
+        }
+
+        word &= ~mask;
+        cardinality--;
+        optimize();
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if(it == array.end() || *it != low) {
+        return false;
+    }
+
+    array.erase(it);
+    cardinality--;
+    return true;
+}
+
+void id_bitmap_t::container_t::optimize() {
+    if(is_bitset() && cardinality <= ARRAY_CONTAINER_MAX_SIZE) {
+        to_array();
+    } else if(!is_bitset() && cardinality > ARRAY_CONTAINER_MAX_SIZE) {
+        to_bitset();
+    }
+}
+
+void id_bitmap_t::container_t::to_bitset() {
+    if(is_bitset()) {
+        return;
+    }
+
+    bits.assign(BITSET_NUM_WORDS, 0);
+    for(uint16_t low: array) {
+        bits[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+
+    std::vector<uint16_t>().swap(array);
+}
+
+void id_bitmap_t::container_t::to_array() {
+    if(!is_bitset()) {
+        return;
+    }
+
+    std::vector<uint16_t> values;
+    values.reserve(cardinality);
+
+    for(size_t w = 0; w < BITSET_NUM_WORDS; w++) {
+        uint64_t word = bits[w];
+        while(word != 0) {
+            values.push_back(uint16_t((w << 6) + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+
+    std::vector<uint64_t>().swap(bits);
+    array = std::move(values);
+}
+
+void id_bitmap_t::container_t::or_with(const container_t& other) {
+    if(other.is_bitset()) {
+        to_bitset();
+    }
+
+    if(is_bitset()) {
+        if(other.is_bitset()) {
+            uint32_t count = 0;
+            for(size_t w = 0; w < BITSET_NUM_WORDS; w++) {
+                bits[w] |= other.bits[w];
+                count += __builtin_popcountll(bits[w]);
+            }
+            cardinality = count;
+        } else {
+            for(uint16_t low: other.array) {
+                uint64_t& word = bits[low >> 6];
+                const uint64_t mask = uint64_t(1) << (low & 63);
+                cardinality += (word & mask) == 0;
+                word |= mask;
+            }
+        }
+
+        return;
+    }
+
+    std::vector<uint16_t> merged;
+    merged.reserve(array.size() + other.array.size());
+    std::set_union(array.begin(), array.end(), other.array.begin(), other.array.end(),
+                   std::back_inserter(merged));
+
+    array = std::move(merged);
+    cardinality = array.size();
+    optimize();
+}
+
+void id_bitmap_t::container_t::and_with(const container_t& other) {
+    if(is_bitset() && other.is_bitset()) {
+        uint32_t count = 0;
+        for(size_t w = 0; w < BITSET_NUM_WORDS; w++) {
+            bits[w] &= other.bits[w];
+            count += __builtin_popcountll(bits[w]);
+        }
+
+        cardinality = count;
+        optimize();
+        return;
+    }
+
+    std::vector<uint16_t> common;
+
+    if(is_bitset()) {
+        // other is an array: result cannot be larger than it
+        for(uint16_t low: other.array) {
+            if(contains(low)) {
+                common.push_back(low);
+            }
+        }
+
+        std::vector<uint64_t>().swap(bits);
+    } else if(other.is_bitset()) {
+        for(uint16_t low: array) {
+            if(other.contains(low)) {
+                common.push_back(low);
+            }
+        }
+    } else {
+        std::set_intersection(array.begin(), array.end(), other.array.begin(), other.array.end(),
+                              std::back_inserter(common));
+    }
+
+    array = std::move(common);
+    cardinality = array.size();
+}
+
+void id_bitmap_t::container_t::and_not(const container_t& other) {
+    if(is_bitset()) {
+        if(other.is_bitset()) {
+            uint32_t count = 0;
+            for(size_t w = 0; w < BITSET_NUM_WORDS; w++) {
+                bits[w] &= ~other.bits[w];
+                count += __builtin_popcountll(bits[w]);
+            }
+            cardinality = count;
+        } else {
+            for(uint16_t low: other.array) {
+                uint64_t& word = bits[low >> 6];
+                const uint64_t mask = uint64_t(1) << (low & 63);
+                cardinality -= (word & mask) != 0;
+                word &= ~mask;
+            }
+        }
+
+        optimize();
+        return;
+    }
+
+    std::vector<uint16_t> remaining;
+
+    if(other.is_bitset()) {
+        for(uint16_t low: array) {
+            if(!other.contains(low)) {
+                remaining.push_back(low);
+            }
+        }
+    } else {
+        std::set_difference(array.begin(), array.end(), other.array.begin(), other.array.end(),
+                            std::back_inserter(remaining));
+    }
+
+    array = std::move(remaining);
+    cardinality = array.size();
+}
+
+/* bitmap operations */
+
+id_bitmap_t::id_bitmap_t(const uint32_t* ids, size_t num_ids) {
+    add_many(ids, num_ids);
+}
+
+size_t id_bitmap_t::container_index(const uint16_t key) const {
+    // IDs are mostly appended in ascending order, so check the last container first
+    if(!containers.empty() && containers.back().key == key) {
+        return containers.size() - 1;
+    }
+
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const container_t& c, uint16_t k) { return c.key < k; });
+
+    return it - containers.begin();
+}
+
+void id_bitmap_t::add(const uint32_t id) {
+    const uint16_t key = id >> 16;
+    size_t index = container_index(key);
+
+    if(index == containers.size() || containers[index].key != key) {
+        container_t container;
+        container.key = key;
+        containers.insert(containers.begin() + index, std::move(container));
+    }
+
+    containers[index].add(uint16_t(id & 0xFFFF));
+}
+
+void id_bitmap_t::add_many(const uint32_t* ids, const size_t num_ids) {
+    size_t i = 0;
+
+    while(i < num_ids) {
+        const uint16_t key = ids[i] >> 16;
+
+        // find the run of IDs that belong to the same chunk
+        size_t run_end = i + 1;
+        while(run_end < num_ids && (ids[run_end] >> 16) == key) {
+            run_end++;
+        }
+
+        container_t run;
+        run.key = key;
+        run.array.reserve(run_end - i);
+        for(size_t j = i; j < run_end; j++) {
+            const uint16_t low = ids[j] & 0xFFFF;
+            if(run.array.empty() || run.array.back() != low) {
+                run.array.push_back(low);
+            }
+        }
+
+        run.cardinality = run.array.size();
+        run.optimize();
+
+        size_t index = container_index(key);
+        if(index == containers.size() || containers[index].key != key) {
+            containers.insert(containers.begin() + index, std::move(run));
+        } else {
+            containers[index].or_with(run);
+        }
+
+        i = run_end;
+    }
+}
+
+void id_bitmap_t::remove(const uint32_t id) {
+    const uint16_t key = id >> 16;
+    size_t index = container_index(key);
+
+    if(index == containers.size() || containers[index].key != key) {
+        return;
+    }
+
+    containers[index].remove(uint16_t(id & 0xFFFF));
+
+    if(containers[index].cardinality == 0) {
+        containers.erase(containers.begin() + index);
+    }
+}
+
+bool id_bitmap_t::contains(const uint32_t id) const {
+    const uint16_t key = id >> 16;
+    size_t index = container_index(key);
+
+    if(index == containers.size() || containers[index].key != key) {
+        return false;
+    }
+
+    return containers[index].contains(uint16_t(id & 0xFFFF));
+}
+
+bool id_bitmap_t::empty() const {
+    return containers.empty();
+}
+
+uint32_t id_bitmap_t::cardinality() const {
+    uint32_t count = 0;
+    for(const auto& container: containers) {
+        count += container.cardinality;
+    }
+
+    return count;
+}
+
+size_t id_bitmap_t::memory_used() const {
+    size_t bytes = sizeof(id_bitmap_t) + containers.capacity() * sizeof(container_t);
+    for(const auto& container: containers) {
+        bytes += container.array.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+    }
+
+    return bytes;
+}
+
+uint32_t id_bitmap_t::first_id() const {
+    if(containers.empty()) {
+        return 0;
+    }
+
+    const container_t& container = containers.front();
+    uint32_t high = uint32_t(container.key) << 16;
+
+    if(!container.is_bitset()) {
+        return high | container.array.front();
+    }
+
+    for(size_t w = 0; w < BITSET_NUM_WORDS; w++) {
+        if(container.bits[w] != 0) {
+            return high | uint32_t((w << 6) + __builtin_ctzll(container.bits[w]));
+        }
+    }
+
+    return high;
+}
+
+uint32_t id_bitmap_t::last_id() const {
+    if(containers.empty()) {
+        return UINT32_MAX;
+    }
+
+    const container_t& container = containers.back();
+    uint32_t high = uint32_t(container.key) << 16;
+
+    if(!container.is_bitset()) {
+        return high | container.array.back();
+    }
+
+    for(size_t w = BITSET_NUM_WORDS; w > 0; w--) {
+        if(container.bits[w - 1] != 0) {
+            return high | uint32_t(((w - 1) << 6) + 63 - __builtin_clzll(container.bits[w - 1]));
+        }
+    }
+
+    return high;
+}
+
+size_t id_bitmap_t::num_containers() const {
+    return containers.size();
+}
+
+void id_bitmap_t::or_with(const id_bitmap_t& other) {
+    std::vector<container_t> merged;
+    merged.reserve(containers.size() + other.containers.size());
+
+    size_t i = 0, j = 0;
+
+    while(i < containers.size() && j < other.containers.size()) {
+        if(containers[i].key < other.containers[j].key) {
+            merged.push_back(std::move(containers[i++]));
+        } else if(containers[i].key > other.containers[j].key) {
+            merged.push_back(other.containers[j++]);
+        } else {
+            containers[i].or_with(other.containers[j++]);
+            merged.push_back(std::move(containers[i++]));
+        }
+    }
+
+    while(i < containers.size()) {
+        merged.push_back(std::move(containers[i++]));
+    }
+
+    while(j < other.containers.size()) {
+        merged.push_back(other.containers[j++]);
+    }
+
+    containers = std::move(merged);
+}
+
+void id_bitmap_t::and_with(const id_bitmap_t& other) {
+    size_t num_kept = 0;
+    size_t j = 0;
+
+    for(size_t i = 0; i < containers.size(); i++) {
+        while(j < other.containers.size() && other.containers[j].key < containers[i].key) {
+            j++;
+        }
+
+        if(j == other.containers.size()) {
+            break;
+        }
+
+        if(other.containers[j].key != containers[i].key) {
+            continue;
+        }
+
+        containers[i].and_with(other.containers[j]);
+
+        if(containers[i].cardinality != 0) {
+            if(num_kept != i) {
+                containers[num_kept] = std::move(containers[i]);
+            }
+            num_kept++;
+        }
+    }
+
+    containers.resize(num_kept);
+}
+
+void id_bitmap_t::and_not(const id_bitmap_t& other) {
+    size_t num_kept = 0;
+    size_t j = 0;
+
+    for(size_t i = 0; i < containers.size(); i++) {
+        while(j < other.containers.size() && other.containers[j].key < containers[i].key) {
+            j++;
+        }
+
+        if(j < other.containers.size() && other.containers[j].key == containers[i].key) {
+            containers[i].and_not(other.containers[j]);
+        }
+
+        if(containers[i].cardinality != 0) {
+            if(num_kept != i) {
+                containers[num_kept] = std::move(containers[i]);
+            }
+            num_kept++;
+        }
+    }
+
+    containers.resize(num_kept);
+}
+
+bool id_bitmap_t::contains_atleast_one(const uint32_t* target_ids, const size_t target_ids_size) const {
+    for(size_t i = 0; i < target_ids_size; i++) {
+        if(contains(target_ids[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void id_bitmap_t::to_vector(std::vector<uint32_t>& ids) const {
+    ids.reserve(ids.size() + cardinality());
+
+    for(const auto& container: containers) {
+        const uint32_t high = uint32_t(container.key) << 16;
+
+        if(!container.is_bitset()) {
+            for(uint16_t low: container.array) {
+                ids.push_back(high | low);
+            }
+            continue;
+        }
+
+        for(size_t w = 0; w < BITSET_NUM_WORDS; w++) {
+            uint64_t word = container.bits[w];
+            while(word != 0) {
+                ids.push_back(high | uint32_t((w << 6) + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+uint32_t* id_bitmap_t::uncompress() const {
+    uint32_t* ids = new uint32_t[cardinality()];
+    size_t index = 0;
+
+    for(const auto& container: containers) {
+        const uint32_t high = uint32_t(container.key) << 16;
+
+        if(!container.is_bitset()) {
+            for(uint16_t low: container.array) {
+                ids[index++] = high | low;
+            }
+            continue;
+        }
+
+        for(size_t w = 0; w < BITSET_NUM_WORDS; w++) {
+            uint64_t word = container.bits[w];
+            while(word != 0) {
+                ids[index++] = high | uint32_t((w << 6) + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    return ids;
+}
+
+void id_bitmap_t::clear() {
+    containers.clear();
+}
+
+id_bitmap_t::iterator_t id_bitmap_t::new_iterator() const {
+    return iterator_t(&containers);
+}
+
+/* iterator */
+
+id_bitmap_t::iterator_t::iterator_t(const std::vector<container_t>* containers): containers(containers) {
+    seek(0);
+}
+
+void id_bitmap_t::iterator_t::seek(uint32_t low) {
+    while(container_index < containers->size()) {
+        const container_t& container = (*containers)[container_index];
+
+        if(!container.is_bitset()) {
+            position = std::lower_bound(container.array.begin(), container.array.end(), low) -
+                       container.array.begin();
+            if(position < container.array.size()) {
+                return;
+            }
+        } else if(low < (1 << 16)) {
+            size_t w = low >> 6;
+            uint64_t word = container.bits[w] & (~uint64_t(0) << (low & 63));
+
+            while(word == 0 && ++w < BITSET_NUM_WORDS) {
+                word = container.bits[w];
+            }
+
+            if(word != 0) {
+                position = (w << 6) + __builtin_ctzll(word);
+                return;
+            }
+        }
+
+        container_index++;
+        low = 0;
+    }
+}
+
+bool id_bitmap_t::iterator_t::valid() const {
+    return container_index < containers->size();
+}
+
+uint32_t id_bitmap_t::iterator_t::id() const {
+    const container_t& container = (*containers)[container_index];
+    const uint32_t high = uint32_t(container.key) << 16;
+    return container.is_bitset() ? (high | position) : (high | container.array[position]);
+}
+
+void id_bitmap_t::iterator_t::next() {
+    const container_t& container = (*containers)[container_index];
+
+    if(!container.is_bitset()) {
+        if(++position < container.array.size()) {
+            return;
+        }
+
+        container_index++;
+        seek(0);
+        return;
+    }
+
+    seek(position + 1);
+}
+
+void id_bitmap_t::iterator_t::skip_to(const uint32_t id) {
+    const uint16_t key = id >> 16;
+    bool changed_container = false;
+
+    while(container_index < containers->size() && (*containers)[container_index].key < key) {
+        container_index++;
+        changed_container = true;
+    }
+
+    if(container_index == containers->size()) {
+        return;
+    }
+
+    if((*containers)[container_index].key > key) {
+        if(changed_container) {
+            seek(0);
+        }
+    } else if(changed_container || this->id() < id) {
+        // the position within a new container has to be found even when it points to the ID
+        seek(id & 0xFFFF);
+    }
+}
@@ -1,5 +1,7 @@
 #include "ids_t.h"
 #include "id_list.h"
+#include <algorithm>
+#include <memory>
 
 int64_t compact_id_list_t::upsert(const uint32_t id) {
     // format: id1, id2, id3
@@ -178,6 +180,11 @@ bool compact_id_list_t::contains_atleast_one(const uint32_t* target_ids, size_t
 /* posting operations */
 
 void ids_t::upsert(void*& obj, uint32_t id) {
+    if(IS_BITMAP_IDS(obj)) {
+        BITMAP_IDS_PTR(obj)->add(id);
+        return;
+    }
+
     if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = (compact_id_list_t*) RAW_IDS_PTR(obj);
         int64_t extra_capacity_required = list->upsert(id);
@@ -218,10 +225,38 @@ void ids_t::upsert(void*& obj, uint32_t id) {
     // either `obj` is already a full list or was converted to a full list above
     id_list_t* list = (id_list_t*)(obj);
     list->upsert(id);
+
+    // density is checked only once per block worth of IDs to keep upserts cheap
+    const size_t list_num_ids = list->num_ids();
+    if(list_num_ids >= BITMAP_THRESHOLD_LENGTH && list_num_ids % MAX_BLOCK_ELEMENTS == 0 &&
+       is_dense(list_num_ids, list->first_id(), list->last_id())) {
+        uint32_t* ids = list->uncompress();
+        id_bitmap_t* bitmap = new id_bitmap_t(ids, list_num_ids);
+        delete [] ids;
+        delete list;
+        obj = SET_BITMAP_IDS(bitmap);
+    }
 }
 
 void ids_t::erase(void*& obj, uint32_t id) {
-    if(IS_COMPACT_IDS(obj)) {
+    if(IS_BITMAP_IDS(obj)) {
+        id_bitmap_t* bitmap = BITMAP_IDS_PTR(obj);
+        bitmap->remove(id);
+
+        if(bitmap->cardinality() < BITMAP_THRESHOLD_LENGTH/2) {
+            // convert back to a full list which is more compact for fewer IDs
+            std::vector<uint32_t> ids;
+            bitmap->to_vector(ids);
+
+            id_list_t* full_list = new id_list_t(MAX_BLOCK_ELEMENTS);
+            for(uint32_t existing_id: ids) {
+                full_list->upsert(existing_id);
+            }
+
+            delete bitmap;
+            obj = full_list;
+        }
+    } else if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = COMPACT_IDS_PTR(obj);
         list->erase(id);
 
@@ -260,7 +295,9 @@ void ids_t::erase(void*& obj, uint32_t id) {
 }
 
 uint32_t ids_t::num_ids(const void* obj) {
-    if(IS_COMPACT_IDS(obj)) {
+    if(IS_BITMAP_IDS(obj)) {
+        return BITMAP_IDS_PTR(obj)->cardinality();
+    } else if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = COMPACT_IDS_PTR(obj);
         return list->num_ids();
     } else {
@@ -270,7 +307,9 @@ uint32_t ids_t::num_ids(const void* obj) {
 }
 
 uint32_t ids_t::first_id(const void* obj) {
-    if(IS_COMPACT_IDS(obj)) {
+    if(IS_BITMAP_IDS(obj)) {
+        return BITMAP_IDS_PTR(obj)->first_id();
+    } else if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = COMPACT_IDS_PTR(obj);
         return list->first_id();
     } else {
@@ -280,7 +319,9 @@ uint32_t ids_t::first_id(const void* obj) {
 }
 
 bool ids_t::contains(const void* obj, uint32_t id) {
-    if(IS_COMPACT_IDS(obj)) {
+    if(IS_BITMAP_IDS(obj)) {
+        return BITMAP_IDS_PTR(obj)->contains(id);
+    } else if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = COMPACT_IDS_PTR(obj);
         return list->contains(id);
     } else {
@@ -290,7 +331,9 @@ bool ids_t::contains(const void* obj, uint32_t id) {
 }
 
 bool ids_t::contains_atleast_one(const void* obj, const uint32_t* target_ids, size_t target_ids_size) {
-    if(IS_COMPACT_IDS(obj)) {
+    if(IS_BITMAP_IDS(obj)) {
+        return BITMAP_IDS_PTR(obj)->contains_atleast_one(target_ids, target_ids_size);
+    } else if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = COMPACT_IDS_PTR(obj);
         return list->contains_atleast_one(target_ids, target_ids_size);
     } else {
@@ -300,6 +343,20 @@ bool ids_t::contains_atleast_one(const void* obj, const uint32_t* target_ids, si
 }
 
 void ids_t::merge(const std::vector<void*>& raw_posting_lists, std::vector<uint32_t>& result_ids) {
+    bool has_bitmap = false;
+    for(const void* raw_posting_list: raw_posting_lists) {
+        has_bitmap = has_bitmap || IS_BITMAP_IDS(raw_posting_list);
+    }
+
+    if(has_bitmap) {
+        // bitmaps are OR-ed chunk-wise, so the other lists are added to the union instead of expanding the bitmaps
+        id_bitmap_t merged;
+        merge(raw_posting_lists, merged);
+
+        merged.to_vector(result_ids);
+        return;
+    }
+
     // we will have to convert the compact posting list (if any) to full form
     std::vector<id_list_t*> id_lists;
     std::vector<id_list_t*> expanded_id_lists;
@@ -313,16 +370,53 @@ void ids_t::merge(const std::vector<void*>& raw_posting_lists, std::vector<uint3
 }
 
 void ids_t::intersect(const std::vector<void*>& raw_posting_lists, std::vector<uint32_t>& result_ids) {
+    std::vector<const id_bitmap_t*> bitmaps;
+    std::vector<void*> other_posting_lists;
+
+    for(void* raw_posting_list: raw_posting_lists) {
+        if(IS_BITMAP_IDS(raw_posting_list)) {
+            bitmaps.push_back(BITMAP_IDS_PTR(raw_posting_list));
+        } else {
+            other_posting_lists.push_back(raw_posting_list);
+        }
+    }
+
+    std::unique_ptr<id_bitmap_t> bitmaps_and;
+
+    if(!bitmaps.empty()) {
+        // bitmaps are AND-ed chunk-wise, starting from the smallest one
+        std::sort(bitmaps.begin(), bitmaps.end(), [](const id_bitmap_t* a, const id_bitmap_t* b) {
+            return a->cardinality() < b->cardinality();
+        });
+
+        bitmaps_and.reset(new id_bitmap_t(*bitmaps[0]));
+        for(size_t i = 1; i < bitmaps.size() && !bitmaps_and->empty(); i++) {
+            bitmaps_and->and_with(*bitmaps[i]);
+        }
+
+        if(other_posting_lists.empty()) {
+            bitmaps_and->to_vector(result_ids);
+            return;
+        }
+    }
+
     // we will have to convert the compact posting list (if any) to full form
     std::vector<id_list_t*> id_lists;
     std::vector<id_list_t*> expanded_id_lists;
-    to_expanded_id_lists(raw_posting_lists, id_lists, expanded_id_lists);
+    to_expanded_id_lists(other_posting_lists, id_lists, expanded_id_lists);
 
     id_list_t::intersect(id_lists, result_ids);
 
     for(auto expanded_plist: expanded_id_lists) {
         delete expanded_plist;
     }
+
+    if(bitmaps_and != nullptr) {
+        // probe the bitmaps with the (smaller) intersection of the other lists
+        result_ids.erase(std::remove_if(result_ids.begin(), result_ids.end(), [&bitmaps_and](uint32_t id) {
+            return !bitmaps_and->contains(id);
+        }), result_ids.end());
+    }
 }
 
 void ids_t::to_expanded_id_lists(const std::vector<void*>& raw_posting_lists, std::vector<id_list_t*>& id_lists,
@@ -330,7 +424,18 @@ void ids_t::to_expanded_id_lists(const std::vector<void*>& raw_posting_lists, st
     for(size_t i = 0; i < raw_posting_lists.size(); i++) {
         auto raw_posting_list = raw_posting_lists[i];
 
-        if(IS_COMPACT_IDS(raw_posting_list)) {
+        if(IS_BITMAP_IDS(raw_posting_list)) {
+            std::vector<uint32_t> ids;
+            BITMAP_IDS_PTR(raw_posting_list)->to_vector(ids);
+
+            id_list_t* full_posting_list = new id_list_t(MAX_BLOCK_ELEMENTS);
+            for(uint32_t id: ids) {
+                full_posting_list->upsert(id);
+            }
+
+            id_lists.emplace_back(full_posting_list);
+            expanded_id_lists.push_back(full_posting_list);
+        } else if(IS_COMPACT_IDS(raw_posting_list)) {
             auto compact_posting_list = COMPACT_IDS_PTR(raw_posting_list);
             id_list_t* full_posting_list = compact_posting_list->to_full_ids_list();
             id_lists.emplace_back(full_posting_list);
@@ -347,7 +452,9 @@ void ids_t::destroy_list(void*& obj) {
         return;
     }
 
-    if(IS_COMPACT_IDS(obj)) {
+    if(IS_BITMAP_IDS(obj)) {
+        delete BITMAP_IDS_PTR(obj);
+    } else if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = COMPACT_IDS_PTR(obj);
         free(list); // assigned via malloc, so must be free()d
     } else {
@@ -359,7 +466,9 @@ void ids_t::destroy_list(void*& obj) {
 }
 
 uint32_t* ids_t::uncompress(void*& obj) {
-    if(IS_COMPACT_IDS(obj)) {
+    if(IS_BITMAP_IDS(obj)) {
+        return BITMAP_IDS_PTR(obj)->uncompress();
+    } else if(IS_COMPACT_IDS(obj)) {
         compact_id_list_t* list = COMPACT_IDS_PTR(obj);
         uint32_t* arr = new uint32_t[list->length];
         std::memcpy(arr, list->ids, list->length * sizeof(uint32_t));
@@ -370,6 +479,45 @@ uint32_t* ids_t::uncompress(void*& obj) {
     }
 }
 
+void ids_t::merge(const void* obj, id_bitmap_t& bitmap) {
+    if(IS_BITMAP_IDS(obj)) {
+        bitmap.or_with(*BITMAP_IDS_PTR(obj));
+    } else if(IS_COMPACT_IDS(obj)) {
+        compact_id_list_t* list = COMPACT_IDS_PTR(obj);
+        bitmap.add_many(list->ids, list->length);
+    } else {
+        id_list_t* list = (id_list_t*)(obj);
+        uint32_t* ids = list->uncompress();
+        bitmap.add_many(ids, list->num_ids());
+        delete [] ids;
+    }
+}
+
+void ids_t::merge(const std::vector<void*>& id_lists, id_bitmap_t& bitmap) {
+    std::vector<uint32_t> ids;
+
+    for(const void* obj: id_lists) {
+        if(IS_BITMAP_IDS(obj)) {
+            bitmap.or_with(*BITMAP_IDS_PTR(obj));
+        } else if(IS_COMPACT_IDS(obj)) {
+            compact_id_list_t* list = COMPACT_IDS_PTR(obj);
+            ids.insert(ids.end(), list->ids, list->ids + list->length);
+        } else {
+            id_list_t* list = (id_list_t*)(obj);
+            uint32_t* list_ids = list->uncompress();
+            ids.insert(ids.end(), list_ids, list_ids + list->num_ids());
+            delete [] list_ids;
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+    bitmap.add_many(ids.data(), ids.size());
+}
+
+bool ids_t::is_dense(size_t num_ids, uint32_t first_id, uint32_t last_id) {
+    return num_ids * BITMAP_DENSITY_RATIO >= size_t(last_id - first_id) + 1;
+}
+
 void ids_t::block_intersector_t::split_lists(size_t concurrency,
                                              std::vector<std::vector<id_list_t::iterator_t>>& partial_its_vec) {
     const size_t num_blocks = this->id_lists[0]->num_blocks();
@@ -3,6 +3,7 @@
 #include <numeric>
 #include <chrono>
 #include <set>
+#include <random>
 #include <unordered_map>
 #include <array_utils.h>
 #include <match_score.h>
@@ -35,10 +36,10 @@
                                     break;\
                                 }
 
-spp::sparse_hash_map<uint32_t, int64_t> Index::text_match_sentinel_value;
-spp::sparse_hash_map<uint32_t, int64_t> Index::seq_id_sentinel_value;
-spp::sparse_hash_map<uint32_t, int64_t> Index::geo_sentinel_value;
-spp::sparse_hash_map<uint32_t, int64_t> Index::str_sentinel_value;
+sort_values_t Index::text_match_sentinel_value;
+sort_values_t Index::seq_id_sentinel_value;
+sort_values_t Index::geo_sentinel_value;
+sort_values_t Index::str_sentinel_value;
 
 struct token_posting_t {
     uint32_t token_id;
@@ -56,7 +57,10 @@ Index::Index(const std::string& name, const uint32_t collection_id, const Store*
              const std::vector<char>& symbols_to_index, const std::vector<char>& token_separators):
         name(name), collection_id(collection_id), store(store), synonym_index(synonym_index), thread_pool(thread_pool),
         search_schema(search_schema),
-        seq_ids(new id_list_t(256)), symbols_to_index(symbols_to_index), token_separators(token_separators) {
+        seq_ids(new id_list_t(256)), filter_result_cache(FILTER_RESULT_CACHE_CAPACITY),
+        facet_result_cache(FACET_RESULT_CACHE_CAPACITY), group_id_columns(GROUP_ID_COLUMN_CAPACITY),
+        typeahead_sessions(TYPEAHEAD_SESSION_CAPACITY),
+        symbols_to_index(symbols_to_index), token_separators(token_separators) {
 
     for(const auto & fname_field: search_schema) {
         if(!fname_field.second.index) {
@@ -85,18 +89,18 @@ Index::Index(const std::string& name, const uint32_t collection_id, const Store*
                 adi_tree_t* tree = new adi_tree_t();
                 str_sort_index.emplace(fname_field.first, tree);
             } else if(fname_field.second.type != field_types::GEOPOINT_ARRAY) {
-                spp::sparse_hash_map<uint32_t, int64_t> * doc_to_score = new spp::sparse_hash_map<uint32_t, int64_t>();
+                sort_values_t* doc_to_score = new sort_values_t();
                 sort_index.emplace(fname_field.first, doc_to_score);
+                sort_block_bounds.emplace(fname_field.first, new seq_id_block_bounds_t());
+
+                if(fname_field.second.presorted) {
+                    presorted_index.emplace(fname_field.first, new presorted_ids_t());
+                }
             }
         }
 
         if(fname_field.second.facet) {
-            array_mapped_facet_t facet_array;
-            for(size_t i = 0; i < ARRAY_FACET_DIM; i++) {
-                facet_array[i] = new facet_map_t();
-            }
-
-            facet_index_v3.emplace(fname_field.first, facet_array);
+            facet_index_v4.emplace(fname_field.first, new facet_index_t());
         }
 
         // initialize for non-string facet fields
@@ -107,13 +111,7 @@ Index::Index(const std::string& name, const uint32_t collection_id, const Store*
         }
 
         if(fname_field.second.infix) {
-            array_mapped_infix_t infix_sets(ARRAY_INFIX_DIM);
-
-            for(auto& infix_set: infix_sets) {
-                infix_set = new tsl::htrie_set<char>();
-            }
-
-            infix_index.emplace(fname_field.second.name, infix_sets);
+            infix_index.emplace(fname_field.second.name, new infix_index_t());
         }
     }
 
@@ -163,11 +161,23 @@ Index::~Index() {
 
     sort_index.clear();
 
+    for(auto & name_bounds: sort_block_bounds) {
+        delete name_bounds.second;
+        name_bounds.second = nullptr;
+    }
+
+    sort_block_bounds.clear();
+
+    for(auto & name_ids: presorted_index) {
+        delete name_ids.second;
+        name_ids.second = nullptr;
+    }
+
+    presorted_index.clear();
+
     for(auto& kv: infix_index) {
-        for(auto& infix_set: kv.second) {
-            delete infix_set;
-            infix_set = nullptr;
-        }
+        delete kv.second;
+        kv.second = nullptr;
     }
 
     infix_index.clear();
@@ -179,14 +189,12 @@ Index::~Index() {
 
     str_sort_index.clear();
 
-    for(auto& field_name_facet_map_array: facet_index_v3) {
-        for(auto& facet_map: field_name_facet_map_array.second) {
-            delete facet_map;
-            facet_map = nullptr;
-        }
+    for(auto& name_facet_index: facet_index_v4) {
+        delete name_facet_index.second;
+        name_facet_index.second = nullptr;
     }
 
-    facet_index_v3.clear();
+    facet_index_v4.clear();
 
     delete seq_ids;
 }
@@ -262,7 +270,8 @@ void Index::compute_token_offsets_facets(index_record& record,
 
                 tokenize_string_array_with_facets(strings, is_facet, field_pair.second,
                                                   local_symbols_to_index, local_token_separators,
-                                                  offset_facet_hashes.offsets, offset_facet_hashes.facet_hashes);
+                                                  offset_facet_hashes.offsets, offset_facet_hashes.facet_hashes,
+                                                  offset_facet_hashes.facet_values);
             } else {
                 std::string text;
 
@@ -278,7 +287,8 @@ void Index::compute_token_offsets_facets(index_record& record,
 
                 tokenize_string_with_facets(text, is_facet, field_pair.second,
                                             local_symbols_to_index, local_token_separators,
-                                            offset_facet_hashes.offsets, offset_facet_hashes.facet_hashes);
+                                            offset_facet_hashes.offsets, offset_facet_hashes.facet_hashes,
+                                            offset_facet_hashes.facet_values);
             }
         }
 
@@ -287,11 +297,13 @@ void Index::compute_token_offsets_facets(index_record& record,
             if(field_pair.second.type == field_types::STRING) {
                 tokenize_string_with_facets(document[field_name], is_facet, field_pair.second,
                                             local_symbols_to_index, local_token_separators,
-                                            offset_facet_hashes.offsets, offset_facet_hashes.facet_hashes);
+                                            offset_facet_hashes.offsets, offset_facet_hashes.facet_hashes,
+                                            offset_facet_hashes.facet_values);
             } else {
                 tokenize_string_array_with_facets(document[field_name], is_facet, field_pair.second,
                                                   local_symbols_to_index, local_token_separators,
-                                                  offset_facet_hashes.offsets, offset_facet_hashes.facet_hashes);
+                                                  offset_facet_hashes.offsets, offset_facet_hashes.facet_hashes,
+                                                  offset_facet_hashes.facet_values);
             }
         }
 
@@ -503,10 +515,7 @@ void Index::validate_and_preprocess(Index *index, std::vector<index_record>& ite
             if(index_rec.doc.count(default_sorting_field) == 0) {
                 auto default_sorting_field_it = index->sort_index.find(default_sorting_field);
                 if(default_sorting_field_it != index->sort_index.end()) {
-                    auto seq_id_it = default_sorting_field_it->second->find(index_rec.seq_id);
-                    if(seq_id_it != default_sorting_field_it->second->end()) {
-                        points = seq_id_it->second;
-                    } else {
+                    if(!default_sorting_field_it->second->get(index_rec.seq_id, points)) {
                         points = INT64_MIN;
                     }
                 } else {
@@ -626,6 +635,9 @@ size_t Index::batch_memory_index(Index *index, std::vector<index_record>& iter_b
         cv_process.wait(lock_process, [&](){ return num_processed == num_queued; });
     }
 
+    // group ids combine the values of several fields, so they are updated once all the fields are indexed
+    index->update_group_ids(iter_batch);
+
     return num_indexed;
 }
 
@@ -644,6 +656,7 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
             }
         }
 
+        bump_write_epoch(afield.name);
         return;
     }
 
@@ -681,15 +694,8 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
             }
 
             if(afield.facet) {
-                facet_hash_values_t fhashvalues;
-                fhashvalues.length = field_index_it->second.facet_hashes.size();
-                fhashvalues.hashes = new uint64_t[field_index_it->second.facet_hashes.size()];
-
-                for(size_t i  = 0; i < field_index_it->second.facet_hashes.size(); i++) {
-                    fhashvalues.hashes[i] = field_index_it->second.facet_hashes[i];
-                }
-
-                facet_index_v3[afield.name][seq_id % ARRAY_FACET_DIM]->emplace(seq_id, std::move(fhashvalues));
+                facet_index_v4.at(afield.name)->upsert(seq_id, field_index_it->second.facet_hashes,
+                                                       field_index_it->second.facet_values);
             }
 
             if(record.points > max_score) {
@@ -700,19 +706,19 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
                 token_to_doc_offsets[token_offsets.first].emplace_back(seq_id, record.points, token_offsets.second);
 
                 if(afield.infix) {
-                    auto strhash = StringUtils::hash_wy(token_offsets.first.c_str(), token_offsets.first.size());
-                    const auto& infix_sets = infix_index.at(afield.name);
-                    infix_sets[strhash % 4]->insert(token_offsets.first);
+                    infix_index.at(afield.name)->insert(token_offsets.first);
                 }
             }
         }
 
         auto tree_it = search_index.find(afield.faceted_name());
         if(tree_it == search_index.end()) {
+            bump_write_epoch(afield.name);
             return;
         }
 
         art_tree *t = tree_it->second;
+        bool inserted_new_token = false;
 
         for(auto& token_to_doc: token_to_doc_offsets) {
             const std::string& token = token_to_doc.first;
@@ -722,7 +728,14 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
             int key_len = (int) token.length() + 1;  // for the terminating \0 char
 
             //LOG(INFO) << "key: " << key << ", art_doc.id: " << art_doc.id;
-            art_inserts(t, key, key_len, max_score, documents);
+            if(art_inserts(t, key, key_len, max_score, documents) == nullptr) {
+                inserted_new_token = true;
+            }
+        }
+
+        // cached fuzzy candidates of the field miss the new tokens
+        if(inserted_new_token) {
+            bump_dictionary_epoch(afield.faceted_name());
         }
     }
 
@@ -842,7 +855,11 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
 
         // add numerical values automatically into sort index if sorting is enabled
         if(afield.is_num_sortable() && afield.type != field_types::GEOPOINT_ARRAY) {
-            spp::sparse_hash_map<uint32_t, int64_t> *doc_to_score = sort_index.at(afield.name);
+            sort_values_t* doc_to_score = sort_index.at(afield.name);
+            seq_id_block_bounds_t* block_bounds = sort_block_bounds.at(afield.name);
+
+            const auto presorted_it = presorted_index.find(afield.name);
+            presorted_ids_t* presorted_ids = (presorted_it == presorted_index.end()) ? nullptr : presorted_it->second;
 
             bool is_integer = afield.is_integer();
             bool is_float = afield.is_float();
@@ -862,16 +879,24 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
                 }
 
                 if(is_integer) {
-                    doc_to_score->emplace(seq_id, document[afield.name].get<int64_t>());
+                    doc_to_score->set(seq_id, document[afield.name].get<int64_t>());
+                    block_bounds->update(seq_id, document[afield.name].get<int64_t>());
                 } else if(is_float) {
                     int64_t ifloat = float_to_in64_t(document[afield.name].get<float>());
-                    doc_to_score->emplace(seq_id, ifloat);
+                    doc_to_score->set(seq_id, ifloat);
+                    block_bounds->update(seq_id, ifloat);
                 } else if(is_bool) {
-                    doc_to_score->emplace(seq_id, (int64_t) document[afield.name].get<bool>());
+                    doc_to_score->set(seq_id, (int64_t) document[afield.name].get<bool>());
+                    block_bounds->update(seq_id, (int64_t) document[afield.name].get<bool>());
                 } else if(is_geopoint) {
                     const std::vector<double>& latlong = document[afield.name];
                     int64_t lat_lng = GeoPoint::pack_lat_lng(latlong[0], latlong[1]);
-                    doc_to_score->emplace(seq_id, lat_lng);
+                    doc_to_score->set(seq_id, lat_lng);
+                }
+
+                int64_t sort_value;
+                if(presorted_ids != nullptr && doc_to_score->get(seq_id, sort_value)) {
+                    presorted_ids->emplace(sort_value, seq_id);
                 }
             }
         }
@@ -895,6 +920,9 @@ void Index::index_field_in_memory(const field& afield, std::vector<index_record>
             str_tree->index(seq_id, raw_str);
         }
     }
+
+    // cached filter results of the field are stale now
+    bump_write_epoch(afield.name);
 }
 
 void Index::insert_doc(const int64_t score, art_tree *t, uint32_t seq_id,
@@ -932,7 +960,8 @@ void Index::tokenize_string_with_facets(const std::string& text, bool is_facet,
                                         const std::vector<char>& symbols_to_index,
                                         const std::vector<char>& token_separators,
                                         std::unordered_map<std::string, std::vector<uint32_t>>& token_to_offsets,
-                                        std::vector<uint64_t>& facet_hashes) {
+                                        std::vector<uint64_t>& facet_hashes,
+                                        std::vector<std::string>& facet_values) {
 
     Tokenizer tokenizer(text, true, !a_field.is_string(), a_field.locale, symbols_to_index, token_separators);
     std::string token;
@@ -965,6 +994,7 @@ void Index::tokenize_string_with_facets(const std::string& text, bool is_facet,
 
     if(is_facet) {
         facet_hashes.push_back(facet_hash);
+        facet_values.push_back(text);
     }
 }
 
@@ -973,7 +1003,8 @@ void Index::tokenize_string_array_with_facets(const std::vector<std::string>& st
                                               const std::vector<char>& symbols_to_index,
                                               const std::vector<char>& token_separators,
                                               std::unordered_map<std::string, std::vector<uint32_t>>& token_to_offsets,
-                                              std::vector<uint64_t>& facet_hashes) {
+                                              std::vector<uint64_t>& facet_hashes,
+                                              std::vector<std::string>& facet_values) {
 
     for(size_t array_index = 0; array_index < strings.size(); array_index++) {
         const std::string& str = strings[array_index];
@@ -1012,6 +1043,7 @@ void Index::tokenize_string_array_with_facets(const std::vector<std::string>& st
 
         if(is_facet) {
             facet_hashes.push_back(facet_hash);
+            facet_values.push_back(str);
         }
 
         for(auto& the_token: token_set) {
@@ -1061,11 +1093,77 @@ void Index::compute_facet_stats(facet &a_facet, uint64_t raw_value, const std::s
     }
 }
 
+void Index::compute_range_facet_counts(facet& a_facet, const uint32_t* result_ids, const size_t results_size) const {
+    if(a_facet.range_counts.size() < a_facet.ranges.size()) {
+        a_facet.range_counts.resize(a_facet.ranges.size());
+    }
+
+    const auto num_tree_it = numerical_index.find(a_facet.field_name);
+    if(results_size == 0 || num_tree_it == numerical_index.end()) {
+        return ;
+    }
+
+    num_tree_t* num_tree = num_tree_it->second;
+
+    // only single valued fields have their values in the sort index
+    const auto sort_index_it = sort_index.find(a_facet.field_name);
+    const sort_values_t* doc_values = (sort_index_it == sort_index.end()) ? nullptr : sort_index_it->second;
+
+    bool use_num_tree = (doc_values == nullptr);
+
+    if(!use_num_tree) {
+        // Intersecting costs about the number of ids in the ranges plus the results, while looking up costs about
+        // the results alone, so intersecting wins on large result sets over ranges with few values.
+        size_t intersect_cost = results_size;
+
+        for(const auto& range: a_facet.ranges) {
+            const size_t num_range_ids = num_tree->count(range.start, range.end, RANGE_FACET_MAX_TREE_VALUES);
+            if(num_range_ids == SIZE_MAX) {
+                intersect_cost = SIZE_MAX;
+                break;
+            }
+
+            intersect_cost += num_range_ids;
+        }
+
+        use_num_tree = (intersect_cost < results_size * RANGE_FACET_LOOKUP_COST);
+    }
+
+    if(use_num_tree) {
+        const id_bitmap_t result_bitmap(result_ids, results_size);
+
+        for(size_t ri = 0; ri < a_facet.ranges.size(); ri++) {
+            id_bitmap_t range_ids;
+            num_tree->range_inclusive_search(a_facet.ranges[ri].start, a_facet.ranges[ri].end, range_ids);
+            range_ids.and_with(result_bitmap);
+            a_facet.range_counts[ri] += range_ids.cardinality();
+        }
+
+        return ;
+    }
+
+    for(size_t i = 0; i < results_size; i++) {
+        int64_t value;
+        if(!doc_values->get(result_ids[i], value)) {
+            continue;
+        }
+
+        // ranges can overlap, so every range is checked
+        for(size_t ri = 0; ri < a_facet.ranges.size(); ri++) {
+            if(value >= a_facet.ranges[ri].start && value <= a_facet.ranges[ri].end) {
+                a_facet.range_counts[ri]++;
+            }
+        }
+    }
+}
+
 void Index::do_facets(std::vector<facet> & facets, facet_query_t & facet_query,
                       const std::vector<facet_info_t>& facet_infos,
                       const size_t group_limit, const std::vector<std::string>& group_by_fields,
                       const uint32_t* result_ids, size_t results_size) const {
 
+    const auto group_id_column = group_limit ? get_group_id_column(group_by_fields) : nullptr;
+
     // assumed that facet fields have already been validated upstream
     for(size_t findex=0; findex < facets.size(); findex++) {
         auto& a_facet = facets[findex];
@@ -1074,26 +1172,47 @@ void Index::do_facets(std::vector<facet> & facets, facet_query_t & facet_query,
         const auto& fquery_hashes = facet_infos[findex].hashes;
         const bool should_compute_stats = facet_infos[findex].should_compute_stats;
 
-        const auto& field_facet_mapping_it = facet_index_v3.find(a_facet.field_name);
-        if(field_facet_mapping_it == facet_index_v3.end()) {
+        if(a_facet.is_range_facet()) {
+            continue;
+        }
+
+        const auto& field_facet_index_it = facet_index_v4.find(a_facet.field_name);
+        if(field_facet_index_it == facet_index_v4.end()) {
             continue;
         }
 
-        const auto& field_facet_mapping = field_facet_mapping_it->second;
+        const facet_index_t* field_facet_index = field_facet_index_it->second;
+
+        // Plain counts go into a flat array indexed by ordinal, unless the field has so many distinct values that
+        // clearing and scanning the array would cost more than counting the results into a hash map.
+        const bool count_by_ordinal = !group_limit && !use_facet_query &&
+                                      field_facet_index->ordinal_space() <= results_size * FACET_ORDINALS_PER_RESULT;
+
+        if(count_by_ordinal && a_facet.ordinal_counts.size() < field_facet_index->ordinal_space()) {
+            a_facet.ordinal_counts.resize(field_facet_index->ordinal_space());
+        }
 
         for(size_t i = 0; i < results_size; i++) {
             uint32_t doc_seq_id = result_ids[i];
-            const auto& facet_hashes_it = field_facet_mapping[doc_seq_id % ARRAY_FACET_DIM]->find(doc_seq_id);
+            uint32_t num_values = 0;
+            const uint32_t* ordinals = field_facet_index->get_ordinals(doc_seq_id, num_values);
+
+            if(count_by_ordinal) {
+                for(size_t j = 0; j < num_values; j++) {
+                    if(should_compute_stats) {
+                        compute_facet_stats(a_facet, field_facet_index->get_hash(ordinals[j]), facet_field.type);
+                    }
+
+                    a_facet.ordinal_counts[ordinals[j]]++;
+                }
 
-            if(facet_hashes_it == field_facet_mapping[doc_seq_id % ARRAY_FACET_DIM]->end()) {
                 continue;
             }
 
-            const auto& facet_hashes = facet_hashes_it->second;
-            const uint64_t distinct_id = group_limit ? get_distinct_id(group_by_fields, doc_seq_id) : 0;
+            const uint64_t distinct_id = group_limit ? get_distinct_id(*group_id_column, doc_seq_id) : 0;
 
-            for(size_t j = 0; j < facet_hashes.size(); j++) {
-                auto fhash = facet_hashes.hashes[j];
+            for(size_t j = 0; j < num_values; j++) {
+                auto fhash = field_facet_index->get_hash(ordinals[j]);
 
                 if(should_compute_stats) {
                     compute_facet_stats(a_facet, fhash, facet_field.type);
@@ -1104,9 +1223,6 @@ void Index::do_facets(std::vector<facet> & facets, facet_query_t & facet_query,
 
                     //LOG(INFO) << "field: " << a_facet.field_name << ", doc id: " << doc_seq_id << ", hash: " <<  fhash;
 
-                    facet_count.doc_id = doc_seq_id;
-                    facet_count.array_pos = j;
-
                     if(group_limit) {
                         a_facet.hash_groups[fhash].emplace(distinct_id);
                     } else {
@@ -1122,24 +1238,51 @@ void Index::do_facets(std::vector<facet> & facets, facet_query_t & facet_query,
     }
 }
 
+void Index::fold_ordinal_facet_counts(std::vector<facet>& facets) const {
+    for(auto& a_facet: facets) {
+        if(a_facet.ordinal_counts.empty()) {
+            continue;
+        }
+
+        const facet_index_t* field_facet_index = facet_index_v4.at(a_facet.field_name);
+
+        for(size_t ordinal = 0; ordinal < a_facet.ordinal_counts.size(); ordinal++) {
+            if(a_facet.ordinal_counts[ordinal] != 0) {
+                a_facet.result_map[field_facet_index->get_hash(ordinal)].count += a_facet.ordinal_counts[ordinal];
+            }
+        }
+
+        std::vector<uint32_t>().swap(a_facet.ordinal_counts);
+    }
+}
+
 void Index::aggregate_topster(Topster* agg_topster, Topster* index_topster) {
     if(index_topster->distinct) {
         for(auto &group_topster_entry: index_topster->group_kv_map) {
             Topster* group_topster = group_topster_entry.second;
-            for(const auto& map_kv: group_topster->kv_map) {
-                agg_topster->add(map_kv.second);
+            for(uint32_t i = 0; i < group_topster->size; i++) {
+                agg_topster->add(group_topster->getKV(i));
             }
         }
     } else {
-        for(const auto& map_kv: index_topster->kv_map) {
-            agg_topster->add(map_kv.second);
+        agg_topster->skip_keys(*index_topster);
+
+        // index topster is discarded after aggregation, so it can be sorted: in descending order, the first KV
+        // that falls below the threshold of the aggregate ends the merge
+        index_topster->sort();
+
+        for(uint32_t i = 0; i < index_topster->size; i++) {
+            KV* kv = index_topster->getKV(i);
+            if(!agg_topster->add(kv) && agg_topster->is_below_threshold(kv)) {
+                break;
+            }
         }
     }
 }
 
 void Index::search_all_candidates(const size_t num_search_fields,
                                   const std::vector<search_field_t>& the_fields,
-                                  const uint32_t* filter_ids, size_t filter_ids_length,
+                                  filter_iterator_t* filter_it,
                                   const uint32_t* exclude_token_ids, size_t exclude_token_ids_size,
                                   const std::vector<sort_by>& sort_fields,
                                   std::vector<tok_candidates>& token_candidates_vec,
@@ -1159,7 +1302,7 @@ void Index::search_all_candidates(const size_t num_search_fields,
                                   const size_t max_candidates,
                                   int syn_orig_num_tokens,
                                   const int* sort_order,
-                                  std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
+                                  std::array<sort_values_t*, 3>& field_values,
                                   const std::vector<size_t>& geopoint_indices,
                                   std::set<uint64>& query_hashes,
                                   std::vector<uint32_t>& id_buff) const {
@@ -1176,7 +1319,7 @@ void Index::search_all_candidates(const size_t num_search_fields,
         std::vector<uint32_t> temp_ids;
 
         find_across_fields(query_tokens, query_tokens.size()-1, num_typos, prefixes, the_fields, num_search_fields,
-                           filter_ids, filter_ids_length, exclude_token_ids, exclude_token_ids_size,
+                           filter_it, exclude_token_ids, exclude_token_ids_size,
                            temp_ids);
 
         //LOG(INFO) << "temp_ids found: " << temp_ids.size();
@@ -1280,7 +1423,7 @@ void Index::search_all_candidates(const size_t num_search_fields,
         search_across_fields(query_suggestion, num_typos, prefixes, the_fields, num_search_fields,
                              sort_fields, topster,groups_processed,
                              searched_queries, qtoken_set, group_limit, group_by_fields, prioritize_exact_match,
-                             filter_ids, filter_ids_length, total_cost, syn_orig_num_tokens,
+                             exhaustive_search, filter_it, total_cost, syn_orig_num_tokens,
                              exclude_token_ids, exclude_token_ids_size,
                              sort_order, field_values, geopoint_indices,
                              id_buff, all_result_ids, all_result_ids_len);
@@ -1315,7 +1458,7 @@ void Index::search_candidates(const uint8_t & field_id, bool field_is_array,
     long long int N = std::accumulate(token_candidates_vec.begin(), token_candidates_vec.end(), 1LL, product);
 
     int sort_order[3]; // 1 or -1 based on DESC or ASC respectively
-    std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3> field_values;
+    std::array<sort_values_t*, 3> field_values;
     std::vector<size_t> geopoint_indices;
 
     populate_sort_mapping(sort_order, geopoint_indices, sort_fields, field_values);
@@ -1392,6 +1535,7 @@ void Index::search_candidates(const uint8_t & field_id, bool field_is_array,
         } else {
             for(size_t i = 0; i < concurrency; i++) {
                 topsters[i] = new Topster(topster->MAX_SIZE, topster->distinct);
+                topsters[i]->copy_cursor(*topster);
             }
 
             posting_t::block_intersector_t(
@@ -1465,371 +1609,1020 @@ void Index::do_filtering(uint32_t*& filter_ids, uint32_t& filter_ids_length,
                          const std::vector<filter>& filters,
                          const bool enable_short_circuit) const {
     //auto begin = std::chrono::high_resolution_clock::now();
-    for(size_t i = 0; i < filters.size(); i++) {
-        const filter & a_filter = filters[i];
 
-        if(a_filter.field_name == "id") {
-            // we handle `ids` separately
-            std::vector<uint32> result_ids;
-            for(const auto& id_str: a_filter.values) {
-                result_ids.push_back(std::stoul(id_str));
-            }
+    std::vector<uint32_t> result_ids;
+    new_filter_iterator(filters)->to_vector(result_ids);
 
-            std::sort(result_ids.begin(), result_ids.end());
+    filter_ids_length = result_ids.size();
+    filter_ids = nullptr;
 
-            if(i == 0) {
-                filter_ids = new uint32[result_ids.size()];
-                std::copy(result_ids.begin(), result_ids.end(), filter_ids);
-                filter_ids_length = result_ids.size();
-            } else {
-                uint32_t* filtered_results = nullptr;
-                filter_ids_length = ArrayUtils::and_scalar(filter_ids, filter_ids_length, &result_ids[0],
-                                                           result_ids.size(), &filtered_results);
-                delete [] filter_ids;
-                filter_ids = filtered_results;
-            }
+    if(filter_ids_length != 0) {
+        filter_ids = new uint32_t[filter_ids_length];
+        std::copy(result_ids.begin(), result_ids.end(), filter_ids);
+    }
 
-            continue;
+    /*long long int timeMillis =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    LOG(INFO) << "Time taken for filtering: " << timeMillis << "ms";*/
+}
+
+std::unique_ptr<filter_iterator_t> Index::new_filter_iterator(const std::vector<filter>& filters,
+                                                              std::vector<filter_clause_plan_t>* filter_plan) const {
+    // Every clause becomes a leaf of an AND iterator, ordered from the most to the least selective clause.
+    // Only the most selective clause is iterated: the IDs it produces are verified against the other clauses,
+    // which avoids scanning the index for broad clauses.
+    std::vector<std::pair<std::unique_ptr<filter_leaf_iterator_t>, const filter*>> clauses;
+
+    for(const filter& a_filter: filters) {
+        auto clause_it = new_filter_iterator(a_filter);
+        if(clause_it != nullptr) {
+            clauses.emplace_back(std::move(clause_it), &a_filter);
         }
+    }
+
+    std::stable_sort(clauses.begin(), clauses.end(), [](const auto& a, const auto& b) {
+        return a.first->estimate() < b.first->estimate();
+    });
 
-        bool has_search_index = search_index.count(a_filter.field_name) != 0 ||
-                                numerical_index.count(a_filter.field_name) != 0 ||
-                                geopoint_index.count(a_filter.field_name) != 0;
+    std::vector<const filter_leaf_iterator_t*> clause_leaves;
+    std::vector<std::unique_ptr<filter_iterator_t>> clause_its;
 
-        if(!has_search_index) {
-            continue;
+    for(auto& clause: clauses) {
+        clause_leaves.push_back(clause.first.get());
+        clause_its.push_back(std::move(clause.first));
+    }
+
+    // the AND iterator decides which clauses are verified rather than materialized
+    auto filter_it = std::make_unique<filter_and_iterator_t>(std::move(clause_its));
+
+    if(filter_plan != nullptr) {
+        filter_plan->clear();
+
+        for(size_t i = 0; i < clauses.size(); i++) {
+            const filter_strategy_t strategy = (i == 0) ? filter_strategy_t::scan :
+                                               clause_leaves[i]->uses_checker() ? filter_strategy_t::verify :
+                                                                                  filter_strategy_t::materialize;
+            filter_plan->push_back({clauses[i].second->field_name, clause_leaves[i]->estimate(), strategy});
         }
+    }
+
+    return filter_it;
+}
+
+std::unique_ptr<filter_leaf_iterator_t> Index::new_ids_filter_iterator(const uint32_t* ids, const size_t ids_length) {
+    return std::make_unique<filter_leaf_iterator_t>(
+        [ids, ids_length](id_bitmap_t& result_bitmap) {
+            result_bitmap.add_many(ids, ids_length);
+        },
+        [ids, ids_length](uint32_t seq_id) {
+            return std::binary_search(ids, ids + ids_length, seq_id);
+        },
+        ids_length
+    );
+}
+
+std::unique_ptr<filter_leaf_iterator_t> Index::new_filter_iterator(const filter& a_filter) const {
+    if(a_filter.field_name == "id") {
+        // we handle `ids` separately
+        auto result_ids = std::make_shared<std::vector<uint32_t>>();
+        for(const auto& id_str: a_filter.values) {
+            result_ids->push_back(std::stoul(id_str));
+        }
+
+        std::sort(result_ids->begin(), result_ids->end());
 
-        field f = search_schema.at(a_filter.field_name);
+        return std::make_unique<filter_leaf_iterator_t>(
+            [result_ids](id_bitmap_t& result_bitmap) {
+                result_bitmap.add_many(result_ids->data(), result_ids->size());
+            },
+            [result_ids](uint32_t seq_id) {
+                return std::binary_search(result_ids->begin(), result_ids->end(), seq_id);
+            },
+            result_ids->size()
+        );
+    }
+
+    bool has_search_index = search_index.count(a_filter.field_name) != 0 ||
+                            numerical_index.count(a_filter.field_name) != 0 ||
+                            geopoint_index.count(a_filter.field_name) != 0;
+
+    if(!has_search_index) {
+        return nullptr;
+    }
+
+    const field& f = search_schema.at(a_filter.field_name);
+
+    const std::string cache_key = get_filter_cache_key(a_filter);
+    uint64_t field_epoch = 0, docs_epoch = 0;
+    std::shared_ptr<const id_bitmap_t> cached_ids = get_cached_filter_ids(cache_key, a_filter,
+                                                                          field_epoch, docs_epoch);
+
+    if(cached_ids != nullptr) {
+        return std::make_unique<filter_leaf_iterator_t>(cached_ids);
+    }
+
+    filter_leaf_iterator_t::materializer_t materializer = [this, &a_filter, cache_key, field_epoch, docs_epoch]
+                                                          (id_bitmap_t& result_bitmap) {
+        compute_filter_ids(a_filter, result_bitmap);
+        cache_filter_ids(cache_key, field_epoch, docs_epoch, result_bitmap);
+    };
+
+    filter_leaf_iterator_t::checker_t checker;
+    size_t estimated_ids = seq_ids->num_ids();
+    size_t check_cost = 1;
+
+    if(f.is_integer() || f.is_float() || f.is_bool()) {
+        estimated_ids = estimate_numeric_filter_ids(a_filter, f);
+    }
 
-        uint32_t* result_ids = nullptr;
-        size_t result_ids_len = 0;
+    if((f.is_integer() || f.is_float() || f.is_bool()) && !f.is_array() && sort_index.count(f.name) != 0) {
+        // single valued numerical fields can be checked by looking up the document's value
+        const sort_values_t* doc_values = sort_index.at(f.name);
+        const bool is_float = f.is_float();
+        const bool is_bool = f.is_bool();
 
-        if(f.is_integer()) {
-            auto num_tree = numerical_index.at(a_filter.field_name);
+        // parse the filter values upfront, since every candidate is checked against them
+        std::vector<int64_t> values;
+        for(const std::string& filter_value: a_filter.values) {
+            if(is_bool) {
+                values.push_back((filter_value == "1") ? 1 : 0);
+            } else if(is_float) {
+                values.push_back(float_to_in64_t((float) std::atof(filter_value.c_str())));
+            } else {
+                values.push_back((int64_t) std::stol(filter_value));
+            }
+        }
 
-            for(size_t fi=0; fi < a_filter.values.size(); fi++) {
-                const std::string & filter_value = a_filter.values[fi];
-                int64_t value = (int64_t) std::stol(filter_value);
+        checker = [&a_filter, doc_values, values, is_bool](uint32_t seq_id) {
+            int64_t doc_value;
+            const bool has_value = doc_values->get(seq_id, doc_value);
 
-                if(a_filter.comparators[fi] == RANGE_INCLUSIVE && fi+1 < a_filter.values.size()) {
-                    const std::string& next_filter_value = a_filter.values[fi+1];
-                    int64_t range_end_value = (int64_t) std::stol(next_filter_value);
-                    num_tree->range_inclusive_search(value, range_end_value, &result_ids, result_ids_len);
+            for(size_t fi = 0; fi < values.size(); fi++) {
+                if(is_bool && a_filter.comparators[fi] == NOT_EQUALS) {
+                    // documents without a value are also included
+                    if(!has_value || doc_value != values[fi]) {
+                        return true;
+                    }
+                } else if(a_filter.comparators[fi] == RANGE_INCLUSIVE && fi+1 < values.size()) {
+                    if(has_value && doc_value >= values[fi] && doc_value <= values[fi+1]) {
+                        return true;
+                    }
                     fi++;
-                } else {
-                    num_tree->search(a_filter.comparators[fi], value, &result_ids, result_ids_len);
+                } else if(has_value && compare_filter_value(a_filter.comparators[fi], doc_value, values[fi])) {
+                    return true;
                 }
             }
 
-        } else if(f.is_float()) {
-            auto num_tree = numerical_index.at(a_filter.field_name);
+            return false;
+        };
+    } else if(f.is_geopoint()) {
+        auto regions = std::make_shared<std::vector<std::unique_ptr<S2Region>>>();
+        for(const std::string& filter_value: a_filter.values) {
+            S2Region* query_region = new_geo_filter_region(filter_value);
+            if(query_region != nullptr) {
+                regions->emplace_back(query_region);
+            }
+        }
 
-            for(size_t fi=0; fi < a_filter.values.size(); fi++) {
-                const std::string & filter_value = a_filter.values[fi];
-                float value = (float) std::atof(filter_value.c_str());
-                int64_t float_int64 = float_to_in64_t(value);
+        estimated_ids = std::min<size_t>(estimated_ids, estimate_geo_filter_ids(f.name, *regions));
+        check_cost = std::max<size_t>(1, regions->size());
 
-                if(a_filter.comparators[fi] == RANGE_INCLUSIVE && fi+1 < a_filter.values.size()) {
-                    const std::string& next_filter_value = a_filter.values[fi+1];
-                    int64_t range_end_value = float_to_in64_t((float) std::atof(next_filter_value.c_str()));
-                    num_tree->range_inclusive_search(float_int64, range_end_value, &result_ids, result_ids_len);
-                    fi++;
-                } else {
-                    num_tree->search(a_filter.comparators[fi], float_int64, &result_ids, result_ids_len);
+        const auto region_contains = [regions](const int64_t lat_lng) {
+            S2LatLng s2_lat_lng;
+            GeoPoint::unpack_lat_lng(lat_lng, s2_lat_lng);
+            const S2Point point = s2_lat_lng.ToPoint();
+
+            for(const auto& region: *regions) {
+                if(region->Contains(point)) {
+                    return true;
                 }
             }
 
-        } else if(f.is_bool()) {
-            auto num_tree = numerical_index.at(a_filter.field_name);
+            return false;
+        };
+
+        if(f.is_single_geopoint() && sort_index.count(f.name) != 0) {
+            const sort_values_t* doc_values = sort_index.at(f.name);
+            checker = [doc_values, region_contains](uint32_t seq_id) {
+                int64_t lat_lng;
+                return doc_values->get(seq_id, lat_lng) && region_contains(lat_lng);
+            };
+        } else if(!f.is_single_geopoint() && geo_array_index.count(f.name) != 0) {
+            const spp::sparse_hash_map<uint32_t, int64_t*>* doc_values = geo_array_index.at(f.name);
+            checker = [doc_values, region_contains](uint32_t seq_id) {
+                const auto value_it = doc_values->find(seq_id);
+                if(value_it == doc_values->end()) {
+                    return false;
+                }
+
+                // any one point should exist
+                const int64_t* lat_lngs = value_it->second;
+                for(int64_t li = 0; li < lat_lngs[0]; li++) {
+                    if(region_contains(lat_lngs[li + 1])) {
+                        return true;
+                    }
+                }
 
-            size_t value_index = 0;
-            for(const std::string & filter_value: a_filter.values) {
-                int64_t bool_int64 = (filter_value == "1") ? 1 : 0;
-                if(a_filter.comparators[value_index] == NOT_EQUALS) {
-                    uint32_t* to_exclude_ids = nullptr;
-                    size_t to_exclude_ids_len = 0;
-                    num_tree->search(EQUALS, bool_int64, &to_exclude_ids, to_exclude_ids_len);
+                return false;
+            };
+        }
+    } else if(f.is_string()) {
+        auto value_posting_lists = std::make_shared<std::vector<std::vector<void*>>>();
+        const size_t matching_ids = estimate_string_filter_ids(a_filter, f, *value_posting_lists);
 
-                    auto all_ids = seq_ids->uncompress();
-                    auto all_ids_size = seq_ids->num_ids();
+        if(a_filter.comparators[0] == NOT_EQUALS) {
+            // only the (usually few) documents that contain the given values need to be found to check an ID
+            estimated_ids -= std::min(estimated_ids, matching_ids);
 
-                    uint32_t* excluded_ids = nullptr;
-                    size_t excluded_ids_len = 0;
+            auto matched_ids = std::make_shared<id_bitmap_t>();
+            auto matches_computed = std::make_shared<std::once_flag>();
 
-                    excluded_ids_len = ArrayUtils::exclude_scalar(all_ids, all_ids_size, to_exclude_ids,
-                                                                  to_exclude_ids_len, &excluded_ids);
+            // IDs are checked concurrently by the search threads
+            checker = [this, &a_filter, &f, matched_ids, matches_computed](uint32_t seq_id) {
+                std::call_once(*matches_computed, [&]() {
+                    compute_string_filter_matches(a_filter, f, *matched_ids);
+                });
 
-                    delete [] all_ids;
-                    delete [] to_exclude_ids;
+                return !matched_ids->contains(seq_id);
+            };
+        } else {
+            estimated_ids = matching_ids;
 
-                    uint32_t *out = nullptr;
-                    result_ids_len = ArrayUtils::or_scalar(result_ids, result_ids_len,
-                                                           excluded_ids, excluded_ids_len, &out);
-                    delete [] result_ids;
-                    result_ids = out;
-                    delete [] excluded_ids;
-                } else {
-                    num_tree->search(a_filter.comparators[value_index], bool_int64, &result_ids, result_ids_len);
-                }
+            // a document matches a value when it is found in the posting lists of all the tokens of the value
+            const bool exact_match = (a_filter.comparators[0] == EQUALS);
+            const bool is_array = f.is_array();
 
-                value_index++;
+            check_cost = 0;
+            for(const auto& posting_lists: *value_posting_lists) {
+                check_cost += posting_lists.size();
             }
 
-        } else if(f.is_geopoint()) {
-            for(const std::string& filter_value: a_filter.values) {
-                std::vector<uint32_t> geo_result_ids;
-
-                std::vector<std::string> filter_value_parts;
-                StringUtils::split(filter_value, filter_value_parts, ",");  // x, y, 2, km (or) list of points
+            if(exact_match) {
+                // verifying token positions is costlier than a lookup
+                check_cost *= 4;
+            }
 
-                bool is_polygon = StringUtils::is_float(filter_value_parts.back());
-                S2Region* query_region;
+            check_cost = std::max<size_t>(1, check_cost);
 
-                if(is_polygon) {
-                    const int num_verts = int(filter_value_parts.size()) / 2;
-                    std::vector<S2Point> vertices;
-                    double sum = 0.0;
+            checker = [value_posting_lists, exact_match, is_array](uint32_t seq_id) {
+                for(const auto& posting_lists: *value_posting_lists) {
+                    bool found_all_tokens = true;
 
-                    for(size_t point_index = 0; point_index < size_t(num_verts); point_index++) {
-                        double lat = std::stod(filter_value_parts[point_index * 2]);
-                        double lon = std::stod(filter_value_parts[point_index * 2 + 1]);
-                        S2Point vertex = S2LatLng::FromDegrees(lat, lon).ToPoint();
-                        vertices.emplace_back(vertex);
+                    for(void* posting_list: posting_lists) {
+                        if(!posting_t::contains(posting_list, seq_id)) {
+                            found_all_tokens = false;
+                            break;
+                        }
                     }
 
-                    auto loop = new S2Loop(vertices, S2Debug::DISABLE);
-                    loop->Normalize(); // if loop is not CCW but CW, change to CCW.
-
-                    S2Error error;
-                    if (loop->FindValidationError(&error)) {
-                        LOG(ERROR) << "Query vertex is bad, skipping. Error: " << error;
-                        delete loop;
+                    if(!found_all_tokens) {
                         continue;
-                    } else {
-                        query_region = loop;
                     }
-                } else {
-                    double radius = std::stof(filter_value_parts[2]);
-                    const auto& unit = filter_value_parts[3];
 
-                    if(unit == "km") {
-                        radius *= 1000;
-                    } else {
-                        // assume "mi" (validated upstream)
-                        radius *= 1609.34;
+                    if(!exact_match) {
+                        return true;
                     }
 
-                    S1Angle query_radius = S1Angle::Radians(S2Earth::MetersToRadians(radius));
-                    double query_lat = std::stod(filter_value_parts[0]);
-                    double query_lng = std::stod(filter_value_parts[1]);
-                    S2Point center = S2LatLng::FromDegrees(query_lat, query_lng).ToPoint();
-                    query_region = new S2Cap(center, query_radius);
-                }
-
-                S2RegionTermIndexer::Options options;
-                options.set_index_contains_points_only(true);
-                S2RegionTermIndexer indexer(options);
+                    uint32_t exact_id;
+                    uint32_t* exact_ids = &exact_id;
+                    size_t num_exact_ids = 0;
+                    posting_t::get_exact_matches(posting_lists, is_array, &seq_id, 1, exact_ids, num_exact_ids);
 
-                for (const auto& term : indexer.GetQueryTerms(*query_region, "")) {
-                    auto geo_index = geopoint_index.at(a_filter.field_name);
-                    const auto& ids_it = geo_index->find(term);
-                    if(ids_it != geo_index->end()) {
-                        geo_result_ids.insert(geo_result_ids.end(), ids_it->second.begin(), ids_it->second.end());
+                    if(num_exact_ids != 0) {
+                        return true;
                     }
                 }
 
-                gfx::timsort(geo_result_ids.begin(), geo_result_ids.end());
-                geo_result_ids.erase(std::unique( geo_result_ids.begin(), geo_result_ids.end() ), geo_result_ids.end());
+                return false;
+            };
+        }
+    }
+
+    return std::make_unique<filter_leaf_iterator_t>(std::move(materializer), std::move(checker),
+                                                    estimated_ids, check_cost);
+}
 
-                // `geo_result_ids` will contain all IDs that are within approximately within query radius
-                // we still need to do another round of exact filtering on them
+bool Index::compare_filter_value(const NUM_COMPARATOR comparator, const int64_t doc_value, const int64_t value) {
+    switch(comparator) {
+        case LESS_THAN:
+            return doc_value < value;
+        case LESS_THAN_EQUALS:
+            return doc_value <= value;
+        case EQUALS:
+            return doc_value == value;
+        case GREATER_THAN:
+            return doc_value > value;
+        case GREATER_THAN_EQUALS:
+            return doc_value >= value;
+        default:
+            return false;
+    }
+}
 
-                std::vector<uint32_t> exact_geo_result_ids;
+std::string Index::get_filter_cache_key(const filter& a_filter) {
+    std::vector<std::string> conditions;
 
-                if(f.is_single_geopoint()) {
-                    spp::sparse_hash_map<uint32_t, int64_t>* sort_field_index = sort_index.at(f.name);
+    for(size_t fi = 0; fi < a_filter.values.size(); fi++) {
+        // string filters have a single comparator for all their values
+        const NUM_COMPARATOR comparator = (fi < a_filter.comparators.size()) ? a_filter.comparators[fi] :
+                                          a_filter.comparators.back();
+        std::string condition = std::to_string(comparator) + ":" + a_filter.values[fi];
+        if(comparator == RANGE_INCLUSIVE && fi+1 < a_filter.values.size()) {
+            condition += filter::RANGE_OPERATOR() + a_filter.values[++fi];
+        }
 
-                    for(auto result_id: geo_result_ids) {
-                        // no need to check for existence of `result_id` because of indexer based pre-filtering above
-                        int64_t lat_lng = sort_field_index->at(result_id);
-                        S2LatLng s2_lat_lng;
-                        GeoPoint::unpack_lat_lng(lat_lng, s2_lat_lng);
-                        if (query_region->Contains(s2_lat_lng.ToPoint())) {
-                            exact_geo_result_ids.push_back(result_id);
-                        }
-                    }
-                } else {
-                    spp::sparse_hash_map<uint32_t, int64_t*>* geo_field_index = geo_array_index.at(f.name);
+        conditions.push_back(std::move(condition));
+    }
 
-                    for(auto result_id: geo_result_ids) {
-                        int64_t* lat_lngs = geo_field_index->at(result_id);
+    std::sort(conditions.begin(), conditions.end());
 
-                        bool point_found = false;
+    std::string cache_key = a_filter.field_name;
+    for(const std::string& condition: conditions) {
+        cache_key += '\x1f';
+        cache_key += condition;
+    }
 
-                        // any one point should exist
-                        for(size_t li = 0; li < lat_lngs[0]; li++) {
-                            int64_t lat_lng = lat_lngs[li + 1];
-                            S2LatLng s2_lat_lng;
-                            GeoPoint::unpack_lat_lng(lat_lng, s2_lat_lng);
-                            if (query_region->Contains(s2_lat_lng.ToPoint())) {
-                                point_found = true;
-                                break;
-                            }
-                        }
+    return cache_key;
+}
 
-                        if(point_found) {
-                            exact_geo_result_ids.push_back(result_id);
-                        }
-                    }
-                }
+std::shared_ptr<const id_bitmap_t> Index::get_cached_filter_ids(const std::string& cache_key, const filter& a_filter,
+                                                                uint64_t& field_epoch, uint64_t& docs_epoch) const {
+    std::unique_lock lock(filter_cache_mutex);
 
-                uint32_t *out = nullptr;
-                result_ids_len = ArrayUtils::or_scalar(&exact_geo_result_ids[0], exact_geo_result_ids.size(),
-                                                       result_ids, result_ids_len, &out);
+    const auto field_epoch_it = field_write_epochs.find(a_filter.field_name);
+    field_epoch = (field_epoch_it == field_write_epochs.end()) ? 0 : field_epoch_it->second;
 
-                delete [] result_ids;
-                result_ids = out;
+    const auto docs_epoch_it = field_write_epochs.find("id");
+    docs_epoch = (docs_epoch_it == field_write_epochs.end()) ? 0 : docs_epoch_it->second;
 
-                delete query_region;
-            }
+    // a negated clause matches documents that don't contain the field, so it changes with the set of documents
+    const bool depends_on_all_docs = std::find(a_filter.comparators.begin(), a_filter.comparators.end(),
+                                               NOT_EQUALS) != a_filter.comparators.end();
+
+    auto hit_it = filter_result_cache.find(cache_key);
+    if(hit_it != filter_result_cache.end()) {
+        const cached_filter_result_t& cached_result = hit_it.value();
+        if(cached_result.field_epoch == field_epoch &&
+           (!depends_on_all_docs || cached_result.docs_epoch == docs_epoch)) {
+            filter_cache_hits++;
+            return cached_result.ids;
+        }
+    }
 
-        } else if(f.is_string()) {
-            art_tree* t = search_index.at(a_filter.field_name);
+    // a clause that is only checked is never cached, so a miss is counted once its result is computed
+    return nullptr;
+}
 
-            uint32_t* ids = nullptr;
-            size_t ids_size = 0;
+void Index::cache_filter_ids(const std::string& cache_key, const uint64_t field_epoch, const uint64_t docs_epoch,
+                             const id_bitmap_t& ids) const {
+    cached_filter_result_t cached_result;
+    cached_result.ids = std::make_shared<const id_bitmap_t>(ids);
+    cached_result.field_epoch = field_epoch;
+    cached_result.docs_epoch = docs_epoch;
 
-            for(const std::string & filter_value: a_filter.values) {
-                uint32_t* strt_ids = nullptr;
-                size_t strt_ids_size = 0;
+    std::unique_lock lock(filter_cache_mutex);
+    filter_cache_misses++;
+    filter_result_cache.insert(cache_key, cached_result);
+}
 
-                std::vector<void*> posting_lists;
+void Index::bump_write_epoch(const std::string& field_name) {
+    std::unique_lock lock(filter_cache_mutex);
+    field_write_epochs[field_name]++;
+    write_epoch++;
+}
 
-                // there could be multiple tokens in a filter value, which we have to treat as ANDs
-                // e.g. country: South Africa
+std::string Index::get_facet_cache_key(const std::vector<filter>& filters, const facet& a_facet) {
+    std::vector<std::string> clause_keys;
+    for(const filter& a_filter: filters) {
+        clause_keys.push_back(get_filter_cache_key(a_filter));
+    }
 
-                Tokenizer tokenizer(filter_value, true, false, f.locale, symbols_to_index, token_separators);
+    std::sort(clause_keys.begin(), clause_keys.end());
 
-                std::string str_token;
-                size_t token_index = 0;
-                std::vector<std::string> str_tokens;
+    std::string cache_key = a_facet.field_name;
+    for(const facet_range_t& range: a_facet.ranges) {
+        cache_key += '\x1f';
+        cache_key += range.label + '\x1f' + std::to_string(range.start) + ".." + std::to_string(range.end);
+    }
 
-                while(tokenizer.next(str_token, token_index)) {
-                    str_tokens.push_back(str_token);
+    for(const std::string& clause_key: clause_keys) {
+        cache_key += '\x1e';
+        cache_key += clause_key;
+    }
 
-                    art_leaf* leaf = (art_leaf *) art_search(t, (const unsigned char*) str_token.c_str(),
-                                                             str_token.length()+1);
-                    if(leaf == nullptr) {
-                        continue;
-                    }
+    return cache_key;
+}
 
-                    posting_lists.push_back(leaf->values);
-                }
+std::shared_ptr<const cached_facet_result_t> Index::get_cached_facet_result(const std::string& cache_key,
+                                                                            uint64_t& epoch) const {
+    std::unique_lock lock(filter_cache_mutex);
+    epoch = write_epoch;
 
-                // For NOT_EQUALS alone, it is okay for none of the results to match prior to negation
-                // e.g. field:!= [RANDOM_NON_EXISTING_STRING]
-                if(a_filter.comparators[0] != NOT_EQUALS && posting_lists.size() != str_tokens.size()) {
-                    continue;
-                }
+    auto hit_it = facet_result_cache.find(cache_key);
+    if(hit_it != facet_result_cache.end() && hit_it.value()->write_epoch == epoch) {
+        return hit_it.value();
+    }
 
-                std::vector<uint32_t> result_id_vec;
-                posting_t::intersect(posting_lists, result_id_vec);
-                if(!result_id_vec.empty()) {
-                    strt_ids = new uint32_t [result_id_vec.size()];
-                    std::copy(result_id_vec.begin(), result_id_vec.end(), strt_ids);
-                    strt_ids_size = result_id_vec.size();
-                }
+    return nullptr;
+}
+
+void Index::cache_facet_result(const std::string& cache_key, const uint64_t epoch, const facet& a_facet) const {
+    if(a_facet.result_map.size() > FACET_RESULT_CACHE_MAX_VALUES) {
+        return ;
+    }
 
-                if(a_filter.comparators[0] == EQUALS || a_filter.comparators[0] == NOT_EQUALS) {
-                    // need to do exact match (unlike CONTAINS)
-                    uint32_t* exact_strt_ids = new uint32_t[strt_ids_size];
-                    size_t exact_strt_size = 0;
+    auto cached_result = std::make_shared<cached_facet_result_t>();
+    cached_result->result_map = a_facet.result_map;
+    cached_result->stats = a_facet.stats;
+    cached_result->range_counts = a_facet.range_counts;
+    cached_result->write_epoch = epoch;
 
-                    posting_t::get_exact_matches(posting_lists, f.is_array(), strt_ids, strt_ids_size,
-                                                 exact_strt_ids, exact_strt_size);
+    std::unique_lock lock(filter_cache_mutex);
+    facet_result_cache.insert(cache_key, cached_result);
+}
 
-                    delete[] strt_ids;
-                    strt_ids = exact_strt_ids;
-                    strt_ids_size = exact_strt_size;
-                }
+std::string Index::get_filters_cache_key(const std::vector<filter>& filters) {
+    std::vector<std::string> clause_keys;
+    for(const filter& a_filter: filters) {
+        clause_keys.push_back(get_filter_cache_key(a_filter));
+    }
 
-                if(a_filter.comparators[0] == NOT_EQUALS) {
-                    // exclude records from existing IDs (from previous filters or ALL records)
-                    // upstream will guarantee that NOT_EQUALS is placed right at the end of filters list
-                    uint32_t* excluded_strt_ids = nullptr;
-                    size_t excluded_strt_size = 0;
+    std::sort(clause_keys.begin(), clause_keys.end());
+    return StringUtils::join(clause_keys, "\x1e");
+}
 
-                    if(ids == nullptr) {
-                        if(filter_ids == nullptr) {
-                            ids = seq_ids->uncompress();
-                            ids_size = seq_ids->num_ids();
-                        } else {
-                            ids = filter_ids;
-                            ids_size = filter_ids_length;
-                        }
-                    }
+std::shared_ptr<const typeahead_session_t> Index::get_typeahead_session(const std::string& session_id,
+                                                                        uint64_t& epoch) const {
+    std::unique_lock lock(filter_cache_mutex);
+    epoch = write_epoch;
 
-                    excluded_strt_size = ArrayUtils::exclude_scalar(ids, ids_size, strt_ids,
-                                                                    strt_ids_size, &excluded_strt_ids);
+    auto session_it = typeahead_sessions.find(session_id);
+    if(session_it == typeahead_sessions.end()) {
+        return nullptr;
+    }
 
-                    if(filter_ids == nullptr) {
-                        // means we had to uncompress `seq_ids` so need to free that
-                        delete [] ids;
-                    }
+    const auto& session = session_it.value();
+    if(session->write_epoch != epoch || session->expires_at < std::chrono::steady_clock::now()) {
+        return nullptr;
+    }
 
-                    ids = excluded_strt_ids;
-                    ids_size = excluded_strt_size;
-                    delete[] strt_ids;
-                } else {
-                    // Otherwise, we just ensure that given record contains tokens in the filter query
-                    uint32_t* out = nullptr;
-                    ids_size = ArrayUtils::or_scalar(ids, ids_size, strt_ids, strt_ids_size, &out);
-                    delete[] strt_ids;
-                    delete[] ids;
-                    ids = out;
-                }
-            }
+    return session;
+}
 
-            result_ids = ids;
-            result_ids_len = ids_size;
+void Index::save_typeahead_session(const std::string& session_id, std::shared_ptr<typeahead_session_t> session) const {
+    session->expires_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(TYPEAHEAD_SESSION_TTL_MS);
+
+    std::unique_lock lock(filter_cache_mutex);
+    typeahead_sessions.insert(session_id, session);
+}
+
+bool Index::narrow_typeahead_leaves(const token_leaves_t& session_leaves, const std::string& token,
+                                    const std::set<std::string>& exclude_tokens, std::vector<art_leaf*>& leaves) {
+    // candidates of a prefix searched without typos are keyed by the prefix followed by this suffix
+    const std::string prefix_key_suffix = std::string(1, '\x1f') + "0p";
+
+    const std::vector<art_leaf*>* prefix_leaves = nullptr;
+    size_t prefix_len = 0;
+
+    for(const auto& kv: session_leaves) {
+        const std::string& key = kv.first;
+        if(key.size() <= prefix_key_suffix.size() ||
+           key.compare(key.size() - prefix_key_suffix.size(), prefix_key_suffix.size(), prefix_key_suffix) != 0) {
+            continue;
         }
 
-        if(i == 0) {
-            filter_ids = result_ids;
-            filter_ids_length = result_ids_len;
-        } else {
-            uint32_t* filtered_results = nullptr;
-            filter_ids_length = ArrayUtils::and_scalar(filter_ids, filter_ids_length, result_ids,
-                                                       result_ids_len, &filtered_results);
-            delete [] result_ids;
-            delete [] filter_ids;
-            filter_ids = filtered_results;
+        // the longest prefix of the token is the closest
+        const size_t key_prefix_len = key.size() - prefix_key_suffix.size();
+        if(key_prefix_len > token.size() || key_prefix_len <= prefix_len ||
+           token.compare(0, key_prefix_len, key, 0, key_prefix_len) != 0) {
+            continue;
         }
+
+        prefix_leaves = &kv.second;
+        prefix_len = key_prefix_len;
     }
 
-    if(filter_ids_length == 0) {
-        delete [] filter_ids;
-        filter_ids = nullptr;
+    // a search that hit the limit might have missed tokens that match the longer prefix
+    if(prefix_leaves == nullptr || prefix_leaves->size() >= FUZZY_SEARCH_MAX_WORDS) {
+        return false;
     }
 
-    /*long long int timeMillis =
-            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+    for(art_leaf* leaf: *prefix_leaves) {
+        if(leaf->key_len - 1 < token.size() || memcmp(leaf->key, token.c_str(), token.size()) != 0) {
+            continue;
+        }
 
-    LOG(INFO) << "Time taken for filtering: " << timeMillis << "ms";*/
+        std::string tok(reinterpret_cast<char*>(leaf->key), leaf->key_len - 1);
+        if(exclude_tokens.count(tok) == 0) {
+            leaves.push_back(leaf);
+        }
+    }
+
+    // like in a fresh search, the token itself comes first
+    std::stable_partition(leaves.begin(), leaves.end(), [&token](const art_leaf* leaf) {
+        return leaf->key_len - 1 == token.size();
+    });
+
+    return true;
 }
 
+void Index::get_filter_cache_stats(filter_cache_stats_t& stats) const {
+    std::unique_lock lock(filter_cache_mutex);
 
-void Index::do_filtering_with_lock(uint32_t*& filter_ids, uint32_t& filter_ids_length,
-                                   const std::vector<filter>& filters) const {
-    std::shared_lock lock(mutex);
-    do_filtering(filter_ids, filter_ids_length, filters, false);
+    stats.hits += filter_cache_hits;
+    stats.misses += filter_cache_misses;
+    stats.num_entries += filter_result_cache.size();
+
+    for(const auto& entry: filter_result_cache) {
+        stats.memory_used_bytes += entry.key().size() + entry.value().ids->memory_used();
+    }
 }
 
-void Index::run_search(search_args* search_params) {
-    search(search_params->field_query_tokens,
-           search_params->search_fields,
-           search_params->filters, search_params->facets, search_params->facet_query,
+void Index::bump_dictionary_epoch(const std::string& field_name) {
+    std::unique_lock lock(dictionary_epochs_mutex);
+    field_dictionary_epochs[field_name]++;
+}
+
+uint64_t Index::get_dictionary_epoch(const std::string& field_name) const {
+    std::unique_lock lock(dictionary_epochs_mutex);
+    const auto epoch_it = field_dictionary_epochs.find(field_name);
+    return (epoch_it == field_dictionary_epochs.end()) ? 0 : epoch_it->second;
+}
+
+void Index::fuzzy_search_field(const std::string& field_name, const std::string& token, const int cost,
+                               const bool prefix_search, const token_ordering token_order,
+                               filter_iterator_t* filter_it,
+                               const std::set<std::string>& exclude_tokens, std::vector<art_leaf*>& leaves) const {
+    art_tree* t = search_index.at(field_name);
+    const auto term = (const unsigned char *) token.c_str();
+    const int term_len = prefix_search ? (int) token.length() : (int) token.length() + 1;
+
+    const std::string cache_key = field_name + '\x1f' + token + '\x1f' + std::to_string(cost) +
+                                  (prefix_search ? "p" : "");
+    fuzzy_cache_shard_t& shard = fuzzy_cache_shards[std::hash<std::string>{}(cache_key) % FUZZY_CACHE_NUM_SHARDS];
+
+    // read before the candidates are collected, so that tokens added meanwhile invalidate them
+    const uint64_t dictionary_epoch = get_dictionary_epoch(field_name);
+    std::shared_ptr<const fuzzy_candidates_t> candidates;
+
+    {
+        std::unique_lock lock(shard.mutex);
+        auto hit_it = shard.candidates.find(cache_key);
+        if(hit_it != shard.candidates.end() && hit_it.value()->dictionary_epoch == dictionary_epoch) {
+            shard.hits++;
+            candidates = hit_it.value();
+        } else {
+            shard.misses++;
+        }
+    }
+
+    if(candidates == nullptr) {
+        auto new_candidates = std::make_shared<fuzzy_candidates_t>();
+        new_candidates->dictionary_epoch = dictionary_epoch;
+
+        if(!art_fuzzy_candidates(t, term, term_len, cost, cost, prefix_search, FUZZY_CACHE_MAX_LEAVES,
+                                 new_candidates->leaves)) {
+            art_fuzzy_search(t, term, term_len, cost, cost, FUZZY_SEARCH_MAX_WORDS, token_order, prefix_search,
+                             filter_it, leaves, exclude_tokens);
+            return ;
+        }
+
+        candidates = new_candidates;
+
+        std::unique_lock lock(shard.mutex);
+        shard.candidates.insert(cache_key, candidates);
+    }
+
+    art_fuzzy_search_candidates(t, candidates->leaves, term, term_len, cost, FUZZY_SEARCH_MAX_WORDS, token_order,
+                                prefix_search, filter_it, leaves, exclude_tokens);
+}
+
+void Index::get_fuzzy_cache_stats(fuzzy_cache_stats_t& stats) const {
+    for(auto& shard: fuzzy_cache_shards) {
+        std::unique_lock lock(shard.mutex);
+
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.num_entries += shard.candidates.size();
+
+        for(const auto& entry: shard.candidates) {
+            stats.memory_used_bytes += entry.key().size() + sizeof(fuzzy_candidates_t) +
+                                       entry.value()->leaves.size() * sizeof(art_leaf*);
+        }
+    }
+}
+
+void Index::get_facet_values(const std::string& field_name, const std::vector<uint64_t>& hashes,
+                             std::unordered_map<uint64_t, std::string>& values) const {
+    std::shared_lock lock(mutex);
+
+    const auto field_facet_index_it = facet_index_v4.find(field_name);
+    if(field_facet_index_it == facet_index_v4.end()) {
+        return ;
+    }
+
+    for(uint64_t hash: hashes) {
+        std::string value;
+        if(field_facet_index_it->second->get_value(hash, value)) {
+            values.emplace(hash, std::move(value));
+        }
+    }
+}
+
+size_t Index::estimate_string_filter_ids(const filter& a_filter, const field& f,
+                                         std::vector<std::vector<void*>>& value_posting_lists) const {
+    // a document has to contain every token of a value, so the rarest token bounds the matches of a value
+    art_tree* t = search_index.at(a_filter.field_name);
+    size_t estimated_ids = 0;
+
+    for(const std::string& filter_value: a_filter.values) {
+        Tokenizer tokenizer(filter_value, true, false, f.locale, symbols_to_index, token_separators);
+
+        std::string str_token;
+        size_t token_index = 0;
+        size_t value_ids = SIZE_MAX;
+        std::vector<void*> posting_lists;
+
+        while(tokenizer.next(str_token, token_index)) {
+            art_leaf* leaf = (art_leaf *) art_search(t, (const unsigned char*) str_token.c_str(),
+                                                     str_token.length()+1);
+            if(leaf == nullptr) {
+                value_ids = 0;
+                break;
+            }
+
+            posting_lists.push_back(leaf->values);
+            value_ids = std::min<size_t>(value_ids, posting_t::num_ids(leaf->values));
+        }
+
+        if(value_ids != 0 && value_ids != SIZE_MAX) {
+            estimated_ids += value_ids;
+            value_posting_lists.push_back(std::move(posting_lists));
+        }
+    }
+
+    return estimated_ids;
+}
+
+size_t Index::estimate_numeric_filter_ids(const filter& a_filter, const field& f) const {
+    // ranges that span too many distinct values are not counted, to keep planning cheap
+    static constexpr size_t MAX_VALUES_TO_COUNT = 1000;
+
+    num_tree_t* num_tree = numerical_index.at(a_filter.field_name);
+    const size_t num_seq_ids = seq_ids->num_ids();
+    size_t estimated_ids = 0;
+
+    const auto parse_value = [&f](const std::string& filter_value) -> int64_t {
+        if(f.is_bool()) {
+            return (filter_value == "1") ? 1 : 0;
+        } else if(f.is_float()) {
+            return float_to_in64_t((float) std::atof(filter_value.c_str()));
+        }
+
+        return (int64_t) std::stol(filter_value);
+    };
+
+    for(size_t fi = 0; fi < a_filter.values.size(); fi++) {
+        const int64_t value = parse_value(a_filter.values[fi]);
+        int64_t start = value, end = value;
+        bool negate = false;
+
+        switch(a_filter.comparators[fi]) {
+            case LESS_THAN:
+                start = INT64_MIN;
+                end = (value == INT64_MIN) ? value : value - 1;
+                break;
+            case LESS_THAN_EQUALS:
+                start = INT64_MIN;
+                break;
+            case GREATER_THAN:
+                start = (value == INT64_MAX) ? value : value + 1;
+                end = INT64_MAX;
+                break;
+            case GREATER_THAN_EQUALS:
+                end = INT64_MAX;
+                break;
+            case RANGE_INCLUSIVE:
+                if(fi+1 < a_filter.values.size()) {
+                    end = parse_value(a_filter.values[++fi]);
+                }
+                break;
+            case NOT_EQUALS:
+                negate = true;
+                break;
+            default:
+                break;
+        }
+
+        size_t value_ids = num_tree->count(start, end, MAX_VALUES_TO_COUNT);
+        if(value_ids == SIZE_MAX) {
+            return num_seq_ids;
+        }
+
+        if(negate) {
+            value_ids = num_seq_ids - std::min(num_seq_ids, value_ids);
+        }
+
+        estimated_ids += value_ids;
+    }
+
+    return std::min(estimated_ids, num_seq_ids);
+}
+
+size_t Index::estimate_geo_filter_ids(const std::string& field_name,
+                                      const std::vector<std::unique_ptr<S2Region>>& regions) const {
+    S2RegionTermIndexer::Options options;
+    options.set_index_contains_points_only(true);
+    S2RegionTermIndexer indexer(options);
+
+    auto geo_index = geopoint_index.at(field_name);
+    size_t estimated_ids = 0;
+
+    for(const auto& query_region: regions) {
+        for(const auto& term : indexer.GetQueryTerms(*query_region, "")) {
+            const auto& ids_it = geo_index->find(term);
+            if(ids_it != geo_index->end()) {
+                estimated_ids += ids_it->second.size();
+            }
+        }
+    }
+
+    return estimated_ids;
+}
+
+S2Region* Index::new_geo_filter_region(const std::string& filter_value) {
+    std::vector<std::string> filter_value_parts;
+    StringUtils::split(filter_value, filter_value_parts, ",");  // x, y, 2, km (or) list of points
+
+    bool is_polygon = StringUtils::is_float(filter_value_parts.back());
+
+    if(is_polygon) {
+        const int num_verts = int(filter_value_parts.size()) / 2;
+        std::vector<S2Point> vertices;
+
+        for(size_t point_index = 0; point_index < size_t(num_verts); point_index++) {
+            double lat = std::stod(filter_value_parts[point_index * 2]);
+            double lon = std::stod(filter_value_parts[point_index * 2 + 1]);
+            S2Point vertex = S2LatLng::FromDegrees(lat, lon).ToPoint();
+            vertices.emplace_back(vertex);
+        }
+
+        auto loop = new S2Loop(vertices, S2Debug::DISABLE);
+        loop->Normalize(); // if loop is not CCW but CW, change to CCW.
+
+        S2Error error;
+        if (loop->FindValidationError(&error)) {
+            LOG(ERROR) << "Query vertex is bad, skipping. Error: " << error;
+            delete loop;
+            return nullptr;
+        }
+
+        return loop;
+    }
+
+    double radius = std::stof(filter_value_parts[2]);
+    const auto& unit = filter_value_parts[3];
+
+    if(unit == "km") {
+        radius *= 1000;
+    } else {
+        // assume "mi" (validated upstream)
+        radius *= 1609.34;
+    }
+
+    S1Angle query_radius = S1Angle::Radians(S2Earth::MetersToRadians(radius));
+    double query_lat = std::stod(filter_value_parts[0]);
+    double query_lng = std::stod(filter_value_parts[1]);
+    S2Point center = S2LatLng::FromDegrees(query_lat, query_lng).ToPoint();
+    return new S2Cap(center, query_radius);
+}
+
+void Index::compute_filter_ids(const filter& a_filter, id_bitmap_t& result_bitmap) const {
+    const field& f = search_schema.at(a_filter.field_name);
+
+    if(f.is_integer()) {
+        auto num_tree = numerical_index.at(a_filter.field_name);
+
+        for(size_t fi=0; fi < a_filter.values.size(); fi++) {
+            const std::string & filter_value = a_filter.values[fi];
+            int64_t value = (int64_t) std::stol(filter_value);
+
+            if(a_filter.comparators[fi] == RANGE_INCLUSIVE && fi+1 < a_filter.values.size()) {
+                const std::string& next_filter_value = a_filter.values[fi+1];
+                int64_t range_end_value = (int64_t) std::stol(next_filter_value);
+                num_tree->range_inclusive_search(value, range_end_value, result_bitmap);
+                fi++;
+            } else {
+                num_tree->search(a_filter.comparators[fi], value, result_bitmap);
+            }
+        }
+
+    } else if(f.is_float()) {
+        auto num_tree = numerical_index.at(a_filter.field_name);
+
+        for(size_t fi=0; fi < a_filter.values.size(); fi++) {
+            const std::string & filter_value = a_filter.values[fi];
+            float value = (float) std::atof(filter_value.c_str());
+            int64_t float_int64 = float_to_in64_t(value);
+
+            if(a_filter.comparators[fi] == RANGE_INCLUSIVE && fi+1 < a_filter.values.size()) {
+                const std::string& next_filter_value = a_filter.values[fi+1];
+                int64_t range_end_value = float_to_in64_t((float) std::atof(next_filter_value.c_str()));
+                num_tree->range_inclusive_search(float_int64, range_end_value, result_bitmap);
+                fi++;
+            } else {
+                num_tree->search(a_filter.comparators[fi], float_int64, result_bitmap);
+            }
+        }
+
+    } else if(f.is_bool()) {
+        auto num_tree = numerical_index.at(a_filter.field_name);
+
+        size_t value_index = 0;
+        for(const std::string & filter_value: a_filter.values) {
+            int64_t bool_int64 = (filter_value == "1") ? 1 : 0;
+            if(a_filter.comparators[value_index] == NOT_EQUALS) {
+                id_bitmap_t to_exclude_ids;
+                num_tree->search(EQUALS, bool_int64, to_exclude_ids);
+
+                auto all_ids = seq_ids->uncompress();
+                id_bitmap_t excluded_ids(all_ids, seq_ids->num_ids());
+                delete [] all_ids;
+
+                excluded_ids.and_not(to_exclude_ids);
+                result_bitmap.or_with(excluded_ids);
+            } else {
+                num_tree->search(a_filter.comparators[value_index], bool_int64, result_bitmap);
+            }
+
+            value_index++;
+        }
+
+    } else if(f.is_geopoint()) {
+        for(const std::string& filter_value: a_filter.values) {
+            std::vector<uint32_t> geo_result_ids;
+
+            S2Region* query_region = new_geo_filter_region(filter_value);
+            if(query_region == nullptr) {
+                continue;
+            }
+
+            S2RegionTermIndexer::Options options;
+            options.set_index_contains_points_only(true);
+            S2RegionTermIndexer indexer(options);
+
+            for (const auto& term : indexer.GetQueryTerms(*query_region, "")) {
+                auto geo_index = geopoint_index.at(a_filter.field_name);
+                const auto& ids_it = geo_index->find(term);
+                if(ids_it != geo_index->end()) {
+                    geo_result_ids.insert(geo_result_ids.end(), ids_it->second.begin(), ids_it->second.end());
+                }
+            }
+
+            gfx::timsort(geo_result_ids.begin(), geo_result_ids.end());
+            geo_result_ids.erase(std::unique( geo_result_ids.begin(), geo_result_ids.end() ), geo_result_ids.end());
+
+            // `geo_result_ids` will contain all IDs that are within approximately within query radius
+            // we still need to do another round of exact filtering on them
+
+            std::vector<uint32_t> exact_geo_result_ids;
+
+            if(f.is_single_geopoint()) {
+                sort_values_t* sort_field_index = sort_index.at(f.name);
+
+                for(auto result_id: geo_result_ids) {
+                    // `result_id` will exist because of indexer based pre-filtering above
+                    int64_t lat_lng;
+                    if(!sort_field_index->get(result_id, lat_lng)) {
+                        continue;
+                    }
+                    S2LatLng s2_lat_lng;
+                    GeoPoint::unpack_lat_lng(lat_lng, s2_lat_lng);
+                    if (query_region->Contains(s2_lat_lng.ToPoint())) {
+                        exact_geo_result_ids.push_back(result_id);
+                    }
+                }
+            } else {
+                spp::sparse_hash_map<uint32_t, int64_t*>* geo_field_index = geo_array_index.at(f.name);
+
+                for(auto result_id: geo_result_ids) {
+                    int64_t* lat_lngs = geo_field_index->at(result_id);
+
+                    bool point_found = false;
+
+                    // any one point should exist
+                    for(size_t li = 0; li < lat_lngs[0]; li++) {
+                        int64_t lat_lng = lat_lngs[li + 1];
+                        S2LatLng s2_lat_lng;
+                        GeoPoint::unpack_lat_lng(lat_lng, s2_lat_lng);
+                        if (query_region->Contains(s2_lat_lng.ToPoint())) {
+                            point_found = true;
+                            break;
+                        }
+                    }
+
+                    if(point_found) {
+                        exact_geo_result_ids.push_back(result_id);
+                    }
+                }
+            }
+
+            result_bitmap.add_many(exact_geo_result_ids.data(), exact_geo_result_ids.size());
+
+            delete query_region;
+        }
+
+    } else if(f.is_string()) {
+        id_bitmap_t matched_ids;
+        compute_string_filter_matches(a_filter, f, matched_ids);
+
+        if(a_filter.comparators[0] == NOT_EQUALS) {
+            // exclude records from ALL records: the other clauses are intersected by the filter iterator
+            uint32_t* all_ids = seq_ids->uncompress();
+            result_bitmap = id_bitmap_t(all_ids, seq_ids->num_ids());
+            delete [] all_ids;
+
+            result_bitmap.and_not(matched_ids);
+        } else {
+            // Otherwise, we just ensure that given record contains tokens in the filter query
+            result_bitmap = std::move(matched_ids);
+        }
+    }
+}
+
+void Index::compute_string_filter_matches(const filter& a_filter, const field& f, id_bitmap_t& matched_ids) const {
+    art_tree* t = search_index.at(a_filter.field_name);
+
+    for(const std::string & filter_value: a_filter.values) {
+        uint32_t* strt_ids = nullptr;
+        size_t strt_ids_size = 0;
+
+        std::vector<void*> posting_lists;
+
+        // there could be multiple tokens in a filter value, which we have to treat as ANDs
+        // e.g. country: South Africa
+
+        Tokenizer tokenizer(filter_value, true, false, f.locale, symbols_to_index, token_separators);
+
+        std::string str_token;
+        size_t token_index = 0;
+        std::vector<std::string> str_tokens;
+
+        while(tokenizer.next(str_token, token_index)) {
+            str_tokens.push_back(str_token);
+
+            art_leaf* leaf = (art_leaf *) art_search(t, (const unsigned char*) str_token.c_str(),
+                                                     str_token.length()+1);
+            if(leaf == nullptr) {
+                continue;
+            }
+
+            posting_lists.push_back(leaf->values);
+        }
+
+        // For NOT_EQUALS alone, it is okay for none of the results to match prior to negation
+        // e.g. field:!= [RANDOM_NON_EXISTING_STRING]
+        if(a_filter.comparators[0] != NOT_EQUALS && posting_lists.size() != str_tokens.size()) {
+            continue;
+        }
+
+        std::vector<uint32_t> result_id_vec;
+        posting_t::intersect(posting_lists, result_id_vec);
+        if(!result_id_vec.empty()) {
+            strt_ids = new uint32_t [result_id_vec.size()];
+            std::copy(result_id_vec.begin(), result_id_vec.end(), strt_ids);
+            strt_ids_size = result_id_vec.size();
+        }
+
+        if(a_filter.comparators[0] == EQUALS || a_filter.comparators[0] == NOT_EQUALS) {
+            // need to do exact match (unlike CONTAINS)
+            uint32_t* exact_strt_ids = new uint32_t[strt_ids_size];
+            size_t exact_strt_size = 0;
+
+            posting_t::get_exact_matches(posting_lists, f.is_array(), strt_ids, strt_ids_size,
+                                         exact_strt_ids, exact_strt_size);
+
+            delete[] strt_ids;
+            strt_ids = exact_strt_ids;
+            strt_ids_size = exact_strt_size;
+        }
+
+        matched_ids.or_with(id_bitmap_t(strt_ids, strt_ids_size));
+        delete[] strt_ids;
+    }
+}
+
+void Index::do_filtering_with_lock(uint32_t*& filter_ids, uint32_t& filter_ids_length,
+                                   const std::vector<filter>& filters) const {
+    std::shared_lock lock(mutex);
+    do_filtering(filter_ids, filter_ids_length, filters, false);
+}
+
+void Index::run_search(search_args* search_params) {
+    search(search_params->field_query_tokens,
+           search_params->search_fields,
+           search_params->filters, search_params->facets, search_params->facet_query,
            search_params->included_ids, search_params->excluded_ids,
            search_params->sort_fields_std, search_params->num_typos,
            search_params->topster, search_params->curated_topster,
@@ -1855,7 +2648,11 @@ void Index::run_search(search_args* search_params) {
            search_params->max_extra_suffix,
            search_params->facet_query_num_typos,
            search_params->filter_curated_hits,
-           search_params->split_join_tokens);
+           search_params->split_join_tokens,
+           search_params->facet_sample_percent,
+           search_params->facet_sample_threshold,
+           search_params->explain_filter ? &search_params->filter_plan : nullptr,
+           search_params->typeahead_session);
 }
 
 void Index::collate_included_ids(const std::vector<token_t>& q_included_tokens,
@@ -1895,15 +2692,15 @@ void Index::concat_topster_ids(Topster* topster, spp::sparse_hash_map<uint64_t,
     if(topster->distinct) {
         for(auto &group_topster_entry: topster->group_kv_map) {
             Topster* group_topster = group_topster_entry.second;
-            for(const auto& map_kv: group_topster->kv_map) {
-                topster_ids[map_kv.first].push_back(map_kv.second);
+            for(uint32_t i = 0; i < group_topster->size; i++) {
+                KV* kv = group_topster->getKV(i);
+                topster_ids[kv->key].push_back(kv);
             }
         }
     } else {
-        for(const auto& map_kv: topster->kv_map) {
-            //LOG(INFO) << "map_kv.second.key: " << map_kv.second->key;
-            //LOG(INFO) << "map_kv.first: " << map_kv.first;
-            topster_ids[map_kv.first].push_back(map_kv.second);
+        for(uint32_t i = 0; i < topster->size; i++) {
+            KV* kv = topster->getKV(i);
+            topster_ids[kv->key].push_back(kv);
         }
     }
 }
@@ -2183,74 +2980,92 @@ bool Index::check_for_overrides(const token_ordering& token_order, const string&
 void Index::search_infix(const std::string& query, const std::string& field_name,
                          std::vector<uint32_t>& ids, const size_t max_extra_prefix, const size_t max_extra_suffix) const {
 
-    auto infix_maps_it = infix_index.find(field_name);
+    auto infix_index_it = infix_index.find(field_name);
 
-    if(infix_maps_it == infix_index.end()) {
+    if(infix_index_it == infix_index.end()) {
         return ;
     }
 
-    auto infix_sets = infix_maps_it->second;
-    std::vector<art_leaf*> leaves;
+    const infix_index_t* field_infix_index = infix_index_it->second;
 
-    size_t num_processed = 0;
-    std::mutex m_process;
-    std::condition_variable cv_process;
-
-    auto search_tree = search_index.at(field_name);
+    // only the tokens sharing every trigram of the query have to be verified
+    std::vector<uint32_t> candidate_ids;
+    const bool all_candidates = !field_infix_index->get_candidates(query, candidate_ids);
+    const size_t num_candidates = all_candidates ? field_infix_index->num_token_ids() : candidate_ids.size();
 
-    const auto parent_search_begin = search_begin;
-    const auto parent_search_stop_ms = search_stop_ms;
-    auto parent_search_cutoff = search_cutoff;
+    if(num_candidates == 0) {
+        return ;
+    }
 
-    for(auto infix_set: infix_sets) {
-        thread_pool->enqueue([infix_set, &leaves, search_tree, &query, max_extra_prefix, max_extra_suffix,
-                              &num_processed, &m_process, &cv_process,
-                              &parent_search_begin, &parent_search_stop_ms, &parent_search_cutoff]() {
+    auto search_tree = search_index.at(field_name);
 
-            search_begin = parent_search_begin;
-            search_cutoff = parent_search_cutoff;
-            auto op_search_stop_ms = parent_search_stop_ms/2;
-
-            std::vector<art_leaf*> this_leaves;
-            std::string key_buffer;
-            size_t num_iterated = 0;
-
-            for(auto it = infix_set->begin(); it != infix_set->end(); it++) {
-                it.key(key_buffer);
-                num_iterated++;
-
-                auto start_index = key_buffer.find(query);
-                if(start_index != std::string::npos && start_index <= max_extra_prefix &&
-                   (key_buffer.size() - (start_index + query.size())) <= max_extra_suffix) {
-                    art_leaf* l = (art_leaf *) art_search(search_tree,
-                                                          (const unsigned char *) key_buffer.c_str(),
-                                                          key_buffer.size()+1);
-                    if(l != nullptr) {
-                        this_leaves.push_back(l);
-                    }
+    auto verify_candidates = [&](size_t begin_index, size_t end_index, const size_t op_search_stop_ms,
+                                 std::vector<art_leaf*>& this_leaves) {
+        for(size_t i = begin_index; i < end_index; i++) {
+            const std::string& token = field_infix_index->get_token(all_candidates ? i : candidate_ids[i]);
+
+            auto start_index = token.find(query);
+            if(!token.empty() && start_index != std::string::npos && start_index <= max_extra_prefix &&
+               (token.size() - (start_index + query.size())) <= max_extra_suffix) {
+                art_leaf* l = (art_leaf *) art_search(search_tree, (const unsigned char *) token.c_str(),
+                                                      token.size()+1);
+                if(l != nullptr) {
+                    this_leaves.push_back(l);
                 }
+            }
 
-                // check for search cutoff but only once every 2^10 docs to reduce overhead
-                if(((num_iterated + 1) % (1 << 12)) == 0) {
-                    if (std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::high_resolution_clock::now() - search_begin).count() > op_search_stop_ms) {
-                        search_cutoff = true;
-                        break;
-                    }
+            // check for search cutoff but only once every 2^12 tokens to reduce overhead
+            if(((i - begin_index + 1) % (1 << 12)) == 0) {
+                if (std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::high_resolution_clock::now() - search_begin).count() > op_search_stop_ms) {
+                    search_cutoff = true;
+                    break;
                 }
             }
+        }
+    };
 
-            std::unique_lock<std::mutex> lock(m_process);
-            leaves.insert(leaves.end(), this_leaves.begin(), this_leaves.end());
-            num_processed++;
-            parent_search_cutoff = parent_search_cutoff || search_cutoff;
-            cv_process.notify_one();
-        });
-    }
+    std::vector<art_leaf*> leaves;
 
-    std::unique_lock<std::mutex> lock_process(m_process);
-    cv_process.wait(lock_process, [&](){ return num_processed == infix_sets.size(); });
-    search_cutoff = parent_search_cutoff;
+    if(num_candidates < INFIX_PARALLEL_CANDIDATES) {
+        verify_candidates(0, num_candidates, search_stop_ms/2, leaves);
+    } else {
+        size_t num_processed = 0;
+        std::mutex m_process;
+        std::condition_variable cv_process;
+
+        const auto parent_search_begin = search_begin;
+        const auto parent_search_stop_ms = search_stop_ms;
+        auto parent_search_cutoff = search_cutoff;
+
+        const size_t window_size = (num_candidates + INFIX_SEARCH_CONCURRENCY - 1) / INFIX_SEARCH_CONCURRENCY;
+
+        for(size_t thread_id = 0; thread_id < INFIX_SEARCH_CONCURRENCY; thread_id++) {
+            const size_t begin_index = std::min(num_candidates, thread_id * window_size);
+            const size_t end_index = std::min(num_candidates, begin_index + window_size);
+
+            thread_pool->enqueue([begin_index, end_index, &verify_candidates, &leaves,
+                                  &num_processed, &m_process, &cv_process,
+                                  &parent_search_begin, &parent_search_stop_ms, &parent_search_cutoff]() {
+
+                search_begin = parent_search_begin;
+                search_cutoff = parent_search_cutoff;
+
+                std::vector<art_leaf*> this_leaves;
+                verify_candidates(begin_index, end_index, parent_search_stop_ms/2, this_leaves);
+
+                std::unique_lock<std::mutex> lock(m_process);
+                leaves.insert(leaves.end(), this_leaves.begin(), this_leaves.end());
+                num_processed++;
+                parent_search_cutoff = parent_search_cutoff || search_cutoff;
+                cv_process.notify_one();
+            });
+        }
+
+        std::unique_lock<std::mutex> lock_process(m_process);
+        cv_process.wait(lock_process, [&](){ return num_processed == INFIX_SEARCH_CONCURRENCY; });
+        search_cutoff = parent_search_cutoff;
+    }
 
     for(auto leaf: leaves) {
         posting_t::merge({leaf->values}, ids);
@@ -2276,18 +3091,45 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
                    size_t concurrency, size_t search_cutoff_ms, size_t min_len_1typo, size_t min_len_2typo,
                    size_t max_candidates, const std::vector<infix_t>& infixes, const size_t max_extra_prefix,
                    const size_t max_extra_suffix, const size_t facet_query_num_typos,
-                   const bool filter_curated_hits, const bool split_join_tokens) const {
+                   const bool filter_curated_hits, const bool split_join_tokens,
+                   const size_t facet_sample_percent, const size_t facet_sample_threshold,
+                   std::vector<filter_clause_plan_t>* filter_plan, const std::string& typeahead_session) const {
 
-    // process the filters
+    std::shared_lock lock(mutex);
 
-    uint32_t* filter_ids = nullptr;
-    uint32_t filter_ids_length = 0;
+    // The previous query of a type-ahead session is reused only when the index is unchanged since, so its leaves
+    // are still valid. The epoch is read before searching, so a write during the search leaves the saved session
+    // stale rather than letting the next keystroke reuse it.
+    std::shared_ptr<const typeahead_session_t> prev_session;
+    std::shared_ptr<typeahead_session_t> session;
 
-    std::shared_lock lock(mutex);
+    if(!typeahead_session.empty()) {
+        session = std::make_shared<typeahead_session_t>();
+        prev_session = get_typeahead_session(typeahead_session, session->write_epoch);
+        session->filter_key = get_filters_cache_key(filters);
+    }
+
+    // process the filters: clauses are evaluated lazily, as the IDs they are checked against are produced
+    std::unique_ptr<filter_iterator_t> filter_it;
+    if(!filters.empty()) {
+        filter_it = new_filter_iterator(filters, filter_plan);
+    }
+
+    auto is_wildcard_query = !field_query_tokens.empty() && !field_query_tokens[0].q_include_tokens.empty() &&
+                             field_query_tokens[0].q_include_tokens[0].value == "*";
+
+    // A wildcard query produces every ID of the filter anyway, so it can stop early when there's none. A text query
+    // only checks the IDs of the tokens against the filter, which finds nothing on its own when the filter is empty.
+    const auto filter_matches_nothing = [&]() {
+        if(filter_it == nullptr || (!is_wildcard_query && included_ids.empty())) {
+            return false;
+        }
 
-    do_filtering(filter_ids, filter_ids_length, filters, true);
+        filter_it->reset();
+        return !filter_it->valid();
+    };
 
-    if(!filters.empty() && filter_ids_length == 0) {
+    if(filter_matches_nothing()) {
         return ;
     }
 
@@ -2295,7 +3137,7 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
     std::map<size_t, std::map<size_t, uint32_t>> included_ids_map;  // outer pos => inner pos => list of IDs
     std::vector<uint32_t> included_ids_vec;
     process_curated_ids(included_ids, excluded_ids, group_limit, filter_curated_hits,
-                        filter_ids, filter_ids_length, curated_ids, included_ids_map, included_ids_vec);
+                        filter_it.get(), curated_ids, included_ids_map, included_ids_vec);
 
     std::vector<uint32_t> curated_ids_sorted(curated_ids.begin(), curated_ids.end());
     std::sort(curated_ids_sorted.begin(), curated_ids_sorted.end());
@@ -2306,10 +3148,27 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
 
     const size_t num_search_fields = std::min(the_fields.size(), (size_t) FIELD_LIMIT_NUM);
 
-    // handle phrase searches
+    // handle phrase searches: documents matching the phrases are checked like another filter clause
+    uint32_t* phrase_match_ids = nullptr;
+    size_t phrase_match_ids_size = 0;
+
     if(!field_query_tokens[0].q_phrases.empty()) {
-        do_phrase_search(num_search_fields, the_fields, field_query_tokens, filter_ids, filter_ids_length);
-        if(filter_ids_length == 0) {
+        do_phrase_search(num_search_fields, the_fields, field_query_tokens, phrase_match_ids, phrase_match_ids_size);
+        if(phrase_match_ids_size == 0) {
+            return ;
+        }
+
+        std::vector<std::unique_ptr<filter_iterator_t>> phrase_filter_its;
+        phrase_filter_its.push_back(new_ids_filter_iterator(phrase_match_ids, phrase_match_ids_size));
+
+        if(filter_it != nullptr) {
+            phrase_filter_its.push_back(std::move(filter_it));
+        }
+
+        filter_it = std::make_unique<filter_and_iterator_t>(std::move(phrase_filter_its));
+
+        if(filter_matches_nothing()) {
+            delete [] phrase_match_ids;
             return ;
         }
     }
@@ -2320,7 +3179,7 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
     handle_exclusion(num_search_fields, field_query_tokens, the_fields, exclude_token_ids, exclude_token_ids_size);
 
     int sort_order[3]; // 1 or -1 based on DESC or ASC respectively
-    std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3> field_values;
+    std::array<sort_values_t*, 3> field_values;
     std::vector<size_t> geopoint_indices;
     populate_sort_mapping(sort_order, geopoint_indices, sort_fields_std, field_values);
 
@@ -2330,22 +3189,21 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
                                                             &curated_ids_sorted[0], curated_ids_sorted.size(),
                                                             &excluded_result_ids);
 
-    auto is_wildcard_query = !field_query_tokens.empty() && !field_query_tokens[0].q_include_tokens.empty() &&
-                             field_query_tokens[0].q_include_tokens[0].value == "*";
+    // When no hits are requested, results are only counted and faceted: without a topster, matching documents are
+    // neither scored nor have their sort values looked up. Grouped searches still need the group of every hit.
+    const bool count_only = (per_page == 0 && group_limit == 0);
+    Topster* raw_topster = count_only ? nullptr : topster;
 
     // for phrase query, parser will set field_query_tokens to "*", need to handle that
     if (is_wildcard_query) {
         const uint8_t field_id = (uint8_t)(FIELD_LIMIT_NUM - 0);
         const std::string& field = the_fields[0].name;
 
-        curate_filtered_ids(filters, curated_ids, excluded_result_ids,
-                            excluded_result_ids_size, filter_ids, filter_ids_length, curated_ids_sorted);
-
-        search_wildcard(filters, included_ids_map, sort_fields_std, topster,
+        search_wildcard(filters, included_ids_map, sort_fields_std, raw_topster,
                         curated_topster, groups_processed, searched_queries, group_limit, group_by_fields,
                         curated_ids, curated_ids_sorted,
                         excluded_result_ids, excluded_result_ids_size, field_id, field,
-                        all_result_ids, all_result_ids_len, filter_ids, filter_ids_length, concurrency,
+                        all_result_ids, all_result_ids_len, filter_it.get(), concurrency,
                         sort_order, field_values, geopoint_indices);
     } else {
         // Non-wildcard
@@ -2385,13 +3243,51 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
             }
         }
 
-        fuzzy_search_fields(the_fields, field_query_tokens[0].q_include_tokens, excluded_result_ids,
-                            excluded_result_ids_size, filter_ids, filter_ids_length, curated_ids_sorted,
-                            sort_fields_std, num_typos, searched_queries, qtoken_set, topster, groups_processed,
-                            all_result_ids, all_result_ids_len, group_limit, group_by_fields, prioritize_exact_match,
-                            query_hashes, token_order, prefixes, typo_tokens_threshold, exhaustive_search,
-                            max_candidates, min_len_1typo, min_len_2typo, syn_orig_num_tokens, sort_order,
-                            field_values, geopoint_indices);
+        // a single token that is counted without typos needs only the sizes of its posting lists
+        const bool counted_exact_token = count_only && filter_it == nullptr && excluded_result_ids_size == 0 &&
+                                         field_query_tokens[0].q_include_tokens.size() == 1 &&
+                                         field_query_tokens[0].q_synonyms.empty() && !exhaustive_search &&
+                                         count_exact_token_matches(the_fields, num_search_fields,
+                                                                   field_query_tokens[0].q_include_tokens[0],
+                                                                   prefixes, infixes, typo_tokens_threshold,
+                                                                   !facets.empty(), all_result_ids,
+                                                                   all_result_ids_len);
+
+        // candidates of the tokens depend on the fields searched, how they are searched and the filter
+        token_leaves_t* query_token_leaves = nullptr;
+        const token_leaves_t* session_token_leaves = nullptr;
+
+        if(session != nullptr) {
+            for(size_t i = 0; i < num_search_fields; i++) {
+                const bool field_prefix = (i < prefixes.size()) ? prefixes[i] : prefixes[0];
+                const uint32_t field_num_typos = (i < num_typos.size()) ? num_typos[i] : num_typos[0];
+                session->candidates_key += the_fields[i].name + '\x1f' + std::to_string(field_prefix) +
+                                           std::to_string(field_num_typos) + '\x1e';
+            }
+
+            session->candidates_key += std::to_string(token_order) + '\x1e' + session->filter_key;
+
+            for(const auto& phrase: field_query_tokens[0].q_phrases) {
+                session->candidates_key += '\x1e';
+                session->candidates_key += StringUtils::join(phrase, " ");
+            }
+
+            query_token_leaves = &session->token_leaves;
+
+            if(prev_session != nullptr && prev_session->candidates_key == session->candidates_key) {
+                session_token_leaves = &prev_session->token_leaves;
+            }
+        }
+
+        if(!counted_exact_token) {
+            fuzzy_search_fields(the_fields, field_query_tokens[0].q_include_tokens, excluded_result_ids,
+                                excluded_result_ids_size, filter_it.get(), curated_ids_sorted,
+                                sort_fields_std, num_typos, searched_queries, qtoken_set, raw_topster,
+                                groups_processed, all_result_ids, all_result_ids_len, group_limit, group_by_fields,
+                                prioritize_exact_match, query_hashes, token_order, prefixes, typo_tokens_threshold,
+                                exhaustive_search, max_candidates, min_len_1typo, min_len_2typo, syn_orig_num_tokens,
+                                sort_order, field_values, geopoint_indices, query_token_leaves, session_token_leaves);
+        }
 
         // try split/joining tokens if no results are found
         if(all_result_ids_len == 0 && split_join_tokens) {
@@ -2422,11 +3318,12 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
                 }
 
                 fuzzy_search_fields(the_fields, resolved_tokens, excluded_result_ids,
-                                    excluded_result_ids_size, filter_ids, filter_ids_length, curated_ids_sorted,
-                                    sort_fields_std, num_typos, searched_queries, qtoken_set, topster, groups_processed,
+                                    excluded_result_ids_size, filter_it.get(), curated_ids_sorted,
+                                    sort_fields_std, num_typos, searched_queries, qtoken_set, raw_topster, groups_processed,
                                     all_result_ids, all_result_ids_len, group_limit, group_by_fields, prioritize_exact_match,
                                     query_hashes, token_order, prefixes, typo_tokens_threshold, exhaustive_search,
-                                    max_candidates, min_len_1typo, min_len_2typo, syn_orig_num_tokens, sort_order, field_values, geopoint_indices);
+                                    max_candidates, min_len_1typo, min_len_2typo, syn_orig_num_tokens, sort_order, field_values, geopoint_indices,
+                                    query_token_leaves, session_token_leaves);
             }
         }
 
@@ -2434,9 +3331,9 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
         do_synonym_search(the_fields, filters, included_ids_map, sort_fields_std, curated_topster, token_order,
                           0, group_limit, group_by_fields, prioritize_exact_match, exhaustive_search, concurrency,
                           min_len_1typo, min_len_2typo, max_candidates, curated_ids, curated_ids_sorted,
-                          excluded_result_ids, excluded_result_ids_size, topster, q_pos_synonyms, syn_orig_num_tokens,
+                          excluded_result_ids, excluded_result_ids_size, raw_topster, q_pos_synonyms, syn_orig_num_tokens,
                           groups_processed, searched_queries, all_result_ids, all_result_ids_len,
-                          filter_ids, filter_ids_length, query_hashes,
+                          filter_it.get(), query_hashes,
                           sort_order, field_values, geopoint_indices,
                           qtoken_set);
 
@@ -2477,12 +3374,13 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
                         }
 
                         fuzzy_search_fields(the_fields, truncated_tokens, excluded_result_ids,
-                                            excluded_result_ids_size, filter_ids, filter_ids_length, curated_ids_sorted,
-                                            sort_fields_std, num_typos, searched_queries, qtoken_set, topster, groups_processed,
+                                            excluded_result_ids_size, filter_it.get(), curated_ids_sorted,
+                                            sort_fields_std, num_typos, searched_queries, qtoken_set, raw_topster, groups_processed,
                                             all_result_ids, all_result_ids_len, group_limit, group_by_fields, prioritize_exact_match,
                                             query_hashes, token_order, prefixes, typo_tokens_threshold,
                                             exhaustive_search, max_candidates, min_len_1typo,
-                                            min_len_2typo, -1, sort_order, field_values, geopoint_indices);
+                                            min_len_2typo, -1, sort_order, field_values, geopoint_indices,
+                                            query_token_leaves, session_token_leaves);
 
                     } else {
                         break;
@@ -2495,7 +3393,7 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
                         group_limit, group_by_fields,
                         max_extra_prefix, max_extra_suffix,
                         field_query_tokens[0].q_include_tokens,
-                        topster, filter_ids, filter_ids_length,
+                        raw_topster, filter_it.get(),
                         sort_order, field_values, geopoint_indices,
                         curated_ids_sorted, all_result_ids, all_result_ids_len, groups_processed);
 
@@ -2507,25 +3405,93 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
 
     //LOG(INFO) << "topster size: " << topster->size;
 
+    if(session != nullptr) {
+        save_typeahead_session(typeahead_session, session);
+    }
+
     delete [] exclude_token_ids;
     delete [] excluded_result_ids;
 
-    if(!facets.empty()) {
-        const size_t num_threads = std::min(concurrency, all_result_ids_len);
+    // Facet counts of a wildcard query depend only on its filter, so they are cached regardless of pagination and
+    // sorting. Facets that are cached are not computed, and the rest are computed separately and cached afterwards.
+    const bool cache_facets = is_wildcard_query && field_query_tokens[0].q_phrases.empty() &&
+                              exclude_token_ids_size == 0 && included_ids.empty() && excluded_ids.empty() &&
+                              curated_ids.empty() && group_limit == 0 && facet_sample_percent == 100;
+
+    std::vector<facet> uncached_facets;
+    std::vector<size_t> uncached_facet_indices;
+    std::vector<std::string> facet_cache_keys;
+    uint64_t facet_cache_epoch = 0;
+
+    if(cache_facets) {
+        for(size_t fi = 0; fi < facets.size(); fi++) {
+            auto& a_facet = facets[fi];
+
+            // facet query needs the matched tokens of every value
+            if(a_facet.field_name == facet_query.field_name && !facet_query.query.empty()) {
+                facet_cache_keys.emplace_back();
+            } else {
+                facet_cache_keys.push_back(get_facet_cache_key(filters, a_facet));
+                const auto cached_result = get_cached_facet_result(facet_cache_keys.back(), facet_cache_epoch);
+
+                if(cached_result != nullptr) {
+                    a_facet.result_map = cached_result->result_map;
+                    a_facet.stats = cached_result->stats;
+                    a_facet.range_counts = cached_result->range_counts;
+                    continue;
+                }
+            }
+
+            uncached_facets.emplace_back(a_facet.field_name, a_facet.ranges);
+            uncached_facet_indices.push_back(fi);
+        }
+    }
+
+    std::vector<facet>& facets_to_compute = cache_facets ? uncached_facets : facets;
+
+    if(!facets_to_compute.empty()) {
+        // on large result sets, facets can be counted over a sample of the results and scaled up
+        // (group counts are sizes of group sets, which can't be scaled)
+        std::vector<uint32_t> sampled_result_ids;
+        const uint32_t* facet_result_ids = all_result_ids;
+        size_t facet_result_ids_len = all_result_ids_len;
+
+        const bool sample_facets = (facet_sample_percent < 100 && group_limit == 0 &&
+                                    all_result_ids_len != 0 && all_result_ids_len >= facet_sample_threshold);
+
+        if(sample_facets) {
+            const size_t sample_size = std::max<size_t>(1, all_result_ids_len * facet_sample_percent / 100);
+            sampled_result_ids.reserve(sample_size);
+
+            // one random pick from each of `sample_size` equal strides of the results: seeded so that repeating
+            // a query gives the same counts
+            std::mt19937 rng(all_result_ids_len);
+
+            for(size_t i = 0; i < sample_size; i++) {
+                const size_t stride_begin = uint64_t(i) * all_result_ids_len / sample_size;
+                const size_t stride_end = uint64_t(i + 1) * all_result_ids_len / sample_size;
+                sampled_result_ids.push_back(all_result_ids[stride_begin + rng() % (stride_end - stride_begin)]);
+            }
+
+            facet_result_ids = sampled_result_ids.data();
+            facet_result_ids_len = sampled_result_ids.size();
+        }
+
+        const size_t num_threads = std::min(concurrency, facet_result_ids_len);
         const size_t window_size = (num_threads == 0) ? 0 :
-                                   (all_result_ids_len + num_threads - 1) / num_threads;  // rounds up
+                                   (facet_result_ids_len + num_threads - 1) / num_threads;  // rounds up
         size_t num_processed = 0;
         std::mutex m_process;
         std::condition_variable cv_process;
 
-        std::vector<facet_info_t> facet_infos(facets.size());
-        compute_facet_infos(facets, facet_query, facet_query_num_typos, all_result_ids, all_result_ids_len,
+        std::vector<facet_info_t> facet_infos(facets_to_compute.size());
+        compute_facet_infos(facets_to_compute, facet_query, facet_query_num_typos, all_result_ids, all_result_ids_len,
                                      group_by_fields, facet_infos);
 
         std::vector<std::vector<facet>> facet_batches(num_threads);
         for(size_t i = 0; i < num_threads; i++) {
-            for(const auto& this_facet: facets) {
-                facet_batches[i].emplace_back(facet(this_facet.field_name));
+            for(const auto& this_facet: facets_to_compute) {
+                facet_batches[i].emplace_back(facet(this_facet.field_name, this_facet.ranges));
             }
         }
 
@@ -2534,14 +3500,14 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
 
         //auto beginF = std::chrono::high_resolution_clock::now();
 
-        for(size_t thread_id = 0; thread_id < num_threads && result_index < all_result_ids_len; thread_id++) {
+        for(size_t thread_id = 0; thread_id < num_threads && result_index < facet_result_ids_len; thread_id++) {
             size_t batch_res_len = window_size;
 
-            if(result_index + window_size > all_result_ids_len) {
-                batch_res_len = all_result_ids_len - result_index;
+            if(result_index + window_size > facet_result_ids_len) {
+                batch_res_len = facet_result_ids_len - result_index;
             }
 
-            uint32_t* batch_result_ids = all_result_ids + result_index;
+            const uint32_t* batch_result_ids = facet_result_ids + result_index;
             num_queued++;
 
             thread_pool->enqueue([this, thread_id, &facet_batches, &facet_query, group_limit, group_by_fields,
@@ -2564,7 +3530,7 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
         for(auto& facet_batch: facet_batches) {
             for(size_t fi = 0; fi < facet_batch.size(); fi++) {
                 auto& this_facet = facet_batch[fi];
-                auto& acc_facet = facets[fi];
+                auto& acc_facet = facets_to_compute[fi];
 
                 for(auto & facet_kv: this_facet.result_map) {
                     if(group_limit) {
@@ -2573,6 +3539,9 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
                             this_facet.hash_groups[facet_kv.first].begin(),
                             this_facet.hash_groups[facet_kv.first].end()
                         );
+
+                        // count is derived from the group set, but the facet value has to be present in the map
+                        acc_facet.result_map[facet_kv.first];
                     } else {
                         size_t count = 0;
                         if(acc_facet.result_map.count(facet_kv.first) == 0) {
@@ -2584,11 +3553,17 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
                         acc_facet.result_map[facet_kv.first].count = count;
                     }
 
-                    acc_facet.result_map[facet_kv.first].doc_id = facet_kv.second.doc_id;
-                    acc_facet.result_map[facet_kv.first].array_pos = facet_kv.second.array_pos;
                     acc_facet.hash_tokens[facet_kv.first] = this_facet.hash_tokens[facet_kv.first];
                 }
 
+                if(acc_facet.ordinal_counts.size() < this_facet.ordinal_counts.size()) {
+                    acc_facet.ordinal_counts.resize(this_facet.ordinal_counts.size());
+                }
+
+                for(size_t ordinal = 0; ordinal < this_facet.ordinal_counts.size(); ordinal++) {
+                    acc_facet.ordinal_counts[ordinal] += this_facet.ordinal_counts[ordinal];
+                }
+
                 if(this_facet.stats.fvcount != 0) {
                     acc_facet.stats.fvcount += this_facet.stats.fvcount;
                     acc_facet.stats.fvsum += this_facet.stats.fvsum;
@@ -2596,21 +3571,79 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
                     acc_facet.stats.fvmin = std::min(acc_facet.stats.fvmin, this_facet.stats.fvmin);
                 }
             }
-        }
+        }
+
+        if(sample_facets) {
+            const double scale = double(all_result_ids_len) / facet_result_ids_len;
+
+            for(auto& acc_facet: facets_to_compute) {
+                if(acc_facet.is_range_facet()) {
+                    continue;
+                }
+
+                for(auto& facet_kv: acc_facet.result_map) {
+                    facet_kv.second.count = std::round(facet_kv.second.count * scale);
+                }
+
+                for(auto& ordinal_count: acc_facet.ordinal_counts) {
+                    ordinal_count = std::round(ordinal_count * scale);
+                }
+
+                acc_facet.stats.fvcount = std::round(acc_facet.stats.fvcount * scale);
+                acc_facet.stats.fvsum *= scale;
+
+                acc_facet.sampled = true;
+                acc_facet.sample_size = facet_result_ids_len;
+            }
+        }
+
+        // range facets are always counted over all the results
+        for(auto& a_facet: facets_to_compute) {
+            if(a_facet.is_range_facet()) {
+                compute_range_facet_counts(a_facet, all_result_ids, all_result_ids_len);
+            }
+        }
+
+        /*long long int timeMillisF = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - beginF).count();
+        LOG(INFO) << "Time for faceting: " << timeMillisF;*/
+    }
+
+    if(cache_facets) {
+        fold_ordinal_facet_counts(uncached_facets);
+
+        for(size_t ui = 0; ui < uncached_facets.size(); ui++) {
+            facet& computed_facet = uncached_facets[ui];
+            const std::string& cache_key = facet_cache_keys[uncached_facet_indices[ui]];
+
+            // results are incomplete when the search was cut off
+            if(!cache_key.empty() && !search_cutoff) {
+                cache_facet_result(cache_key, facet_cache_epoch, computed_facet);
+            }
 
-        /*long long int timeMillisF = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::high_resolution_clock::now() - beginF).count();
-        LOG(INFO) << "Time for faceting: " << timeMillisF;*/
+            facet& a_facet = facets[uncached_facet_indices[ui]];
+            a_facet.result_map = std::move(computed_facet.result_map);
+            a_facet.hash_tokens = std::move(computed_facet.hash_tokens);
+            a_facet.stats = computed_facet.stats;
+            a_facet.range_counts = std::move(computed_facet.range_counts);
+        }
     }
 
     std::vector<facet_info_t> facet_infos(facets.size());
     compute_facet_infos(facets, facet_query, facet_query_num_typos,
                         &included_ids_vec[0], included_ids_vec.size(), group_by_fields, facet_infos);
     do_facets(facets, facet_query, facet_infos, group_limit, group_by_fields, &included_ids_vec[0], included_ids_vec.size());
+    fold_ordinal_facet_counts(facets);
+
+    for(auto& a_facet: facets) {
+        if(a_facet.is_range_facet()) {
+            compute_range_facet_counts(a_facet, &included_ids_vec[0], included_ids_vec.size());
+        }
+    }
 
     all_result_ids_len += curated_topster->size;
 
-    delete [] filter_ids;
+    delete [] phrase_match_ids;
     delete [] all_result_ids;
 
     //LOG(INFO) << "all_result_ids_len " << all_result_ids_len << " for index " << name;
@@ -2620,7 +3653,7 @@ void Index::search(std::vector<query_tokens_t>& field_query_tokens, const std::v
 
 void Index::process_curated_ids(const std::vector<std::pair<uint32_t, uint32_t>>& included_ids,
                                 const std::vector<uint32_t>& excluded_ids, const size_t group_limit,
-                                const bool filter_curated_hits, const uint32_t* filter_ids, uint32_t filter_ids_length,
+                                const bool filter_curated_hits, filter_iterator_t* filter_it,
                                 std::set<uint32_t>& curated_ids,
                                 std::map<size_t, std::map<size_t, uint32_t>>& included_ids_map,
                                 std::vector<uint32_t>& included_ids_vec) const {
@@ -2633,19 +3666,17 @@ void Index::process_curated_ids(const std::vector<std::pair<uint32_t, uint32_t>>
     // if `filter_curated_hits` is enabled, we will remove curated hits that don't match filter condition
     std::set<uint32_t> included_ids_set;
 
-    if(filter_ids_length != 0 && filter_curated_hits) {
-        uint32_t* included_ids_arr = nullptr;
-        size_t included_ids_len = ArrayUtils::and_scalar(&included_ids_vec[0], included_ids_vec.size(), filter_ids,
-                                                        filter_ids_length, &included_ids_arr);
-
-        included_ids_vec.clear();
+    if(filter_it != nullptr && filter_curated_hits) {
+        std::vector<uint32_t> filtered_included_ids;
 
-        for(size_t i = 0; i < included_ids_len; i++) {
-            included_ids_set.insert(included_ids_arr[i]);
-            included_ids_vec.push_back(included_ids_arr[i]);
+        for(uint32_t included_id: included_ids_vec) {
+            if(filter_it->contains(included_id)) {
+                included_ids_set.insert(included_id);
+                filtered_included_ids.push_back(included_id);
+            }
         }
 
-        delete [] included_ids_arr;
+        included_ids_vec = std::move(filtered_included_ids);
     } else {
         included_ids_set.insert(included_ids_vec.begin(), included_ids_vec.end());
     }
@@ -2701,7 +3732,7 @@ void Index::fuzzy_search_fields(const std::vector<search_field_t>& the_fields,
                                 const std::vector<token_t>& query_tokens,
                                 const uint32_t* exclude_token_ids,
                                 size_t exclude_token_ids_size,
-                                const uint32_t* filter_ids, size_t filter_ids_length,
+                                filter_iterator_t* filter_it,
                                 const std::vector<uint32_t>& curated_ids,
                                 const std::vector<sort_by> & sort_fields,
                                 const std::vector<uint32_t>& num_typos,
@@ -2721,13 +3752,16 @@ void Index::fuzzy_search_fields(const std::vector<search_field_t>& the_fields,
                                 size_t min_len_2typo,
                                 int syn_orig_num_tokens,
                                 const int* sort_order,
-                                std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
-                                const std::vector<size_t>& geopoint_indices) const {
+                                std::array<sort_values_t*, 3>& field_values,
+                                const std::vector<size_t>& geopoint_indices,
+                                token_leaves_t* query_token_leaves,
+                                const token_leaves_t* session_token_leaves) const {
 
     // NOTE: `query_tokens` preserve original tokens, while `search_tokens` could be a result of dropped tokens
 
     // To prevent us from doing ART search repeatedly as we iterate through possible corrections
-    spp::sparse_hash_map<std::string, std::vector<art_leaf*>> token_cost_cache;
+    token_leaves_t local_token_leaves;
+    token_leaves_t& token_cost_cache = (query_token_leaves != nullptr) ? *query_token_leaves : local_token_leaves;
 
     std::vector<std::vector<int>> token_to_costs;
 
@@ -2751,6 +3785,12 @@ void Index::fuzzy_search_fields(const std::vector<search_field_t>& the_fields,
 
     const size_t num_search_fields = std::min(the_fields.size(), (size_t) FIELD_LIMIT_NUM);
 
+    // prefix candidates of a session can be narrowed down only when every field is searched by prefix
+    bool all_fields_prefix = true;
+    for(size_t field_id = 0; field_id < num_search_fields; field_id++) {
+        all_fields_prefix = all_fields_prefix && ((field_id < prefixes.size()) ? prefixes[field_id] : prefixes[0]);
+    }
+
     auto product = []( long long a, std::vector<int>& b ) { return a*b.size(); };
     long long n = 0;
     long long int N = std::accumulate(token_to_costs.begin(), token_to_costs.end(), 1LL, product);
@@ -2778,12 +3818,30 @@ void Index::fuzzy_search_fields(const std::vector<search_field_t>& the_fields,
         while(token_index < query_tokens.size()) {
             // For each token, look up the generated cost for this iteration and search using that cost
             const std::string& token = query_tokens[token_index].value;
-            const std::string token_cost_hash = token + std::to_string(costs[token_index]);
+            const bool is_prefix_searched = query_tokens[token_index].is_prefix_searched;
+            const std::string token_cost_hash = token + '\x1f' + std::to_string(costs[token_index]) +
+                                                (is_prefix_searched ? "p" : "");
 
             std::vector<art_leaf*> leaves;
 
             if(token_cost_cache.count(token_cost_hash) != 0) {
                 leaves = token_cost_cache[token_cost_hash];
+            } else if(session_token_leaves != nullptr && (session_token_leaves->count(token_cost_hash) != 0 ||
+                      (costs[token_index] == 0 && is_prefix_searched && all_fields_prefix &&
+                       narrow_typeahead_leaves(*session_token_leaves, token, unique_tokens, leaves)))) {
+                // found by the previous query of the type-ahead session, or narrowed down from a shorter prefix
+                auto session_it = session_token_leaves->find(token_cost_hash);
+                if(session_it != session_token_leaves->end()) {
+                    leaves = session_it->second;
+                }
+
+                if(!leaves.empty()) {
+                    token_cost_cache.emplace(token_cost_hash, leaves);
+                    for(auto leaf: leaves) {
+                        std::string tok(reinterpret_cast<char*>(leaf->key), leaf->key_len - 1);
+                        unique_tokens.emplace(tok);
+                    }
+                }
             } else {
                 //auto begin = std::chrono::high_resolution_clock::now();
 
@@ -2808,25 +3866,23 @@ void Index::fuzzy_search_fields(const std::vector<search_field_t>& the_fields,
                         continue;
                     }
 
-                    size_t max_words = 100000;
-                    art_fuzzy_search(search_index.at(the_field.name), (const unsigned char *) token.c_str(), token_len,
-                                     costs[token_index], costs[token_index], max_words, token_order, prefix_search,
-                                     filter_ids, filter_ids_length, leaves, unique_tokens);
+                    const size_t num_leaves = leaves.size();
+                    fuzzy_search_field(the_field.name, token, costs[token_index], prefix_search, token_order,
+                                       filter_it, unique_tokens, leaves);
 
                     /*auto timeMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
                                     std::chrono::high_resolution_clock::now() - begin).count();
                     LOG(INFO) << "Time taken for fuzzy search: " << timeMillis << "ms";*/
 
-                    if(leaves.empty()) {
-                        // look at the next field
-                        continue;
+                    for(size_t i = num_leaves; i < leaves.size(); i++) {
+                        std::string tok(reinterpret_cast<char*>(leaves[i]->key), leaves[i]->key_len - 1);
+                        unique_tokens.emplace(tok);
                     }
+                }
 
+                // cached along with the candidates of every field, so that a session can narrow them down
+                if(!leaves.empty()) {
                     token_cost_cache.emplace(token_cost_hash, leaves);
-                    for(auto leaf: leaves) {
-                        std::string tok(reinterpret_cast<char*>(leaf->key), leaf->key_len - 1);
-                        unique_tokens.emplace(tok);
-                    }
                 }
             }
 
@@ -2871,7 +3927,7 @@ void Index::fuzzy_search_fields(const std::vector<search_field_t>& the_fields,
         if(token_candidates_vec.size() == query_tokens.size()) {
             std::vector<uint32_t> id_buff;
 
-            search_all_candidates(num_search_fields, the_fields, filter_ids, filter_ids_length,
+            search_all_candidates(num_search_fields, the_fields, filter_it,
                                   exclude_token_ids, exclude_token_ids_size,
                                   sort_fields, token_candidates_vec, searched_queries, qtoken_set, topster,
                                   groups_processed, all_result_ids, all_result_ids_len,
@@ -2903,13 +3959,65 @@ void Index::fuzzy_search_fields(const std::vector<search_field_t>& the_fields,
     }
 }
 
+bool Index::count_exact_token_matches(const std::vector<search_field_t>& the_fields, const size_t num_search_fields,
+                                      const token_t& token, const std::vector<bool>& prefixes,
+                                      const std::vector<infix_t>& infixes, const size_t typo_tokens_threshold,
+                                      const bool need_ids, uint32_t*& all_result_ids,
+                                      size_t& all_result_ids_len) const {
+    std::vector<void*> posting_lists;
+
+    for(size_t i = 0; i < num_search_fields; i++) {
+        const bool field_prefix = (i < prefixes.size()) ? prefixes[i] : prefixes[0];
+        const infix_t field_infix = (i < infixes.size()) ? infixes[i] : infixes[0];
+
+        if((field_prefix && token.is_prefix_searched) || field_infix != off) {
+            return false;
+        }
+
+        art_tree* tree = search_index.at(the_fields[i].name);
+        art_leaf* leaf = static_cast<art_leaf*>(art_search(tree, (const unsigned char*) token.value.c_str(),
+                                                           token.value.size() + 1));
+        if(leaf != nullptr) {
+            posting_lists.push_back(leaf->values);
+        }
+    }
+
+    if(posting_lists.empty()) {
+        return false;
+    }
+
+    std::vector<uint32_t> result_ids;
+    size_t num_results = 0;
+
+    if(posting_lists.size() == 1 && !need_ids) {
+        num_results = posting_t::num_ids(posting_lists[0]);
+    } else {
+        // a document can contain the token in more than one field
+        posting_t::merge(posting_lists, result_ids);
+        num_results = result_ids.size();
+    }
+
+    // typo corrections would be looked for otherwise
+    if(num_results < typo_tokens_threshold) {
+        return false;
+    }
+
+    if(!result_ids.empty()) {
+        all_result_ids = new uint32_t[result_ids.size()];
+        std::copy(result_ids.begin(), result_ids.end(), all_result_ids);
+    }
+
+    all_result_ids_len = num_results;
+    return true;
+}
+
 void Index::find_across_fields(const std::vector<token_t>& query_tokens,
                                const size_t num_query_tokens,
                                const std::vector<uint32_t>& num_typos,
                                const std::vector<bool>& prefixes,
                                const std::vector<search_field_t>& the_fields,
                                const size_t num_search_fields,
-                               const uint32_t* filter_ids, uint32_t filter_ids_length,
+                               filter_iterator_t* filter_it,
                                const uint32_t* exclude_token_ids, size_t exclude_token_ids_size,
                                std::vector<uint32_t>& id_buff) const {
 
@@ -2919,7 +4027,7 @@ void Index::find_across_fields(const std::vector<token_t>& query_tokens,
     // used to track plists that must be destructed once done
     std::vector<posting_list_t*> expanded_plists;
 
-    result_iter_state_t istate(exclude_token_ids, exclude_token_ids_size, filter_ids, filter_ids_length);
+    result_iter_state_t istate(exclude_token_ids, exclude_token_ids_size, filter_it);
 
     // for each token, find the posting lists across all query_by fields
     for(size_t ti = 0; ti < num_query_tokens; ti++) {
@@ -3002,15 +4110,18 @@ void Index::search_across_fields(const std::vector<token_t>& query_tokens,
                                  tsl::htrie_map<char, token_leaf>& qtoken_set,
                                  const size_t group_limit,
                                  const std::vector<std::string>& group_by_fields, bool prioritize_exact_match,
-                                 const uint32_t* filter_ids, uint32_t filter_ids_length,
+                                 const bool exhaustive_search,
+                                 filter_iterator_t* filter_it,
                                  const uint32_t total_cost, const int syn_orig_num_tokens,
                                  const uint32_t* exclude_token_ids, size_t exclude_token_ids_size,
                                  const int* sort_order,
-                                 std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
+                                 std::array<sort_values_t*, 3>& field_values,
                                  const std::vector<size_t>& geopoint_indices,
                                  std::vector<uint32_t>& id_buff,
                                  uint32_t*& all_result_ids, size_t& all_result_ids_len) const {
 
+    const auto group_id_column = group_limit ? get_group_id_column(group_by_fields) : nullptr;
+
     std::vector<art_leaf*> query_suggestion;
 
     // one iterator for each token, each underlying iterator contains results of token across multiple fields
@@ -3019,7 +4130,7 @@ void Index::search_across_fields(const std::vector<token_t>& query_tokens,
     // used to track plists that must be destructed once done
     std::vector<posting_list_t*> expanded_plists;
 
-    result_iter_state_t istate(exclude_token_ids, exclude_token_ids_size, filter_ids, filter_ids_length);
+    result_iter_state_t istate(exclude_token_ids, exclude_token_ids_size, filter_it);
 
     // for each token, find the posting lists across all query_by fields
     for(size_t ti = 0; ti < query_tokens.size(); ti++) {
@@ -3083,8 +4194,72 @@ void Index::search_across_fields(const std::vector<token_t>& query_tokens,
 
     std::vector<uint32_t> result_ids;
 
+    size_t query_len = query_tokens.size();
+    if(syn_orig_num_tokens != -1) {
+        query_len = syn_orig_num_tokens;
+    }
+
+    // Block-max pruning: once the topster is full, a candidate is still counted as a result but is not scored
+    // when an upper bound of its score can't beat the topster's minimum. A bound is first checked using the best
+    // possible text match (constant for this query suggestion), which lets an entire seq_id block be skipped.
+    // Otherwise, the actual text match is computed and checked against the sort value bounds of the block.
+    const bool prune_candidates = !exhaustive_search && group_limit == 0;
+    std::array<const seq_id_block_bounds_t*, 3> block_bounds{};
+    int64_t text_match_bound = 0;
+    uint32_t skipped_block_id = UINT32_MAX;
+
+    if(prune_candidates) {
+        for(size_t i = 0; i < sort_fields.size() && i < block_bounds.size(); i++) {
+            auto bounds_it = sort_block_bounds.find(sort_fields[i].name);
+            if(bounds_it != sort_block_bounds.end() &&
+               std::find(geopoint_indices.begin(), geopoint_indices.end(), i) == geopoint_indices.end()) {
+                block_bounds[i] = bounds_it->second;
+            }
+        }
+
+        const uint64_t words_bound = std::max<int64_t>(std::max(query_tokens.size(), token_its.size()),
+                                                       syn_orig_num_tokens);
+        const uint64_t match_score_bound = (words_bound << 32) | (words_bound << 24) |
+                                           (uint64_t(255 - total_cost) << 16) | (uint64_t(100) << 8) | 0xFF;
+        size_t max_weight = 0;
+        for(size_t i = 0; i < num_search_fields; i++) {
+            max_weight = std::max(max_weight, the_fields[i].weight);
+        }
+
+        text_match_bound = (int64_t(query_len) << 48) | (int64_t(match_score_bound) << 8) | int64_t(max_weight);
+    }
+
     or_iterator_t::intersect(token_its, istate, [&](uint32_t seq_id, const std::vector<or_iterator_t>& its) {
         //LOG(INFO) << "seq_id: " << seq_id;
+        if(topster == nullptr) {
+            // only counted
+            result_ids.push_back(seq_id);
+            return;
+        }
+
+        const bool topster_full = prune_candidates && topster->size >= topster->MAX_SIZE;
+
+        if(topster_full) {
+            const uint32_t block_id = seq_id / seq_id_block_bounds_t::BLOCK_SIZE;
+            if(block_id == skipped_block_id) {
+                result_ids.push_back(seq_id);
+                return;
+            }
+
+            int64_t bounds[3] = {0};
+            compute_sort_score_bounds(sort_fields, sort_order, field_values, block_bounds, seq_id,
+                                      text_match_bound, bounds);
+
+            const int64_t* min_scores = topster->kvs[0]->scores;
+            if(std::tie(bounds[0], bounds[1], bounds[2]) < std::tie(min_scores[0], min_scores[1], min_scores[2])) {
+                // every other candidate of this block is bounded by the same values
+                skipped_block_id = block_id;
+                search_blocks_skipped++;
+                result_ids.push_back(seq_id);
+                return;
+            }
+        }
+
         // Convert [token -> fields] orientation to [field -> tokens] orientation
         std::vector<std::vector<posting_list_t::iterator_t>> field_to_tokens(num_search_fields);
 
@@ -3130,9 +4305,28 @@ void Index::search_across_fields(const std::vector<token_t>& query_tokens,
             }
         }
 
+        // NOTE: `query_len` is total tokens matched across fields.
+        // Within a field, only a subset can match
+
+        uint64_t aggregated_score = (int64_t(query_len) << 48) |
+                                    (int64_t(max_field_match_score) << 8) |
+                                    (int64_t(the_fields[max_field_match_index].weight) << 0);
+
+        if(topster_full) {
+            int64_t bounds[3] = {0};
+            compute_sort_score_bounds(sort_fields, sort_order, field_values, block_bounds, seq_id,
+                                      aggregated_score, bounds);
+
+            const int64_t* min_scores = topster->kvs[0]->scores;
+            if(std::tie(bounds[0], bounds[1], bounds[2]) < std::tie(min_scores[0], min_scores[1], min_scores[2])) {
+                result_ids.push_back(seq_id);
+                return;
+            }
+        }
+
         uint64_t distinct_id = seq_id;
         if(group_limit != 0) {
-            distinct_id = get_distinct_id(group_by_fields, seq_id);
+            distinct_id = get_distinct_id(*group_id_column, seq_id);
             groups_processed.emplace(distinct_id);
         }
 
@@ -3142,18 +4336,6 @@ void Index::search_across_fields(const std::vector<token_t>& query_tokens,
         compute_sort_scores(sort_fields, sort_order, field_values, geopoint_indices, seq_id,
                             max_field_match_score, scores, match_score_index);
 
-        size_t query_len = query_tokens.size();
-        if(syn_orig_num_tokens != -1) {
-            query_len = syn_orig_num_tokens;
-        }
-
-        // NOTE: `query_len` is total tokens matched across fields.
-        // Within a field, only a subset can match
-
-        uint64_t aggregated_score = (int64_t(query_len) << 48) |
-                                    (int64_t(max_field_match_score) << 8) |
-                                    (int64_t(the_fields[max_field_match_index].weight) << 0);
-
         /*LOG(INFO) << "seq_id: " << seq_id << ", query_tokens.size(): " << query_tokens.size()
                   << ", syn_orig_num_tokens: " << syn_orig_num_tokens
                   << ", max_field_match_score: " << max_field_match_score
@@ -3194,8 +4376,39 @@ void Index::search_across_fields(const std::vector<token_t>& query_tokens,
     }
 }
 
+void Index::compute_sort_score_bounds(const std::vector<sort_by>& sort_fields, const int* sort_order,
+                                      const std::array<sort_values_t*, 3>& field_values,
+                                      const std::array<const seq_id_block_bounds_t*, 3>& block_bounds,
+                                      const uint32_t seq_id, const int64_t text_match_score,
+                                      int64_t* bounds) const {
+    // upper bound of each of the values that `compute_sort_scores` can produce for the given seq_id
+    for(size_t i = 0; i < sort_fields.size() && i < 3; i++) {
+        bounds[i] = INT64_MAX;
+
+        if(field_values[i] == &text_match_sentinel_value) {
+            if(sort_order[i] == 1) {
+                bounds[i] = text_match_score;
+            }
+        } else if(field_values[i] == &seq_id_sentinel_value) {
+            // valid for every seq_id of the block
+            const uint32_t block_start = seq_id - (seq_id % seq_id_block_bounds_t::BLOCK_SIZE);
+            bounds[i] = (sort_order[i] == 1) ? int64_t(block_start) + seq_id_block_bounds_t::BLOCK_SIZE - 1 :
+                                               -int64_t(block_start);
+        } else if(block_bounds[i] != nullptr && sort_fields[i].missing_values != sort_by::missing_values_t::first) {
+            int64_t min_value, max_value;
+            block_bounds[i]->get(seq_id, min_value, max_value);
+
+            if(sort_order[i] == 1) {
+                bounds[i] = max_value;
+            } else if(min_value != INT64_MIN) {
+                bounds[i] = -min_value;
+            }
+        }
+    }
+}
+
 void Index::compute_sort_scores(const std::vector<sort_by>& sort_fields, const int* sort_order,
-                                std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3> field_values,
+                                std::array<sort_values_t*, 3> field_values,
                                 const std::vector<size_t>& geopoint_indices,
                                 uint32_t seq_id, int64_t max_field_match_score,
                                 int64_t* scores, int64_t& match_score_index) const {
@@ -3203,17 +4416,16 @@ void Index::compute_sort_scores(const std::vector<sort_by>& sort_fields, const i
     int64_t geopoint_distances[3];
 
     for(auto& i: geopoint_indices) {
-        spp::sparse_hash_map<uint32_t, int64_t>* geopoints = field_values[i];
+        sort_values_t* geopoints = field_values[i];
         int64_t dist = INT32_MAX;
 
         S2LatLng reference_lat_lng;
         GeoPoint::unpack_lat_lng(sort_fields[i].geopoint, reference_lat_lng);
 
         if(geopoints != nullptr) {
-            auto it = geopoints->find(seq_id);
+            int64_t packed_latlng;
 
-            if(it != geopoints->end()) {
-                int64_t packed_latlng = it->second;
+            if(geopoints->get(seq_id, packed_latlng)) {
                 S2LatLng s2_lat_lng;
                 GeoPoint::unpack_lat_lng(packed_latlng, s2_lat_lng);
                 dist = GeoPoint::distance(s2_lat_lng, reference_lat_lng);
@@ -3277,8 +4489,9 @@ void Index::compute_sort_scores(const std::vector<sort_by>& sort_fields, const i
                 }
             }
         } else {
-            auto it = field_values[0]->find(seq_id);
-            scores[0] = (it == field_values[0]->end()) ? default_score : it->second;
+            if(!field_values[0]->get(seq_id, scores[0])) {
+                scores[0] = default_score;
+            }
 
             if(scores[0] == INT64_MIN && sort_fields[0].missing_values == sort_by::missing_values_t::first) {
                 // By default, missing numerical value are always going to be sorted to be at the end
@@ -3316,8 +4529,9 @@ void Index::compute_sort_scores(const std::vector<sort_by>& sort_fields, const i
                 }
             }
         } else {
-            auto it = field_values[1]->find(seq_id);
-            scores[1] = (it == field_values[1]->end()) ? default_score : it->second;
+            if(!field_values[1]->get(seq_id, scores[1])) {
+                scores[1] = default_score;
+            }
             if(scores[1] == INT64_MIN && sort_fields[1].missing_values == sort_by::missing_values_t::first) {
                 bool is_asc = (sort_order[1] == -1);
                 scores[1] = is_asc ? (INT64_MIN + 1) : INT64_MAX;
@@ -3351,8 +4565,9 @@ void Index::compute_sort_scores(const std::vector<sort_by>& sort_fields, const i
                 }
             }
         } else {
-            auto it = field_values[2]->find(seq_id);
-            scores[2] = (it == field_values[2]->end()) ? default_score : it->second;
+            if(!field_values[2]->get(seq_id, scores[2])) {
+                scores[2] = default_score;
+            }
             if(scores[2] == INT64_MIN && sort_fields[2].missing_values == sort_by::missing_values_t::first) {
                 bool is_asc = (sort_order[2] == -1);
                 scores[2] = is_asc ? (INT64_MIN + 1) : INT64_MAX;
@@ -3367,10 +4582,7 @@ void Index::compute_sort_scores(const std::vector<sort_by>& sort_fields, const i
 
 void Index::do_phrase_search(const size_t num_search_fields, const std::vector<search_field_t>& search_fields,
                              std::vector<query_tokens_t>& field_query_tokens,
-                             uint32_t*& filter_ids, uint32_t& filter_ids_length) const {
-
-    uint32_t* phrase_match_ids = nullptr;
-    size_t phrase_match_ids_size = 0;
+                             uint32_t*& phrase_match_ids, size_t& phrase_match_ids_size) const {
 
     for(size_t i = 0; i < num_search_fields; i++) {
         const std::string& field_name = search_fields[i].name;
@@ -3430,7 +4642,7 @@ void Index::do_phrase_search(const size_t num_search_fields, const std::vector<s
         }
 
         // across fields, we have to OR phrase match ids
-        if(filter_ids_length == 0) {
+        if(phrase_match_ids_size == 0) {
             phrase_match_ids = field_phrase_match_ids;
             phrase_match_ids_size = field_phrase_match_ids_size;
         } else {
@@ -3443,26 +4655,6 @@ void Index::do_phrase_search(const size_t num_search_fields, const std::vector<s
             phrase_match_ids = phrase_ids_merged;
         }
     }
-
-    // AND phrase id matches with filter ids
-    if(filter_ids_length == 0) {
-        filter_ids = phrase_match_ids;
-        filter_ids_length = phrase_match_ids_size;
-    } else {
-        uint32_t* filter_ids_merged = nullptr;
-        filter_ids_length = ArrayUtils::and_scalar(filter_ids, filter_ids_length, phrase_match_ids,
-                                                   phrase_match_ids_size, &filter_ids_merged);
-
-        delete [] filter_ids;
-        filter_ids = filter_ids_merged;
-
-        delete [] phrase_match_ids;
-    }
-
-    if(filter_ids_length == 0) {
-        delete [] filter_ids;
-        filter_ids = nullptr;
-    }
 }
 
 void Index::do_synonym_search(const std::vector<search_field_t>& the_fields,
@@ -3482,17 +4674,17 @@ void Index::do_synonym_search(const std::vector<search_field_t>& the_fields,
                               spp::sparse_hash_set<uint64_t>& groups_processed,
                               std::vector<std::vector<art_leaf*>>& searched_queries,
                               uint32_t*& all_result_ids, size_t& all_result_ids_len,
-                              const uint32_t* filter_ids, const uint32_t filter_ids_length,
+                              filter_iterator_t* filter_it,
                               std::set<uint64>& query_hashes,
                               const int* sort_order,
-                              std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
+                              std::array<sort_values_t*, 3>& field_values,
                               const std::vector<size_t>& geopoint_indices,
                               tsl::htrie_map<char, token_leaf>& qtoken_set) const {
 
     for(const auto& syn_tokens: q_pos_synonyms) {
         query_hashes.clear();
         fuzzy_search_fields(the_fields, syn_tokens, exclude_token_ids,
-                            exclude_token_ids_size, filter_ids, filter_ids_length, curated_ids_sorted,
+                            exclude_token_ids_size, filter_it, curated_ids_sorted,
                             sort_fields_std, {0}, searched_queries, qtoken_set, actual_topster, groups_processed,
                             all_result_ids, all_result_ids_len, group_limit, group_by_fields, prioritize_exact_match,
                             query_hashes, token_order, {0}, typo_tokens_threshold,
@@ -3510,14 +4702,16 @@ void Index::do_infix_search(const size_t num_search_fields, const std::vector<se
                             const std::vector<std::string>& group_by_fields, const size_t max_extra_prefix,
                             const size_t max_extra_suffix,
                             const std::vector<token_t>& query_tokens, Topster* actual_topster,
-                            const uint32_t *filter_ids, size_t filter_ids_length,
+                            filter_iterator_t* filter_it,
                             const int sort_order[3],
-                            std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3> field_values,
+                            std::array<sort_values_t*, 3> field_values,
                             const std::vector<size_t>& geopoint_indices,
                             const std::vector<uint32_t>& curated_ids_sorted,
                             uint32_t*& all_result_ids, size_t& all_result_ids_len,
                             spp::sparse_hash_set<uint64_t>& groups_processed) const {
 
+    const auto group_id_column = group_limit ? get_group_id_column(group_by_fields) : nullptr;
+
     for(size_t field_id = 0; field_id < num_search_fields; field_id++) {
         auto& field_name = the_fields[field_id].name;
         infix_t field_infix = (field_id < infixes.size()) ? infixes[field_id] : infixes[0];
@@ -3542,20 +4736,21 @@ void Index::do_infix_search(const size_t num_search_fields, const std::vector<se
                     raw_infix_ids_length = infix_ids.size();
                 }
 
-                if(filter_ids_length != 0) {
-                    uint32_t *filtered_raw_infix_ids = nullptr;
-                    raw_infix_ids_length = ArrayUtils::and_scalar(filter_ids, filter_ids_length, raw_infix_ids,
-                                                                  raw_infix_ids_length, &filtered_raw_infix_ids);
-                    if(raw_infix_ids != &infix_ids[0]) {
-                        delete [] raw_infix_ids;
+                if(filter_it != nullptr) {
+                    size_t num_filtered = 0;
+                    for(size_t i = 0; i < raw_infix_ids_length; i++) {
+                        if(filter_it->contains(raw_infix_ids[i])) {
+                            raw_infix_ids[num_filtered++] = raw_infix_ids[i];
+                        }
                     }
 
-                    raw_infix_ids = filtered_raw_infix_ids;
+                    raw_infix_ids_length = num_filtered;
                 }
 
                 bool field_is_array = search_schema.at(the_fields[field_id].name).is_array();
 
-                for(size_t i = 0; i < raw_infix_ids_length; i++) {
+                // without a topster, infix matches are only counted
+                for(size_t i = 0; actual_topster != nullptr && i < raw_infix_ids_length; i++) {
                     auto seq_id = raw_infix_ids[i];
 
                     int64_t match_score = 0;
@@ -3570,7 +4765,7 @@ void Index::do_infix_search(const size_t num_search_fields, const std::vector<se
 
                     uint64_t distinct_id = seq_id;
                     if(group_limit != 0) {
-                        distinct_id = get_distinct_id(group_by_fields, seq_id);
+                        distinct_id = get_distinct_id(*group_id_column, seq_id);
                         groups_processed.emplace(distinct_id);
                     }
 
@@ -3663,11 +4858,16 @@ void Index::compute_facet_infos(const std::vector<facet>& facets, facet_query_t&
     for(size_t findex=0; findex < facets.size(); findex++) {
         const auto& a_facet = facets[findex];
 
-        const auto field_facet_mapping_it = facet_index_v3.find(a_facet.field_name);
-        if(field_facet_mapping_it == facet_index_v3.end()) {
+        if(a_facet.is_range_facet()) {
+            continue;
+        }
+
+        const auto field_facet_index_it = facet_index_v4.find(a_facet.field_name);
+        if(field_facet_index_it == facet_index_v4.end()) {
             continue;
         }
 
+        const facet_index_t* field_facet_index = field_facet_index_it->second;
         facet_infos[findex].use_facet_query = false;
 
         const field &facet_field = search_schema.at(a_facet.field_name);
@@ -3739,8 +4939,9 @@ void Index::compute_facet_infos(const std::vector<facet>& facets, facet_query_t&
                 for(size_t i = 0; i < std::min<size_t>(1000, field_result_ids_len); i++) {
                     uint32_t seq_id = field_result_ids[i];
 
-                    const auto doc_fvalues_it = field_facet_mapping_it->second[seq_id % ARRAY_FACET_DIM]->find(seq_id);
-                    if(doc_fvalues_it == field_facet_mapping_it->second[seq_id % ARRAY_FACET_DIM]->end()) {
+                    uint32_t num_values = 0;
+                    const uint32_t* doc_ordinals = field_facet_index->get_ordinals(seq_id, num_values);
+                    if(doc_ordinals == nullptr) {
                         continue;
                     }
 
@@ -3763,8 +4964,8 @@ void Index::compute_facet_infos(const std::vector<facet>& facets, facet_query_t&
                         posting_t::get_matching_array_indices(posting_lists, seq_id, array_indices);
 
                         for(size_t array_index: array_indices) {
-                            if(array_index < doc_fvalues_it->second.length) {
-                                uint64_t hash = doc_fvalues_it->second.hashes[array_index];
+                            if(array_index < num_values) {
+                                uint64_t hash = field_facet_index->get_hash(doc_ordinals[array_index]);
 
                                 /*LOG(INFO) << "seq_id: " << seq_id << ", hash: " << hash << ", array index: "
                                           << array_index;*/
@@ -3775,7 +4976,7 @@ void Index::compute_facet_infos(const std::vector<facet>& facets, facet_query_t&
                             }
                         }
                     } else {
-                        uint64_t hash = doc_fvalues_it->second.hashes[0];
+                        uint64_t hash = field_facet_index->get_hash(doc_ordinals[0]);
                         if(facet_infos[findex].hashes.count(hash) == 0) {
                             facet_infos[findex].hashes.emplace(hash, searched_tokens);
                         }
@@ -3788,32 +4989,36 @@ void Index::compute_facet_infos(const std::vector<facet>& facets, facet_query_t&
     }
 }
 
-void Index::curate_filtered_ids(const std::vector<filter>& filters, const std::set<uint32_t>& curated_ids,
-                                const uint32_t* exclude_token_ids, size_t exclude_token_ids_size,
-                                uint32_t*& filter_ids, uint32_t& filter_ids_length,
-                                const std::vector<uint32_t>& curated_ids_sorted) const {
-    // if filtered results are not available, use the seq_ids index to generate the list of all document ids
+void Index::curate_filtered_ids(filter_iterator_t* filter_it, const uint32_t* exclude_ids,
+                                const size_t exclude_ids_size, std::vector<uint32_t>& filter_ids) const {
+    size_t exclude_index = 0;
 
-    if(filters.empty() && filter_ids_length == 0) {
-        filter_ids_length = seq_ids->num_ids();
-        filter_ids = seq_ids->uncompress();
-    }
+    const auto take_id = [&](const uint32_t seq_id) {
+        // both IDs and excluded IDs are in ascending order
+        while(exclude_index < exclude_ids_size && exclude_ids[exclude_index] < seq_id) {
+            exclude_index++;
+        }
+
+        if(exclude_index == exclude_ids_size || exclude_ids[exclude_index] != seq_id) {
+            filter_ids.push_back(seq_id);
+        }
+    };
+
+    if(filter_it == nullptr) {
+        // if there is no filter, use the seq_ids index to generate the list of all document ids
+        filter_ids.reserve(seq_ids->num_ids());
+
+        for(auto it = seq_ids->new_iterator(); it.valid(); it.next()) {
+            take_id(it.id());
+        }
 
-    if(!curated_ids.empty()) {
-        uint32_t *excluded_result_ids = nullptr;
-        filter_ids_length = ArrayUtils::exclude_scalar(filter_ids, filter_ids_length, &curated_ids_sorted[0],
-                                                       curated_ids_sorted.size(), &excluded_result_ids);
-        delete [] filter_ids;
-        filter_ids = excluded_result_ids;
+        return ;
     }
 
-    // Exclude document IDs associated with excluded tokens from the result set
-    if(exclude_token_ids_size != 0) {
-        uint32_t *excluded_result_ids = nullptr;
-        filter_ids_length = ArrayUtils::exclude_scalar(filter_ids, filter_ids_length, exclude_token_ids,
-                                                       exclude_token_ids_size, &excluded_result_ids);
-        delete[] filter_ids;
-        filter_ids = excluded_result_ids;
+    filter_ids.reserve(std::min<size_t>(filter_it->estimate(), seq_ids->num_ids()));
+
+    for(filter_it->reset(); filter_it->valid(); filter_it->next()) {
+        take_id(filter_it->id());
     }
 }
 
@@ -3825,15 +5030,38 @@ void Index::search_wildcard(const std::vector<filter>& filters,
                             const std::vector<std::string>& group_by_fields, const std::set<uint32_t>& curated_ids,
                             const std::vector<uint32_t>& curated_ids_sorted, const uint32_t* exclude_token_ids,
                             size_t exclude_token_ids_size, const uint8_t field_id, const string& field,
-                            uint32_t*& all_result_ids, size_t& all_result_ids_len, const uint32_t* filter_ids,
-                            uint32_t filter_ids_length, const size_t concurrency,
+                            uint32_t*& all_result_ids, size_t& all_result_ids_len, filter_iterator_t* filter_it,
+                            const size_t concurrency,
                             const int* sort_order,
-                            std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values,
+                            std::array<sort_values_t*, 3>& field_values,
                             const std::vector<size_t>& geopoint_indices) const {
 
+    // the filter iterator is consumed once, and the IDs it produces are both scored and returned as the results
+    std::vector<uint32_t> filtered_ids;
+    curate_filtered_ids(filter_it, exclude_token_ids, exclude_token_ids_size, filtered_ids);
+
+    const uint32_t* filter_ids = filtered_ids.data();
+    const uint32_t filter_ids_length = filtered_ids.size();
+
+    // without a topster, the filtered ids are only counted
+    if(topster == nullptr ||
+       search_wildcard_presorted(sort_fields, topster, searched_queries, group_limit, filter_ids, filter_ids_length,
+                                 sort_order, field_values, geopoint_indices)) {
+        collate_included_ids({}, included_ids_map, curated_topster, searched_queries);
+
+        uint32_t* new_all_result_ids = nullptr;
+        all_result_ids_len = ArrayUtils::or_scalar(all_result_ids, all_result_ids_len, filter_ids,
+                                                   filter_ids_length, &new_all_result_ids);
+        delete [] all_result_ids;
+        all_result_ids = new_all_result_ids;
+        return ;
+    }
+
     uint32_t token_bits = 0;
     const bool check_for_circuit_break = (filter_ids_length > 1000000);
 
+    const auto group_id_column = group_limit ? get_group_id_column(group_by_fields) : nullptr;
+
     //auto beginF = std::chrono::high_resolution_clock::now();
 
     const size_t num_threads = std::min<size_t>(concurrency, filter_ids_length);
@@ -3868,10 +5096,11 @@ void Index::search_wildcard(const std::vector<filter>& filters,
         searched_queries.push_back({});
 
         topsters[thread_id] = new Topster(topster->MAX_SIZE, topster->distinct);
+        topsters[thread_id]->copy_cursor(*topster);
 
         thread_pool->enqueue([this, &parent_search_begin, &parent_search_stop_ms, &parent_search_cutoff,
                              thread_id, &sort_fields, &searched_queries, &field_id,
-                             &group_limit, &group_by_fields, &topsters, &tgroups_processed,
+                             &group_limit, &group_id_column, &topsters, &tgroups_processed,
                              &sort_order, field_values, &geopoint_indices, &plists,
                              check_for_circuit_break,
                              batch_result_ids, batch_res_len,
@@ -3896,7 +5125,7 @@ void Index::search_wildcard(const std::vector<filter>& filters,
 
                 uint64_t distinct_id = seq_id;
                 if(group_limit != 0) {
-                    distinct_id = get_distinct_id(group_by_fields, seq_id);
+                    distinct_id = get_distinct_id(*group_id_column, seq_id);
                     tgroups_processed[thread_id].emplace(distinct_id);
                 }
 
@@ -3942,9 +5171,97 @@ void Index::search_wildcard(const std::vector<filter>& filters,
     all_result_ids = new_all_result_ids;
 }
 
+bool Index::search_wildcard_presorted(const std::vector<sort_by>& sort_fields, Topster* topster,
+                                      std::vector<std::vector<art_leaf*>>& searched_queries, const size_t group_limit,
+                                      const uint32_t* filter_ids, const uint32_t filter_ids_length,
+                                      const int* sort_order, std::array<sort_values_t*, 3>& field_values,
+                                      const std::vector<size_t>& geopoint_indices) const {
+    if(group_limit != 0 || !geopoint_indices.empty() || filter_ids_length == 0 || topster->is_cursor_set()) {
+        return false;
+    }
+
+    // text match score is the same for all documents of a wildcard query, so only one field decides the order
+    const sort_by* presorted_field = nullptr;
+
+    for(const auto& sort_field: sort_fields) {
+        if(sort_field.name == sort_field_const::text_match) {
+            continue;
+        }
+
+        if(presorted_field != nullptr) {
+            return false;
+        }
+
+        presorted_field = &sort_field;
+    }
+
+    if(presorted_field == nullptr || presorted_field->missing_values == sort_by::missing_values_t::first) {
+        return false;
+    }
+
+    const auto presorted_it = presorted_index.find(presorted_field->name);
+    if(presorted_it == presorted_index.end()) {
+        return false;
+    }
+
+    const presorted_ids_t* presorted_ids = presorted_it->second;
+
+    // About `topster->MAX_SIZE * presorted_ids->size() / filter_ids_length` entries have to be walked to find
+    // enough documents passing the filter: only worth it when that's less than scoring every filtered document.
+    if(topster->MAX_SIZE * presorted_ids->size() > size_t(filter_ids_length) * filter_ids_length) {
+        return false;
+    }
+
+    std::vector<uint32_t> top_ids;
+
+    const auto collect_top_ids = [&](auto it, const auto end) {
+        int64_t last_value = 0;
+
+        for(; it != end; ++it) {
+            // documents tied with the last one collected could still be ordered ahead of it
+            if(top_ids.size() >= topster->MAX_SIZE && it->first != last_value) {
+                return true;
+            }
+
+            if(!std::binary_search(filter_ids, filter_ids + filter_ids_length, it->second)) {
+                continue;
+            }
+
+            top_ids.push_back(it->second);
+            last_value = it->first;
+        }
+
+        return top_ids.size() >= topster->MAX_SIZE;
+    };
+
+    const bool found_top_ids = (presorted_field->order == sort_field_const::asc) ?
+                               collect_top_ids(presorted_ids->begin(), presorted_ids->end()) :
+                               collect_top_ids(presorted_ids->rbegin(), presorted_ids->rend());
+
+    if(!found_top_ids) {
+        // documents without a value for the field are also needed
+        return false;
+    }
+
+    searched_queries.push_back({});
+
+    for(const uint32_t seq_id: top_ids) {
+        int64_t scores[3] = {0};
+        int64_t match_score_index = 0;
+
+        compute_sort_scores(sort_fields, sort_order, field_values, geopoint_indices, seq_id,
+                            100, scores, match_score_index);
+
+        KV kv(0, searched_queries.size(), 0, seq_id, seq_id, match_score_index, scores);
+        topster->add(&kv);
+    }
+
+    return true;
+}
+
 void Index::populate_sort_mapping(int* sort_order, std::vector<size_t>& geopoint_indices,
                                   const std::vector<sort_by>& sort_fields_std,
-                                  std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3>& field_values) const {
+                                  std::array<sort_values_t*, 3>& field_values) const {
     for (size_t i = 0; i < sort_fields_std.size(); i++) {
         sort_order[i] = 1;
         if (sort_fields_std[i].order == sort_field_const::asc) {
@@ -4020,6 +5337,11 @@ void Index::search_field(const uint8_t & field_id,
     // To prevent us from doing ART search repeatedly as we iterate through possible corrections
     spp::sparse_hash_map<std::string, std::vector<art_leaf*>> token_cost_cache;
 
+    std::unique_ptr<filter_leaf_iterator_t> filter_it;
+    if(filter_ids_length != 0) {
+        filter_it = new_ids_filter_iterator(filter_ids, filter_ids_length);
+    }
+
     std::vector<std::vector<int>> token_to_costs;
 
     for(size_t stoken_index=0; stoken_index < query_tokens.size(); stoken_index++) {
@@ -4095,7 +5417,7 @@ void Index::search_field(const uint8_t & field_id,
                 // need less candidates for filtered searches since we already only pick tokens with results
                 art_fuzzy_search(search_index.at(field_name), (const unsigned char *) token.c_str(), token_len,
                                  costs[token_index], costs[token_index], max_candidates, token_order, prefix_search,
-                                 filter_ids, filter_ids_length, leaves, unique_tokens);
+                                 filter_it.get(), leaves, unique_tokens);
 
                 /*auto timeMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
                                 std::chrono::high_resolution_clock::now() - begin).count();
@@ -4274,7 +5596,7 @@ void Index::score_results(const std::vector<sort_by> & sort_fields, const uint16
                           const std::vector<art_leaf *> &query_suggestion,
                           spp::sparse_hash_set<uint64_t>& groups_processed,
                           const uint32_t seq_id, const int sort_order[3],
-                          std::array<spp::sparse_hash_map<uint32_t, int64_t>*, 3> field_values,
+                          std::array<sort_values_t*, 3> field_values,
                           const std::vector<size_t>& geopoint_indices,
                           const size_t group_limit, const std::vector<std::string>& group_by_fields,
                           const uint32_t token_bits,
@@ -4286,17 +5608,16 @@ void Index::score_results(const std::vector<sort_by> & sort_fields, const uint16
     int64_t geopoint_distances[3];
 
     for(auto& i: geopoint_indices) {
-        spp::sparse_hash_map<uint32_t, int64_t>* geopoints = field_values[i];
+        sort_values_t* geopoints = field_values[i];
         int64_t dist = INT32_MAX;
 
         S2LatLng reference_lat_lng;
         GeoPoint::unpack_lat_lng(sort_fields[i].geopoint, reference_lat_lng);
 
         if(geopoints != nullptr) {
-            auto it = geopoints->find(seq_id);
+            int64_t packed_latlng;
 
-            if(it != geopoints->end()) {
-                int64_t packed_latlng = it->second;
+            if(geopoints->get(seq_id, packed_latlng)) {
                 S2LatLng s2_lat_lng;
                 GeoPoint::unpack_lat_lng(packed_latlng, s2_lat_lng);
                 dist = GeoPoint::distance(s2_lat_lng, reference_lat_lng);
@@ -4417,8 +5738,9 @@ void Index::score_results(const std::vector<sort_by> & sort_fields, const uint16
         } else if(field_values[0] == &str_sentinel_value) {
             scores[0] = str_sort_index.at(sort_fields[0].name)->rank(seq_id);
         } else {
-            auto it = field_values[0]->find(seq_id);
-            scores[0] = (it == field_values[0]->end()) ? default_score : it->second;
+            if(!field_values[0]->get(seq_id, scores[0])) {
+                scores[0] = default_score;
+            }
         }
 
         if (sort_order[0] == -1) {
@@ -4437,8 +5759,9 @@ void Index::score_results(const std::vector<sort_by> & sort_fields, const uint16
         } else if(field_values[1] == &str_sentinel_value) {
             scores[1] = str_sort_index.at(sort_fields[1].name)->rank(seq_id);
         } else {
-            auto it = field_values[1]->find(seq_id);
-            scores[1] = (it == field_values[1]->end()) ? default_score : it->second;
+            if(!field_values[1]->get(seq_id, scores[1])) {
+                scores[1] = default_score;
+            }
         }
 
         if (sort_order[1] == -1) {
@@ -4457,8 +5780,9 @@ void Index::score_results(const std::vector<sort_by> & sort_fields, const uint16
         } else if(field_values[2] == &str_sentinel_value) {
             scores[2] = str_sort_index.at(sort_fields[2].name)->rank(seq_id);
         } else {
-            auto it = field_values[2]->find(seq_id);
-            scores[2] = (it == field_values[2]->end()) ? default_score : it->second;
+            if(!field_values[2]->get(seq_id, scores[2])) {
+                scores[2] = default_score;
+            }
         }
 
         if (sort_order[2] == -1) {
@@ -4488,26 +5812,81 @@ uint64_t Index::get_distinct_id(const std::vector<std::string>& group_by_fields,
 
     // calculate hash from group_by_fields
     for(const auto& field: group_by_fields) {
-        const auto& field_facet_mapping_it = facet_index_v3.find(field);
-        if(field_facet_mapping_it == facet_index_v3.end()) {
+        const auto& field_facet_index_it = facet_index_v4.find(field);
+        if(field_facet_index_it == facet_index_v4.end()) {
             continue;
         }
 
-        const auto& field_facet_mapping = field_facet_mapping_it->second;
-        const auto& facet_hashes_it = field_facet_mapping[seq_id % ARRAY_FACET_DIM]->find(seq_id);
+        const facet_index_t* field_facet_index = field_facet_index_it->second;
+        uint32_t num_values = 0;
+        const uint32_t* ordinals = field_facet_index->get_ordinals(seq_id, num_values);
 
-        if(facet_hashes_it == field_facet_mapping[seq_id % ARRAY_FACET_DIM]->end()) {
-            continue;
+        for(size_t i = 0; i < num_values; i++) {
+            distinct_id = StringUtils::hash_combine(distinct_id, field_facet_index->get_hash(ordinals[i]));
         }
+    }
+
+    return distinct_id;
+}
+
+uint64_t Index::get_distinct_id(const group_id_column_t& group_id_column, const uint32_t seq_id) const {
+    int64_t group_id;
+    if(group_id_column.group_ids.get(seq_id, group_id)) {
+        return uint64_t(group_id);
+    }
+
+    return get_distinct_id(group_id_column.group_by_fields, seq_id);
+}
+
+std::shared_ptr<const group_id_column_t> Index::get_group_id_column(const std::vector<std::string>& group_by_fields) const {
+    const std::string column_key = StringUtils::join(group_by_fields, "\x1f");
+
+    std::unique_lock lock(group_id_columns_mutex);
+
+    auto column_it = group_id_columns.find(column_key);
+    if(column_it != group_id_columns.end()) {
+        return column_it.value();
+    }
+
+    auto group_id_column = std::make_shared<group_id_column_t>();
+    group_id_column->group_by_fields = group_by_fields;
+
+    const size_t num_ids = seq_ids->num_ids();
+    uint32_t* all_ids = seq_ids->uncompress();
+
+    for(size_t i = 0; i < num_ids; i++) {
+        group_id_column->group_ids.set(all_ids[i], get_distinct_id(group_by_fields, all_ids[i]));
+    }
+
+    delete [] all_ids;
+
+    group_id_columns.insert(column_key, group_id_column);
+    return group_id_column;
+}
+
+void Index::update_group_ids(const std::vector<index_record>& records) {
+    std::unique_lock lock(group_id_columns_mutex);
 
-        const auto& facet_hashes = facet_hashes_it->second;
+    for(const auto& column_entry: group_id_columns) {
+        group_id_column_t* group_id_column = column_entry.value().get();
 
-        for(size_t i = 0; i < facet_hashes.size(); i++) {
-            distinct_id = StringUtils::hash_combine(distinct_id, facet_hashes.hashes[i]);
+        for(const auto& record: records) {
+            if(!record.indexed.ok()) {
+                continue;
+            }
+
+            group_id_column->group_ids.set(record.seq_id,
+                                           get_distinct_id(group_id_column->group_by_fields, record.seq_id));
         }
     }
+}
 
-    return distinct_id;
+void Index::erase_group_ids(const uint32_t seq_id) {
+    std::unique_lock lock(group_id_columns_mutex);
+
+    for(const auto& column_entry: group_id_columns) {
+        column_entry.value()->group_ids.erase(seq_id);
+    }
 }
 
 inline uint32_t Index::next_suggestion2(const std::vector<tok_candidates>& token_candidates_vec,
@@ -4605,6 +5984,7 @@ void Index::remove_field(uint32_t seq_id, const nlohmann::json& document, const
     if(search_field.type == field_types::STRING_ARRAY || search_field.type == field_types::STRING) {
         std::vector<std::string> tokens;
         tokenize_string_field(document, search_field, tokens, search_field.locale, symbols_to_index, token_separators);
+        bool deleted_token = false;
 
         for(size_t i = 0; i < tokens.size(); i++) {
             const auto& token = tokens[i];
@@ -4617,14 +5997,18 @@ void Index::remove_field(uint32_t seq_id, const nlohmann::json& document, const
                 if (posting_t::num_ids(leaf->values) == 0) {
                     void* values = art_delete(search_index.at(field_name), key, key_len);
                     posting_t::destroy_list(values);
+                    deleted_token = true;
+
+                    // other documents could still contain the token
+                    if(search_field.infix) {
+                        infix_index.at(search_field.name)->erase(token);
+                    }
                 }
             }
+        }
 
-            if(search_field.infix) {
-                auto strhash = StringUtils::hash_wy(key, token.size());
-                const auto& infix_sets = infix_index.at(search_field.name);
-                infix_sets[strhash % 4]->erase(token);
-            }
+        if(deleted_token) {
+            bump_dictionary_epoch(field_name);
         }
     } else if(search_field.is_int32()) {
         const std::vector<int32_t>& values = search_field.is_single_integer() ?
@@ -4697,23 +6081,29 @@ void Index::remove_field(uint32_t seq_id, const nlohmann::json& document, const
     }
 
     // remove facets
-    const auto& field_facets_it = facet_index_v3.find(field_name);
+    const auto& field_facets_it = facet_index_v4.find(field_name);
 
-    if(field_facets_it != facet_index_v3.end()) {
-        const auto& fvalues_it = field_facets_it->second[seq_id % ARRAY_FACET_DIM]->find(seq_id);
-        if(fvalues_it != field_facets_it->second[seq_id % ARRAY_FACET_DIM]->end()) {
-            field_facets_it->second[seq_id % ARRAY_FACET_DIM]->erase(fvalues_it);
-        }
+    if(field_facets_it != facet_index_v4.end()) {
+        field_facets_it->second->erase(seq_id);
     }
 
     // remove sort field
     if(sort_index.count(field_name) != 0) {
+        const auto presorted_it = presorted_index.find(field_name);
+        int64_t sort_value;
+
+        if(presorted_it != presorted_index.end() && sort_index[field_name]->get(seq_id, sort_value)) {
+            presorted_it->second->erase({sort_value, seq_id});
+        }
+
         sort_index[field_name]->erase(seq_id);
     }
 
     if(str_sort_index.count(field_name) != 0) {
         str_sort_index[field_name]->remove(seq_id);
     }
+
+    bump_write_epoch(field_name);
 }
 
 Option<uint32_t> Index::remove(const uint32_t seq_id, const nlohmann::json & document,
@@ -4737,6 +6127,8 @@ Option<uint32_t> Index::remove(const uint32_t seq_id, const nlohmann::json & doc
 
     if(!is_update) {
         seq_ids->erase(seq_id);
+        erase_group_ids(seq_id);
+        bump_write_epoch("id");
     }
 
     return Option<uint32_t>(seq_id);
@@ -4774,13 +6166,19 @@ const spp::sparse_hash_map<std::string, num_tree_t*>& Index::_get_numerical_inde
     return numerical_index;
 }
 
-const spp::sparse_hash_map<std::string, array_mapped_infix_t>& Index::_get_infix_index() const {
+const spp::sparse_hash_map<std::string, infix_index_t*>& Index::_get_infix_index() const {
     return infix_index;
 };
 
 void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vector<field>& del_fields) {
     std::unique_lock lock(mutex);
 
+    {
+        // group ids are rebuilt from the new schema on their next use
+        std::unique_lock group_ids_lock(group_id_columns_mutex);
+        group_id_columns.clear();
+    }
+
     for(const auto & new_field: new_fields) {
         if(new_field.is_dynamic() || !new_field.index) {
             continue;
@@ -4790,8 +6188,13 @@ void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vec
 
         if(new_field.is_sortable()) {
             if(new_field.is_num_sortable()) {
-                spp::sparse_hash_map<uint32_t, int64_t> * doc_to_score = new spp::sparse_hash_map<uint32_t, int64_t>();
+                sort_values_t* doc_to_score = new sort_values_t();
                 sort_index.emplace(new_field.name, doc_to_score);
+                sort_block_bounds.emplace(new_field.name, new seq_id_block_bounds_t());
+
+                if(new_field.presorted) {
+                    presorted_index.emplace(new_field.name, new presorted_ids_t());
+                }
             } else if(new_field.is_str_sortable()) {
                 str_sort_index.emplace(new_field.name, new adi_tree_t);
             }
@@ -4816,12 +6219,7 @@ void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vec
         }
 
         if(new_field.is_facet()) {
-            array_mapped_facet_t facet_array;
-            for(size_t i = 0; i < ARRAY_FACET_DIM; i++) {
-                facet_array[i] = new facet_map_t();
-            }
-
-            facet_index_v3.emplace(new_field.name, facet_array);
+            facet_index_v4.emplace(new_field.name, new facet_index_t());
 
             // initialize for non-string facet fields
             if(!new_field.is_string()) {
@@ -4832,12 +6230,7 @@ void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vec
         }
 
         if(new_field.infix) {
-            array_mapped_infix_t infix_sets(ARRAY_INFIX_DIM);
-            for(auto& infix_set: infix_sets) {
-                infix_set = new tsl::htrie_set<char>();
-            }
-
-            infix_index.emplace(new_field.name, infix_sets);
+            infix_index.emplace(new_field.name, new infix_index_t());
         }
     }
 
@@ -4848,6 +6241,8 @@ void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vec
         }
 
         search_schema.erase(del_field.name);
+        bump_write_epoch(del_field.name);
+        bump_dictionary_epoch(del_field.faceted_name());
 
         if(del_field.is_string() || field_types::is_string_or_array(del_field.type)) {
             art_tree_destroy(search_index[del_field.name]);
@@ -4874,6 +6269,13 @@ void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vec
             if(del_field.is_num_sortable()) {
                 delete sort_index[del_field.name];
                 sort_index.erase(del_field.name);
+                delete sort_block_bounds[del_field.name];
+                sort_block_bounds.erase(del_field.name);
+
+                if(presorted_index.count(del_field.name) != 0) {
+                    delete presorted_index[del_field.name];
+                    presorted_index.erase(del_field.name);
+                }
             } else if(del_field.is_str_sortable()) {
                 delete str_sort_index[del_field.name];
                 str_sort_index.erase(del_field.name);
@@ -4881,12 +6283,8 @@ void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vec
         }
 
         if(del_field.is_facet()) {
-            auto& arr = facet_index_v3[del_field.name];
-            for(size_t i = 0; i < ARRAY_FACET_DIM; i++) {
-                delete arr[i];
-            }
-
-            facet_index_v3.erase(del_field.name);
+            delete facet_index_v4[del_field.name];
+            facet_index_v4.erase(del_field.name);
 
             if(!del_field.is_string()) {
                 art_tree_destroy(search_index[del_field.faceted_name()]);
@@ -4896,11 +6294,7 @@ void Index::refresh_schemas(const std::vector<field>& new_fields, const std::vec
         }
 
         if(del_field.infix) {
-            auto& infix_set = infix_index[del_field.name];
-            for(size_t i = 0; i < infix_set.size(); i++) {
-                delete infix_set[i];
-            }
-
+            delete infix_index[del_field.name];
             infix_index.erase(del_field.name);
         }
     }
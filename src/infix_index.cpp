@@ -0,0 +1,130 @@
+#include "infix_index.h"
+#include <algorithm>
+
+void infix_index_t::get_grams(const std::string& token, std::vector<uint32_t>& grams) {
+    for(size_t i = 0; i + GRAM_LEN <= token.size(); i++) {
+        grams.push_back((uint32_t(uint8_t(token[i])) << 16) | (uint32_t(uint8_t(token[i+1])) << 8) |
+                        uint32_t(uint8_t(token[i+2])));
+    }
+
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+}
+
+void infix_index_t::insert(const std::string& token) {
+    if(token_ids.find(token) != token_ids.end()) {
+        return ;
+    }
+
+    uint32_t token_id;
+
+    if(!free_token_ids.empty()) {
+        token_id = free_token_ids.back();
+        free_token_ids.pop_back();
+        tokens[token_id] = token;
+    } else {
+        token_id = tokens.size();
+        tokens.push_back(token);
+    }
+
+    token_ids.insert(token, token_id);
+
+    std::vector<uint32_t> grams;
+    get_grams(token, grams);
+
+    for(uint32_t gram: grams) {
+        auto gram_it = gram_token_ids.find(gram);
+        if(gram_it == gram_token_ids.end()) {
+            gram_token_ids.emplace(gram, SET_COMPACT_IDS(compact_id_list_t::create(1, {token_id})));
+        } else {
+            ids_t::upsert(gram_it->second, token_id);
+        }
+    }
+}
+
+void infix_index_t::erase(const std::string& token) {
+    auto token_it = token_ids.find(token);
+    if(token_it == token_ids.end()) {
+        return ;
+    }
+
+    const uint32_t token_id = token_it.value();
+    token_ids.erase(token_it);
+
+    std::vector<uint32_t> grams;
+    get_grams(token, grams);
+
+    for(uint32_t gram: grams) {
+        auto gram_it = gram_token_ids.find(gram);
+        if(gram_it == gram_token_ids.end()) {
+            continue;
+        }
+
+        ids_t::erase(gram_it->second, token_id);
+
+        if(ids_t::num_ids(gram_it->second) == 0) {
+            ids_t::destroy_list(gram_it->second);
+            gram_token_ids.erase(gram_it);
+        }
+    }
+
+    tokens[token_id].clear();
+    tokens[token_id].shrink_to_fit();
+    free_token_ids.push_back(token_id);
+}
+
+bool infix_index_t::get_candidates(const std::string& query, std::vector<uint32_t>& candidate_ids) const {
+    if(query.size() < GRAM_LEN) {
+        return false;
+    }
+
+    std::vector<uint32_t> grams;
+    get_grams(query, grams);
+
+    std::vector<void*> id_lists;
+    for(uint32_t gram: grams) {
+        auto gram_it = gram_token_ids.find(gram);
+        if(gram_it == gram_token_ids.end()) {
+            return true;
+        }
+
+        id_lists.push_back(gram_it->second);
+    }
+
+    // intersect from the rarest trigram onwards
+    std::sort(id_lists.begin(), id_lists.end(), [](const void* a, const void* b) {
+        return ids_t::num_ids(a) < ids_t::num_ids(b);
+    });
+
+    if(id_lists.size() == 1) {
+        uint32_t* ids = ids_t::uncompress(id_lists[0]);
+        candidate_ids.assign(ids, ids + ids_t::num_ids(id_lists[0]));
+        delete [] ids;
+    } else {
+        ids_t::intersect(id_lists, candidate_ids);
+    }
+
+    return true;
+}
+
+const std::string& infix_index_t::get_token(uint32_t token_id) const {
+    return tokens[token_id];
+}
+
+size_t infix_index_t::num_token_ids() const {
+    return tokens.size();
+}
+
+size_t infix_index_t::num_grams() const {
+    return gram_token_ids.size();
+}
+
+size_t infix_index_t::size() const {
+    return token_ids.size();
+}
+
+infix_index_t::~infix_index_t() {
+    for(auto& kv: gram_token_ids) {
+        ids_t::destroy_list(kv.second);
+    }
+}
@@ -14,33 +14,26 @@ void num_tree_t::insert(int64_t value, uint32_t id) {
     }
 }
 
-void num_tree_t::range_inclusive_search(int64_t start, int64_t end, uint32_t** ids, size_t& ids_len) {
+void num_tree_t::range_inclusive_search(int64_t start, int64_t end, id_bitmap_t& result) {
     if(int64map.empty()) {
         return ;
     }
 
     auto it_start = int64map.lower_bound(start);  // iter values will be >= start
+    std::vector<void*> id_lists;
 
-    std::vector<uint32_t> consolidated_ids;
     while(it_start != int64map.end() && it_start->first <= end) {
-        uint32_t* values = ids_t::uncompress(it_start->second);
-
-        for(size_t i = 0; i < ids_t::num_ids(it_start->second); i++) {
-            consolidated_ids.push_back(values[i]);
-        }
-
-        delete [] values;
+        id_lists.push_back(it_start->second);
         it_start++;
     }
 
-    gfx::timsort(consolidated_ids.begin(), consolidated_ids.end());
-
-    uint32_t *out = nullptr;
-    ids_len = ArrayUtils::or_scalar(&consolidated_ids[0], consolidated_ids.size(),
-                                    *ids, ids_len, &out);
+    ids_t::merge(id_lists, result);
+}
 
-    delete [] *ids;
-    *ids = out;
+void num_tree_t::range_inclusive_search(int64_t start, int64_t end, uint32_t** ids, size_t& ids_len) {
+    id_bitmap_t result;
+    range_inclusive_search(start, end, result);
+    merge_into_array(result, ids, ids_len);
 }
 
 size_t num_tree_t::get(int64_t value, std::vector<uint32_t>& geo_result_ids) {
@@ -59,21 +52,18 @@ size_t num_tree_t::get(int64_t value, std::vector<uint32_t>& geo_result_ids) {
     return ids_t::num_ids(it->second);
 }
 
-void num_tree_t::search(NUM_COMPARATOR comparator, int64_t value, uint32_t** ids, size_t& ids_len) {
+void num_tree_t::search(NUM_COMPARATOR comparator, int64_t value, id_bitmap_t& result) {
     if(int64map.empty()) {
         return ;
     }
 
+    // lists of all the matching values are merged at once
+    std::vector<void*> id_lists;
+
     if(comparator == EQUALS) {
         const auto& it = int64map.find(value);
         if(it != int64map.end()) {
-            uint32_t *out = nullptr;
-            uint32_t* val_ids = ids_t::uncompress(it->second);
-            ids_len = ArrayUtils::or_scalar(val_ids, ids_t::num_ids(it->second),
-                                            *ids, ids_len, &out);
-            delete[] *ids;
-            *ids = out;
-            delete[] val_ids;
+            id_lists.push_back(it->second);
         }
     } else if(comparator == GREATER_THAN || comparator == GREATER_THAN_EQUALS) {
         // iter entries will be >= value, or end() if all entries are before value
@@ -87,66 +77,48 @@ void num_tree_t::search(NUM_COMPARATOR comparator, int64_t value, uint32_t** ids
             iter_ge_value++;
         }
 
-        std::vector<uint32_t> consolidated_ids;
         while(iter_ge_value != int64map.end()) {
-            uint32_t* values = ids_t::uncompress(iter_ge_value->second);
-
-            for(size_t i = 0; i < ids_t::num_ids(iter_ge_value->second); i++) {
-                consolidated_ids.push_back(values[i]);
-            }
-
-            delete [] values;
+            id_lists.push_back(iter_ge_value->second);
             iter_ge_value++;
         }
-
-        gfx::timsort(consolidated_ids.begin(), consolidated_ids.end());
-
-        consolidated_ids.erase(unique(consolidated_ids.begin(), consolidated_ids.end()), consolidated_ids.end());
-
-        uint32_t *out = nullptr;
-        ids_len = ArrayUtils::or_scalar(&consolidated_ids[0], consolidated_ids.size(),
-                                        *ids, ids_len, &out);
-
-        delete [] *ids;
-        *ids = out;
-
     } else if(comparator == LESS_THAN || comparator == LESS_THAN_EQUALS) {
         // iter entries will be >= value, or end() if all entries are before value
         auto iter_ge_value = int64map.lower_bound(value);
-
-        std::vector<uint32_t> consolidated_ids;
         auto it = int64map.begin();
 
         while(it != iter_ge_value) {
-            uint32_t* values = ids_t::uncompress(it->second);
-
-            for(size_t i = 0; i < ids_t::num_ids(it->second); i++) {
-                consolidated_ids.push_back(values[i]);
-            }
-
-            delete [] values;
+            id_lists.push_back(it->second);
             it++;
         }
 
         // for LESS_THAN_EQUALS, check if last iter entry is equal to value
         if(it != int64map.end() && comparator == LESS_THAN_EQUALS && it->first == value) {
-            uint32_t* values = ids_t::uncompress(it->second);
-            for(size_t i = 0; i < ids_t::num_ids(it->second); i++) {
-                consolidated_ids.push_back(values[i]);
-            }
-            delete [] values;
+            id_lists.push_back(it->second);
         }
+    }
 
-        gfx::timsort(consolidated_ids.begin(), consolidated_ids.end());
-        consolidated_ids.erase(unique(consolidated_ids.begin(), consolidated_ids.end()), consolidated_ids.end());
+    ids_t::merge(id_lists, result);
+}
 
-        uint32_t *out = nullptr;
-        ids_len = ArrayUtils::or_scalar(&consolidated_ids[0], consolidated_ids.size(),
-                                        *ids, ids_len, &out);
+void num_tree_t::search(NUM_COMPARATOR comparator, int64_t value, uint32_t** ids, size_t& ids_len) {
+    id_bitmap_t result;
+    search(comparator, value, result);
+    merge_into_array(result, ids, ids_len);
+}
 
-        delete [] *ids;
-        *ids = out;
+void num_tree_t::merge_into_array(const id_bitmap_t& result, uint32_t** ids, size_t& ids_len) {
+    if(result.empty()) {
+        return ;
     }
+
+    uint32_t* result_ids = result.uncompress();
+
+    uint32_t *out = nullptr;
+    ids_len = ArrayUtils::or_scalar(result_ids, result.cardinality(), *ids, ids_len, &out);
+
+    delete [] result_ids;
+    delete [] *ids;
+    *ids = out;
 }
 
 void num_tree_t::remove(uint64_t value, uint32_t id) {
@@ -163,6 +135,21 @@ void num_tree_t::remove(uint64_t value, uint32_t id) {
     }
 }
 
+size_t num_tree_t::count(int64_t start, int64_t end, size_t max_values) {
+    size_t num_ids = 0;
+    size_t num_values = 0;
+
+    for(auto it = int64map.lower_bound(start); it != int64map.end() && it->first <= end; it++) {
+        if(++num_values > max_values) {
+            return SIZE_MAX;
+        }
+
+        num_ids += ids_t::num_ids(it->second);
+    }
+
+    return num_ids;
+}
+
 size_t num_tree_t::size() {
     return int64map.size();
 }
@@ -171,20 +171,7 @@ uint32_t or_iterator_t::id() const {
 }
 
 bool or_iterator_t::take_id(result_iter_state_t& istate, uint32_t id) {
-    // decide if this result id should be excluded
-    if(istate.excluded_result_ids_size != 0) {
-        if (std::binary_search(istate.excluded_result_ids,
-                               istate.excluded_result_ids + istate.excluded_result_ids_size, id)) {
-            return false;
-        }
-    }
-
-    // decide if this result be matched with filter results
-    if(istate.filter_ids_length != 0) {
-        return std::binary_search(istate.filter_ids, istate.filter_ids + istate.filter_ids_length, id);
-    }
-
-    return true;
+    return posting_list_t::take_id(istate, id);
 }
 
 or_iterator_t::or_iterator_t(std::vector<posting_list_t::iterator_t>& its): its(std::move(its)) {
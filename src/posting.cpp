@@ -1,5 +1,6 @@
 #include "posting.h"
 #include "posting_list.h"
+#include "filter_iterator.h"
 
 int64_t compact_posting_list_t::upsert(const uint32_t id, const std::vector<uint32_t>& offsets) {
     return upsert(id, &offsets[0], offsets.size());
@@ -243,6 +244,23 @@ bool compact_posting_list_t::contains_atleast_one(const uint32_t* target_ids, si
     return false;
 }
 
+bool compact_posting_list_t::contains_atleast_one(filter_iterator_t* filter_it) {
+    size_t i = 0;
+
+    while(i < length) {
+        size_t num_existing_offsets = id_offsets[i];
+        size_t existing_id = id_offsets[i + num_existing_offsets + 1];
+
+        if(filter_it->contains(existing_id)) {
+            return true;
+        }
+
+        i += num_existing_offsets + 2;
+    }
+
+    return false;
+}
+
 /* posting operations */
 
 void posting_t::upsert(void*& obj, uint32_t id, const std::vector<uint32_t>& offsets) {
@@ -363,6 +381,16 @@ bool posting_t::contains(const void* obj, uint32_t id) {
     }
 }
 
+bool posting_t::contains_atleast_one(const void* obj, filter_iterator_t* filter_it) {
+    if(IS_COMPACT_POSTING(obj)) {
+        compact_posting_list_t* list = COMPACT_POSTING_PTR(obj);
+        return list->contains_atleast_one(filter_it);
+    } else {
+        posting_list_t* list = (posting_list_t*)(obj);
+        return list->contains_atleast_one(filter_it);
+    }
+}
+
 bool posting_t::contains_atleast_one(const void* obj, const uint32_t* target_ids, size_t target_ids_size) {
     if(IS_COMPACT_POSTING(obj)) {
         compact_posting_list_t* list = COMPACT_POSTING_PTR(obj);
@@ -2,6 +2,7 @@
 #include <bitset>
 #include "for.h"
 #include "array_utils.h"
+#include "filter_iterator.h"
 
 /* block_t operations */
 
@@ -731,15 +732,7 @@ void posting_list_t::intersect(const std::vector<posting_list_t*>& posting_lists
 
     switch (num_lists) {
         case 2:
-            while(!at_end2(its)) {
-                if(equals2(its)) {
-                    //LOG(INFO) << its[0].id();
-                    result_ids.push_back(its[0].id());
-                    advance_all2(its);
-                } else {
-                    advance_non_largest2(its);
-                }
-            }
+            block_intersect2(its[0], its[1], result_ids);
             break;
         default:
             while(!at_end(its)) {
@@ -754,18 +747,73 @@ void posting_list_t::intersect(const std::vector<posting_list_t*>& posting_lists
     }
 }
 
+void posting_list_t::block_intersect2(iterator_t& it1, iterator_t& it2, std::vector<uint32_t>& result_ids) {
+    // Intersects the remainder of the current blocks of both iterators with the vectorized kernel and then
+    // moves past whichever block ends first
+    std::vector<uint32_t> block_results;
+
+    while(it1.valid() && it2.valid()) {
+        const uint32_t size1 = it1.block()->size();
+        const uint32_t size2 = it2.block()->size();
+        const uint32_t len1 = size1 - it1.index();
+        const uint32_t len2 = size2 - it2.index();
+
+        block_results.resize(std::min(len1, len2));
+        size_t num_found = ArrayUtils::and_into(it1.ids + it1.index(), len1, it2.ids + it2.index(), len2,
+                                                block_results.data());
+        result_ids.insert(result_ids.end(), block_results.begin(), block_results.begin() + num_found);
+
+        const uint32_t last1 = it1.ids[size1 - 1];
+        const uint32_t last2 = it2.ids[size2 - 1];
+
+        if(last1 == UINT32_MAX && last2 == UINT32_MAX) {
+            break;
+        }
+
+        if(last1 <= last2) {
+            it1.skip_to(last1 + 1);
+        }
+
+        if(last2 <= last1) {
+            it2.skip_to(last2 + 1);
+        }
+    }
+}
+
 bool posting_list_t::take_id(result_iter_state_t& istate, uint32_t id) {
+    // ids are offered in ascending order, so both lists are galloped from the last position
     // decide if this result id should be excluded
     if(istate.excluded_result_ids_size != 0) {
-        if (std::binary_search(istate.excluded_result_ids,
-                               istate.excluded_result_ids + istate.excluded_result_ids_size, id)) {
+        if(istate.excluded_result_ids_index != 0 &&
+           istate.excluded_result_ids[istate.excluded_result_ids_index-1] >= id) {
+            istate.excluded_result_ids_index = 0;
+        }
+
+        istate.excluded_result_ids_index = ArrayUtils::gallop_lower_bound(istate.excluded_result_ids,
+                                                                          istate.excluded_result_ids_index,
+                                                                          istate.excluded_result_ids_size, id);
+
+        if(istate.excluded_result_ids_index != istate.excluded_result_ids_size &&
+           istate.excluded_result_ids[istate.excluded_result_ids_index] == id) {
             return false;
         }
     }
 
     // decide if this result be matched with filter results
+    if(istate.filter_it != nullptr) {
+        return istate.filter_it->contains(id);
+    }
+
     if(istate.filter_ids_length != 0) {
-        return std::binary_search(istate.filter_ids, istate.filter_ids + istate.filter_ids_length, id);
+        if(istate.filter_ids_index != 0 && istate.filter_ids[istate.filter_ids_index-1] >= id) {
+            istate.filter_ids_index = 0;
+        }
+
+        istate.filter_ids_index = ArrayUtils::gallop_lower_bound(istate.filter_ids, istate.filter_ids_index,
+                                                                 istate.filter_ids_length, id);
+
+        return istate.filter_ids_index != istate.filter_ids_length &&
+               istate.filter_ids[istate.filter_ids_index] == id;
     }
 
     return true;
@@ -1051,6 +1099,41 @@ bool posting_list_t::contains_atleast_one(const uint32_t* target_ids, size_t tar
     return false;
 }
 
+bool posting_list_t::contains_atleast_one(filter_iterator_t* filter_it) {
+    posting_list_t::iterator_t it = new_iterator();
+
+    if(num_ids() <= filter_it->estimate()) {
+        while(it.valid()) {
+            if(filter_it->contains(it.id())) {
+                return true;
+            }
+
+            it.next();
+        }
+
+        return false;
+    }
+
+    filter_it->reset();
+
+    while(filter_it->valid()) {
+        const uint32_t filter_id = filter_it->id();
+        it.skip_to(filter_id);
+
+        if(!it.valid()) {
+            return false;
+        }
+
+        if(it.id() == filter_id) {
+            return true;
+        }
+
+        filter_it->skip_to(it.id());
+    }
+
+    return false;
+}
+
 void posting_list_t::get_exact_matches(std::vector<iterator_t>& its, const bool field_is_array,
                                        const uint32_t* ids, const uint32_t num_ids,
                                        uint32_t*& exact_ids, size_t& num_exact_ids) {
@@ -1381,10 +1464,14 @@ posting_list_t::block_t* posting_list_t::iterator_t::block() const {
 }
 
 void posting_list_t::iterator_t::skip_to(uint32_t id) {
+    // blocks that end before `id` are skipped without being uncompressed
     bool skipped_block = false;
     while(curr_block != end_block && curr_block->ids.last() < id) {
         curr_block = curr_block->next;
+        skipped_block = true;
+    }
 
+    if(skipped_block) {
         delete [] ids;
         delete [] offset_index;
         delete [] offsets;
@@ -1397,15 +1484,11 @@ void posting_list_t::iterator_t::skip_to(uint32_t id) {
             offsets = curr_block->offsets.uncompress();
         }
 
-        skipped_block = true;
-    }
-
-    if(skipped_block) {
         curr_index = 0;
     }
 
-    while(curr_block != end_block && curr_index < curr_block->size() && this->id() < id) {
-        curr_index++;
+    if(curr_block != end_block) {
+        curr_index = ArrayUtils::gallop_lower_bound(ids, curr_index, curr_block->size(), id);
     }
 }
 
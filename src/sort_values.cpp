@@ -0,0 +1,152 @@
+#include "sort_values.h"
+
+// dense chunks take 8 bytes per seq_id, while a sparse map entry takes a little over twice that
+static constexpr size_t DENSE_MIN_FILL_RATIO = 2;
+
+// a lower fill ratio to switch back, so that deletions around the cut-off don't keep converting the values
+static constexpr size_t SPARSE_MAX_FILL_RATIO = 4;
+
+sort_values_t::~sort_values_t() {
+    for(chunk_t* chunk: chunks) {
+        delete chunk;
+    }
+
+    chunks.clear();
+}
+
+void sort_values_t::set(const uint32_t seq_id, const int64_t value) {
+    if(seq_id >= seq_id_span) {
+        seq_id_span = size_t(seq_id) + 1;
+    }
+
+    if(dense) {
+        set_dense(seq_id, value);
+    } else {
+        const auto it = sparse_values.find(seq_id);
+        if(it != sparse_values.end()) {
+            it->second = value;
+            return ;
+        }
+
+        sparse_values.emplace(seq_id, value);
+        num_values++;
+    }
+
+    if(num_values % DENSITY_CHECK_INTERVAL == 0) {
+        check_density();
+    }
+}
+
+void sort_values_t::erase(const uint32_t seq_id) {
+    if(dense) {
+        if(!erase_dense(seq_id)) {
+            return ;
+        }
+    } else {
+        if(sparse_values.erase(seq_id) == 0) {
+            return ;
+        }
+
+        num_values--;
+    }
+
+    if(num_values % DENSITY_CHECK_INTERVAL == 0) {
+        check_density();
+    }
+}
+
+void sort_values_t::set_dense(const uint32_t seq_id, const int64_t value) {
+    const size_t chunk_index = seq_id / CHUNK_SIZE;
+    if(chunk_index >= chunks.size()) {
+        chunks.resize(chunk_index + 1, nullptr);
+    }
+
+    if(chunks[chunk_index] == nullptr) {
+        chunks[chunk_index] = new chunk_t;
+    }
+
+    chunk_t* chunk = chunks[chunk_index];
+    const size_t offset = seq_id % CHUNK_SIZE;
+    const uint64_t bit = (1ULL << (offset % 64));
+
+    if((chunk->present[offset / 64] & bit) == 0) {
+        chunk->present[offset / 64] |= bit;
+        chunk->num_values++;
+        num_values++;
+    }
+
+    chunk->values[offset] = value;
+}
+
+bool sort_values_t::erase_dense(const uint32_t seq_id) {
+    const size_t chunk_index = seq_id / CHUNK_SIZE;
+    if(chunk_index >= chunks.size() || chunks[chunk_index] == nullptr) {
+        return false;
+    }
+
+    chunk_t* chunk = chunks[chunk_index];
+    const size_t offset = seq_id % CHUNK_SIZE;
+    const uint64_t bit = (1ULL << (offset % 64));
+
+    if((chunk->present[offset / 64] & bit) == 0) {
+        return false;
+    }
+
+    chunk->present[offset / 64] &= ~bit;
+    chunk->num_values--;
+    num_values--;
+
+    if(chunk->num_values == 0) {
+        delete chunk;
+        chunks[chunk_index] = nullptr;
+    }
+
+    return true;
+}
+
+void sort_values_t::check_density() {
+    if(!dense && num_values != 0 && num_values * DENSE_MIN_FILL_RATIO >= seq_id_span) {
+        to_dense();
+    } else if(dense && num_values * SPARSE_MAX_FILL_RATIO < seq_id_span) {
+        to_sparse();
+    }
+}
+
+void sort_values_t::to_dense() {
+    dense = true;
+    num_values = 0;
+
+    for(const auto& kv: sparse_values) {
+        set_dense(kv.first, kv.second);
+    }
+
+    spp::sparse_hash_map<uint32_t, int64_t>().swap(sparse_values);
+}
+
+void sort_values_t::to_sparse() {
+    for(size_t chunk_index = 0; chunk_index < chunks.size(); chunk_index++) {
+        chunk_t* chunk = chunks[chunk_index];
+        if(chunk == nullptr) {
+            continue;
+        }
+
+        for(size_t offset = 0; offset < CHUNK_SIZE; offset++) {
+            if(chunk->present[offset / 64] & (1ULL << (offset % 64))) {
+                sparse_values.emplace(uint32_t(chunk_index * CHUNK_SIZE + offset), chunk->values[offset]);
+            }
+        }
+
+        delete chunk;
+    }
+
+    std::vector<chunk_t*>().swap(chunks);
+    dense = false;
+}
+
+size_t sort_values_t::size() const {
+    return num_values;
+}
+
+bool sort_values_t::is_dense() const {
+    return dense;
+}
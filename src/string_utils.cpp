@@ -184,6 +184,32 @@ void StringUtils::split_to_values(const std::string& vals_str, std::vector<std::
     }
 }
 
+void StringUtils::split_facet(const std::string& facet_str, std::vector<std::string>& facets) {
+    std::string buffer;
+    size_t paren_depth = 0;
+
+    for(char c: facet_str) {
+        if(c == '(') {
+            paren_depth++;
+        } else if(c == ')' && paren_depth != 0) {
+            paren_depth--;
+        } else if(c == ',' && paren_depth == 0) {
+            if(!StringUtils::trim(buffer).empty()) {
+                facets.push_back(buffer);
+            }
+
+            buffer.clear();
+            continue;
+        }
+
+        buffer += c;
+    }
+
+    if(!StringUtils::trim(buffer).empty()) {
+        facets.push_back(buffer);
+    }
+}
+
 std::string StringUtils::float_to_str(float value) {
     std::ostringstream os;
     os << value;
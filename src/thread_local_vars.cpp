@@ -5,3 +5,5 @@ thread_local int64_t write_log_index = 0;
 thread_local std::chrono::high_resolution_clock::time_point search_begin;
 thread_local int64_t search_stop_ms;
 thread_local bool search_cutoff = false;
+
+thread_local size_t search_blocks_skipped = 0;
\ No newline at end of file
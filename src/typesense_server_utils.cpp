@@ -92,6 +92,7 @@ void init_cmdline_options(cmdline::parser & options, int argc, char **argv) {
     options.add<uint32_t>("num-documents-parallel-load", '\0', "Number of documents per collection that are indexed in parallel during start up.", false, 1000);
 
     options.add<uint32_t>("thread-pool-size", '\0', "Number of threads used for handling concurrent requests.", false, 4);
+    options.add<uint32_t>("multi-search-concurrency", '\0', "Maximum number of searches of a multi search request that are run in parallel.", false, 4);
 
     options.add<std::string>("log-dir", '\0', "Path to the log directory.", false, "");
 
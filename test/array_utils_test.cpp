@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "array_utils.h"
 #include "logger.h"
+#include <algorithm>
+#include <random>
 
 TEST(SortedArrayTest, AndScalar) {
     const size_t size1 = 9;
@@ -172,4 +174,72 @@ TEST(SortedArrayTest, FilterArray) {
     delete[] arr2;
     delete[] arr1;
     delete[] results;
-}
\ No newline at end of file
+}
+
+TEST(SortedArrayTest, AndKernelsMatchMergeIntersection) {
+    std::mt19937 gen(42);
+
+    // similar sizes exercise the vectorized kernel, skewed sizes exercise galloping
+    std::vector<std::pair<size_t, size_t>> sizes = {{1, 1}, {3, 7}, {17, 33}, {1000, 1200}, {5000, 4000},
+                                                    {10, 20000}, {20000, 10}, {64, 64}};
+
+    for(const auto& size_pair: sizes) {
+        std::vector<uint32_t> a, b;
+        std::uniform_int_distribution<uint32_t> dist(0, (size_pair.first + size_pair.second) * 2);
+
+        for(size_t i = 0; i < size_pair.first; i++) {
+            a.push_back(dist(gen));
+        }
+
+        for(size_t i = 0; i < size_pair.second; i++) {
+            b.push_back(dist(gen));
+        }
+
+        std::sort(a.begin(), a.end());
+        a.erase(std::unique(a.begin(), a.end()), a.end());
+        std::sort(b.begin(), b.end());
+        b.erase(std::unique(b.begin(), b.end()), b.end());
+
+        std::vector<uint32_t> expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+        std::vector<uint32_t> out(std::min(a.size(), b.size()));
+
+        size_t out_len = ArrayUtils::and_vector(&a[0], a.size(), &b[0], b.size(), &out[0]);
+        ASSERT_EQ(expected, std::vector<uint32_t>(out.begin(), out.begin() + out_len));
+
+        out_len = ArrayUtils::and_merge(&a[0], a.size(), &b[0], b.size(), &out[0]);
+        ASSERT_EQ(expected, std::vector<uint32_t>(out.begin(), out.begin() + out_len));
+
+        out_len = ArrayUtils::and_galloping(&a[0], a.size(), &b[0], b.size(), &out[0]);
+        ASSERT_EQ(expected, std::vector<uint32_t>(out.begin(), out.begin() + out_len));
+
+        uint32_t* results = nullptr;
+        out_len = ArrayUtils::and_scalar(&a[0], a.size(), &b[0], b.size(), &results);
+        ASSERT_EQ(expected, std::vector<uint32_t>(results, results + out_len));
+        delete [] results;
+
+        std::vector<uint32_t> expected_excluded;
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_excluded));
+
+        results = nullptr;
+        out_len = ArrayUtils::exclude_scalar(&a[0], a.size(), &b[0], b.size(), &results);
+        ASSERT_EQ(expected_excluded, std::vector<uint32_t>(results, results + out_len));
+        delete [] results;
+    }
+}
+
+TEST(SortedArrayTest, GallopLowerBound) {
+    std::vector<uint32_t> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+
+    ASSERT_EQ(0, ArrayUtils::gallop_lower_bound(&arr[0], 0, arr.size(), 0));
+    ASSERT_EQ(0, ArrayUtils::gallop_lower_bound(&arr[0], 0, arr.size(), 1));
+    ASSERT_EQ(1, ArrayUtils::gallop_lower_bound(&arr[0], 0, arr.size(), 2));
+    ASSERT_EQ(6, ArrayUtils::gallop_lower_bound(&arr[0], 2, arr.size(), 13));
+    ASSERT_EQ(9, ArrayUtils::gallop_lower_bound(&arr[0], 0, arr.size(), 19));
+    ASSERT_EQ(10, ArrayUtils::gallop_lower_bound(&arr[0], 0, arr.size(), 20));
+
+    // search never goes behind `from`
+    ASSERT_EQ(4, ArrayUtils::gallop_lower_bound(&arr[0], 4, arr.size(), 2));
+    ASSERT_EQ(10, ArrayUtils::gallop_lower_bound(&arr[0], 10, arr.size(), 2));
+}
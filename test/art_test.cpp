@@ -6,6 +6,8 @@
 #include <gtest/gtest.h>
 #include <art.h>
 #include <chrono>
+#include <map>
+#include <random>
 #include <posting.h>
 
 #define words_file_path std::string(std::string(ROOT_DIR)+"/build/test_resources/words.txt").c_str()
@@ -587,22 +589,22 @@ TEST(ArtTest, test_art_fuzzy_search_single_leaf) {
     EXPECT_EQ(1, posting_t::first_id(l->values));
 
     std::vector<art_leaf*> leaves;
-    art_fuzzy_search(&t, (const unsigned char *) implement_key, strlen(implement_key) + 1, 0, 0, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) implement_key, strlen(implement_key) + 1, 0, 0, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     const char* implement_key_typo1 = "implment";
     const char* implement_key_typo2 = "implwnent";
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) implement_key_typo1, strlen(implement_key_typo1) + 1, 0, 0, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) implement_key_typo1, strlen(implement_key_typo1) + 1, 0, 0, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(0, leaves.size());
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) implement_key_typo1, strlen(implement_key_typo1) + 1, 0, 1, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) implement_key_typo1, strlen(implement_key_typo1) + 1, 0, 1, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) implement_key_typo2, strlen(implement_key_typo2) + 1, 0, 2, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) implement_key_typo2, strlen(implement_key_typo2) + 1, 0, 2, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     res = art_tree_destroy(&t);
@@ -622,11 +624,11 @@ TEST(ArtTest, test_art_fuzzy_search_single_leaf_prefix) {
     EXPECT_EQ(1, posting_t::first_id(l->values));
 
     std::vector<art_leaf*> leaves;
-    art_fuzzy_search(&t, (const unsigned char *) "aplication", strlen(key)-1, 0, 1, 10, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "aplication", strlen(key)-1, 0, 1, 10, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "aplication", strlen(key)-1, 0, 2, 10, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "aplication", strlen(key)-1, 0, 2, 10, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     res = art_tree_destroy(&t);
@@ -644,11 +646,11 @@ TEST(ArtTest, test_art_fuzzy_search_single_leaf_non_prefix) {
 
     std::string term = "spz";
     std::vector<art_leaf*> leaves;
-    art_fuzzy_search(&t, (const unsigned char *)(term.c_str()), term.size()+1, 0, 1, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *)(term.c_str()), term.size()+1, 0, 1, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(0, leaves.size());
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *)(term.c_str()), term.size(), 0, 1, 10, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *)(term.c_str()), term.size(), 0, 1, 10, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     res = art_tree_destroy(&t);
@@ -672,7 +674,7 @@ TEST(ArtTest, test_art_fuzzy_search_prefix_token_ordering) {
     }
 
     std::vector<art_leaf*> leaves;
-    art_fuzzy_search(&t, (const unsigned char *) "e", 1, 0, 0, 3, MAX_SCORE, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "e", 1, 0, 0, 3, MAX_SCORE, true, nullptr, leaves);
 
     std::string first_key(reinterpret_cast<char*>(leaves[0]->key), leaves[0]->key_len - 1);
     ASSERT_EQ("e", first_key);
@@ -684,13 +686,92 @@ TEST(ArtTest, test_art_fuzzy_search_prefix_token_ordering) {
     ASSERT_EQ("elephant", third_key);
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "enter", 5, 1, 1, 3, MAX_SCORE, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "enter", 5, 1, 1, 3, MAX_SCORE, true, nullptr, leaves);
     ASSERT_TRUE(leaves.empty());
 
     res = art_tree_destroy(&t);
     ASSERT_TRUE(res == 0);
 }
 
+TEST(ArtTest, test_art_topk_prefix_matches_full_scan) {
+    art_tree t;
+    int res = art_tree_init(&t);
+    ASSERT_TRUE(res == 0);
+
+    std::mt19937 rng(42);
+    std::map<std::string, std::pair<int64_t, std::set<uint32_t>>> token_docs;
+
+    for(uint32_t id = 0; id < 30000; id++) {
+        std::string token;
+        size_t len = 1 + rng() % 6;
+        for(size_t j = 0; j < len; j++) {
+            token += "abcde"[rng() % 5];
+        }
+
+        int64_t score = rng() % 100000;
+        art_document doc(id, score, {0});
+        art_insert(&t, (unsigned char*) token.c_str(), token.size() + 1, &doc);
+
+        auto& docs = token_docs[token];
+        docs.first = docs.second.empty() ? score : std::max(docs.first, score);
+        docs.second.insert(id);
+    }
+
+    // deleted tokens leave stale aggregates behind, which must still not affect the results
+    for(auto it = token_docs.begin(); it != token_docs.end(); ) {
+        if(rng() % 4 == 0) {
+            void* values = art_delete(&t, (unsigned char*) it->first.c_str(), it->first.size() + 1);
+            posting_t::destroy_list(values);
+            it = token_docs.erase(it);
+        } else {
+            it++;
+        }
+    }
+
+    const size_t max_words = 10;
+
+    for(const std::string prefix: {"a", "b", "e", "ab", "cde"}) {
+        for(token_ordering token_order: {MAX_SCORE, FREQUENCY}) {
+            // equally ranked tokens are ordered on the key, so the expected tokens are exact
+            std::vector<std::pair<int64_t, std::string>> expected_values;
+            for(const auto& kv: token_docs) {
+                if(kv.first.rfind(prefix, 0) == 0 && kv.first != prefix) {
+                    int64_t value = token_order == MAX_SCORE ? kv.second.first : kv.second.second.size();
+                    expected_values.emplace_back(-value, kv.first);
+                }
+            }
+
+            std::sort(expected_values.begin(), expected_values.end());
+            expected_values.resize(std::min(expected_values.size(), max_words));
+
+            std::vector<art_leaf*> leaves;
+            art_fuzzy_search(&t, (const unsigned char *) prefix.c_str(), prefix.size(), 0, 0, max_words + 1,
+                             token_order, true, nullptr, leaves);
+
+            // the exact match is always placed first
+            size_t start = 0;
+            if(token_docs.count(prefix) != 0) {
+                std::string first_key(reinterpret_cast<char*>(leaves[0]->key), leaves[0]->key_len - 1);
+                ASSERT_EQ(prefix, first_key);
+                start = 1;
+            }
+
+            std::vector<std::pair<int64_t, std::string>> values;
+            for(size_t i = start; i < std::min(leaves.size(), start + max_words); i++) {
+                int64_t value = token_order == MAX_SCORE ? leaves[i]->max_score :
+                                posting_t::num_ids(leaves[i]->values);
+                values.emplace_back(-value, std::string(reinterpret_cast<char*>(leaves[i]->key),
+                                                        leaves[i]->key_len - 1));
+            }
+
+            ASSERT_EQ(expected_values, values) << prefix << ", " << token_order;
+        }
+    }
+
+    res = art_tree_destroy(&t);
+    ASSERT_TRUE(res == 0);
+}
+
 TEST(ArtTest, test_art_fuzzy_search) {
     art_tree t;
     int res = art_tree_init(&t);
@@ -714,7 +795,7 @@ TEST(ArtTest, test_art_fuzzy_search) {
     leaves.clear();
     auto begin = std::chrono::high_resolution_clock::now();
 
-    art_fuzzy_search(&t, (const unsigned char *) "pltinum", strlen("pltinum"), 0, 1, 10, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "pltinum", strlen("pltinum"), 0, 1, 10, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(2, leaves.size());
     ASSERT_STREQ("platinumsmith", (const char *)leaves.at(0)->key);
     ASSERT_STREQ("platinum", (const char *)leaves.at(1)->key);
@@ -722,49 +803,49 @@ TEST(ArtTest, test_art_fuzzy_search) {
     leaves.clear();
 
     // extra char
-    art_fuzzy_search(&t, (const unsigned char *) "higghliving", strlen("higghliving") + 1, 0, 1, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "higghliving", strlen("higghliving") + 1, 0, 1, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
     ASSERT_STREQ("highliving", (const char *)leaves.at(0)->key);
 
     // transpose
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "zymosthneic", strlen("zymosthneic") + 1, 0, 1, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "zymosthneic", strlen("zymosthneic") + 1, 0, 1, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
     ASSERT_STREQ("zymosthenic", (const char *)leaves.at(0)->key);
 
     // transpose + missing -- temporarily ignored because too slow for the value!
 
     /*leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "dacrcyystlgia", strlen("dacrcyystlgia") + 1, 0, 2, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "dacrcyystlgia", strlen("dacrcyystlgia") + 1, 0, 2, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
     ASSERT_STREQ("dacrycystalgia", (const char *)leaves.at(0)->key);
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "dacrcyystlgia", strlen("dacrcyystlgia") + 1, 1, 2, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "dacrcyystlgia", strlen("dacrcyystlgia") + 1, 1, 2, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
     ASSERT_STREQ("dacrycystalgia", (const char *)leaves.at(0)->key);*/
 
     // missing char
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "gaberlunze", strlen("gaberlunze") + 1, 0, 1, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "gaberlunze", strlen("gaberlunze") + 1, 0, 1, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
     ASSERT_STREQ("gaberlunzie", (const char *)leaves.at(0)->key);
 
     // substituted char
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "eacemiferous", strlen("eacemiferous") + 1, 0, 1, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "eacemiferous", strlen("eacemiferous") + 1, 0, 1, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
     ASSERT_STREQ("racemiferous", (const char *)leaves.at(0)->key);
 
     // missing char + extra char
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "Sarbruckken", strlen("Sarbruckken") + 1, 0, 2, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "Sarbruckken", strlen("Sarbruckken") + 1, 0, 2, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
     ASSERT_STREQ("Saarbrucken", (const char *)leaves.at(0)->key);
 
     // multiple matching results
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "hown", strlen("hown") + 1, 0, 1, 10, FREQUENCY, false, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "hown", strlen("hown") + 1, 0, 1, 10, FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(10, leaves.size());
 
     std::set<std::string> expected_words = {"town", "sown", "shown", "own", "mown", "lown", "howl", "howk", "howe", "how"};
@@ -777,23 +858,23 @@ TEST(ArtTest, test_art_fuzzy_search) {
 
     // fuzzy prefix search
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "lionhear", strlen("lionhear"), 0, 0, 10, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "lionhear", strlen("lionhear"), 0, 0, 10, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(3, leaves.size());
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "lineage", strlen("lineage"), 0, 0, 10, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "lineage", strlen("lineage"), 0, 0, 10, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(2, leaves.size());
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "liq", strlen("liq"), 0, 0, 50, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "liq", strlen("liq"), 0, 0, 50, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(39, leaves.size());
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "antitraditiana", strlen("antitraditiana"), 0, 1, 10, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "antitraditiana", strlen("antitraditiana"), 0, 1, 10, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     leaves.clear();
-    art_fuzzy_search(&t, (const unsigned char *) "antisocao", strlen("antisocao"), 0, 2, 10, FREQUENCY, true, nullptr, 0, leaves);
+    art_fuzzy_search(&t, (const unsigned char *) "antisocao", strlen("antisocao"), 0, 2, 10, FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(7, leaves.size());
 
     long long int timeMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -824,7 +905,7 @@ TEST(ArtTest, test_art_fuzzy_search_unicode_chars) {
         EXPECT_EQ(1, posting_t::first_id(l->values));
 
         std::vector<art_leaf*> leaves;
-        art_fuzzy_search(&t, (unsigned char *)key, strlen(key), 0, 0, 10, FREQUENCY, true, nullptr, 0, leaves);
+        art_fuzzy_search(&t, (unsigned char *)key, strlen(key), 0, 0, 10, FREQUENCY, true, nullptr, leaves);
         ASSERT_EQ(1, leaves.size());
     }
 
@@ -832,6 +913,123 @@ TEST(ArtTest, test_art_fuzzy_search_unicode_chars) {
     ASSERT_TRUE(res == 0);
 }
 
+TEST(ArtTest, test_art_fuzzy_nodes_bit_parallel_matches_dp) {
+    art_tree t;
+    int res = art_tree_init(&t);
+    ASSERT_TRUE(res == 0);
+
+    int len;
+    char buf[512];
+    FILE *f = fopen(words_file_path, "r");
+
+    std::vector<std::string> words;
+    uintptr_t line = 1;
+    while (fgets(buf, sizeof buf, f)) {
+        len = strlen(buf);
+        buf[len-1] = '\0';
+        art_document doc = get_document((uint32_t) line);
+        ASSERT_TRUE(NULL == art_insert(&t, (unsigned char*)buf, len, &doc));
+        words.emplace_back(buf);
+        line++;
+    }
+
+    fclose(f);
+
+    // typos of every kind, including transpositions and a term that is too long for the bit vectors
+    std::vector<std::string> terms = {"pltinum", "platnium", "rasberies", "ilustrations", "a", "ab", "ba", "xq",
+                                      std::string(70, 'a'), std::string(64, 'e')};
+
+    for(size_t i = 0; i < words.size(); i += words.size() / 40 + 1) {
+        const std::string& word = words[i];
+        terms.push_back(word);
+        terms.push_back(word.substr(1));
+        terms.push_back(word + "s");
+        if(word.size() > 3) {
+            std::string swapped = word;
+            std::swap(swapped[1], swapped[2]);
+            terms.push_back(swapped);
+            terms.push_back(word.substr(0, word.size() - 2));
+        }
+    }
+
+    for(const auto& term: terms) {
+        for(int min_cost = 0; min_cost <= 2; min_cost++) {
+            for(int max_cost = min_cost; max_cost <= 2; max_cost++) {
+                for(bool prefix: {false, true}) {
+                    std::vector<const art_node*> dp_nodes, bit_nodes;
+                    art_fuzzy_nodes(&t, (const unsigned char*) term.c_str(), term.size(), min_cost, max_cost,
+                                    prefix, false, dp_nodes);
+                    art_fuzzy_nodes(&t, (const unsigned char*) term.c_str(), term.size(), min_cost, max_cost,
+                                    prefix, true, bit_nodes);
+                    ASSERT_EQ(dp_nodes, bit_nodes) << term << ", cost: " << min_cost << "-" << max_cost
+                                                   << ", prefix: " << prefix;
+                }
+            }
+        }
+    }
+
+    res = art_tree_destroy(&t);
+    ASSERT_TRUE(res == 0);
+}
+
+TEST(ArtTest, DISABLED_test_art_fuzzy_nodes_benchmark) {
+    art_tree t;
+    int res = art_tree_init(&t);
+    ASSERT_TRUE(res == 0);
+
+    int len;
+    char buf[512];
+    FILE *f = fopen(words_file_path, "r");
+
+    std::vector<std::string> words;
+    uintptr_t line = 1;
+    while (fgets(buf, sizeof buf, f)) {
+        len = strlen(buf);
+        buf[len-1] = '\0';
+        art_document doc = get_document((uint32_t) line);
+        ASSERT_TRUE(NULL == art_insert(&t, (unsigned char*)buf, len, &doc));
+        words.emplace_back(buf);
+        line++;
+    }
+
+    fclose(f);
+
+    // long tokens with two typos explore the largest part of the tree
+    std::vector<std::string> terms;
+    for(size_t i = 0; i < words.size() && terms.size() < 1000; i += 37) {
+        if(words[i].size() >= 8) {
+            std::string term = words[i];
+            std::swap(term[2], term[3]);
+            term[term.size() - 2] = 'x';
+            terms.push_back(term);
+        }
+    }
+
+    for(bool bit_parallel: {false, true}) {
+        for(bool prefix: {false, true}) {
+            size_t num_nodes = 0;
+            auto begin = std::chrono::high_resolution_clock::now();
+
+            for(const auto& term: terms) {
+                std::vector<const art_node*> nodes;
+                art_fuzzy_nodes(&t, (const unsigned char*) term.c_str(), term.size(), 0, 2, prefix, bit_parallel,
+                                nodes);
+                num_nodes += nodes.size();
+            }
+
+            long long int timeMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::high_resolution_clock::now() - begin).count();
+
+            LOG(INFO) << (bit_parallel ? "Bit-parallel" : "DP rows") << ", prefix: " << prefix
+                      << ", terms: " << terms.size() << ", nodes: " << num_nodes
+                      << ", time taken: " << timeMillis << "ms";
+        }
+    }
+
+    res = art_tree_destroy(&t);
+    ASSERT_TRUE(res == 0);
+}
+
 TEST(ArtTest, test_art_search_sku_like_tokens) {
     art_tree t;
     int res = art_tree_init(&t);
@@ -864,7 +1062,7 @@ TEST(ArtTest, test_art_search_sku_like_tokens) {
     for (const auto &key : keys) {
         std::vector<art_leaf *> leaves;
         art_fuzzy_search(&t, (const unsigned char*)key.c_str(), key.size(), 0, 0, 10,
-                         FREQUENCY, true, nullptr, 0, leaves);
+                         FREQUENCY, true, nullptr, leaves);
         ASSERT_EQ(1, leaves.size());
         ASSERT_STREQ(key.c_str(), (const char *) leaves.at(0)->key);
 
@@ -872,7 +1070,7 @@ TEST(ArtTest, test_art_search_sku_like_tokens) {
 
         // non prefix
         art_fuzzy_search(&t, (const unsigned char*)key.c_str(), key.size()+1, 0, 0, 10,
-                         FREQUENCY, false, nullptr, 0, leaves);
+                         FREQUENCY, false, nullptr, leaves);
         ASSERT_EQ(1, leaves.size());
         ASSERT_STREQ(key.c_str(), (const char *) leaves.at(0)->key);
     }
@@ -923,7 +1121,7 @@ TEST(ArtTest, test_art_search_ill_like_tokens) {
 
         std::vector<art_leaf *> leaves;
         art_fuzzy_search(&t, (const unsigned char*)key.c_str(), key.size(), 0, 0, 10,
-                         FREQUENCY, true, nullptr, 0, leaves);
+                         FREQUENCY, true, nullptr, leaves);
 
         if(key_to_count.count(key) != 0) {
             ASSERT_EQ(key_to_count[key], leaves.size());
@@ -936,7 +1134,7 @@ TEST(ArtTest, test_art_search_ill_like_tokens) {
 
         // non prefix
         art_fuzzy_search(&t, (const unsigned char*)key.c_str(), key.size()+1, 0, 0, 10,
-                         FREQUENCY, false, nullptr, 0, leaves);
+                         FREQUENCY, false, nullptr, leaves);
         ASSERT_EQ(1, leaves.size());
         ASSERT_STREQ(key.c_str(), (const char *) leaves.at(0)->key);
     }
@@ -969,7 +1167,7 @@ TEST(ArtTest, test_art_search_ill_like_tokens2) {
 
         std::vector<art_leaf *> leaves;
         art_fuzzy_search(&t, (const unsigned char*)key.c_str(), key.size(), 0, 0, 10,
-                         FREQUENCY, true, nullptr, 0, leaves);
+                         FREQUENCY, true, nullptr, leaves);
 
         if(key == "illustration") {
             ASSERT_EQ(2, leaves.size());
@@ -982,7 +1180,7 @@ TEST(ArtTest, test_art_search_ill_like_tokens2) {
 
         // non prefix
         art_fuzzy_search(&t, (const unsigned char*)key.c_str(), key.size() + 1, 0, 0, 10,
-                         FREQUENCY, false, nullptr, 0, leaves);
+                         FREQUENCY, false, nullptr, leaves);
         ASSERT_EQ(1, leaves.size());
         ASSERT_STREQ(key.c_str(), (const char *) leaves.at(0)->key);
     }
@@ -1005,12 +1203,12 @@ TEST(ArtTest, test_art_search_roche_chews) {
     std::string term = "chews";
     std::vector<art_leaf *> leaves;
     art_fuzzy_search(&t, (const unsigned char*)term.c_str(), term.size(), 0, 2, 10,
-                     FREQUENCY, true, nullptr, 0, leaves);
+                     FREQUENCY, true, nullptr, leaves);
 
     ASSERT_EQ(0, leaves.size());
 
     art_fuzzy_search(&t, (const unsigned char*)keys[0].c_str(), keys[0].size() + 1, 0, 0, 10,
-                     FREQUENCY, false, nullptr, 0, leaves);
+                     FREQUENCY, false, nullptr, leaves);
 
     ASSERT_EQ(1, leaves.size());
 
@@ -1037,14 +1235,14 @@ TEST(ArtTest, test_art_search_raspberry) {
 
     std::string q_raspberries = "raspberries";
     art_fuzzy_search(&t, (const unsigned char*)q_raspberries.c_str(), q_raspberries.size(), 0, 2, 10,
-                     FREQUENCY, true, nullptr, 0, leaves);
+                     FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(2, leaves.size());
 
     leaves.clear();
 
     std::string q_raspberry = "raspberry";
     art_fuzzy_search(&t, (const unsigned char*)q_raspberry.c_str(), q_raspberry.size(), 0, 2, 10,
-                     FREQUENCY, true, nullptr, 0, leaves);
+                     FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(2, leaves.size());
 
     res = art_tree_destroy(&t);
@@ -1070,13 +1268,13 @@ TEST(ArtTest, test_art_search_highliving) {
 
     std::string query = "higghliving";
     art_fuzzy_search(&t, (const unsigned char*)query.c_str(), query.size() + 1, 0, 1, 10,
-                     FREQUENCY, false, nullptr, 0, leaves);
+                     FREQUENCY, false, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     leaves.clear();
 
     art_fuzzy_search(&t, (const unsigned char*)query.c_str(), query.size(), 0, 2, 10,
-                     FREQUENCY, true, nullptr, 0, leaves);
+                     FREQUENCY, true, nullptr, leaves);
     ASSERT_EQ(1, leaves.size());
 
     res = art_tree_destroy(&t);
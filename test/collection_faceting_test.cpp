@@ -903,3 +903,295 @@ TEST_F(CollectionFacetingTest, FacetArrayValuesShouldBeNormalized) {
 
     collectionManager.drop_collection("coll1");
 }
+
+TEST_F(CollectionFacetingTest, SampledFacetCounts) {
+    std::vector<field> fields = {field("color", field_types::STRING, true),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    for(size_t i = 0; i < 1000; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["color"] = (i % 4 == 0) ? "red" : "blue";
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    std::map<std::string, std::string> req_params = {
+        {"collection", "coll1"},
+        {"q", "*"},
+        {"facet_by", "color"},
+        {"facet_sample_percent", "10"},
+        {"facet_sample_threshold", "0"},
+    };
+
+    nlohmann::json embedded_params;
+    std::string json_res;
+
+    auto search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+    ASSERT_TRUE(search_op.ok());
+
+    nlohmann::json res_obj = nlohmann::json::parse(json_res);
+    ASSERT_EQ(1000, res_obj["found"].get<size_t>());
+    ASSERT_EQ(1, res_obj["facet_counts"].size());
+    ASSERT_TRUE(res_obj["facet_counts"][0]["sampled"].get<bool>());
+    ASSERT_EQ(100, res_obj["facet_counts"][0]["sample_size"].get<size_t>());
+    ASSERT_EQ(2, res_obj["facet_counts"][0]["counts"].size());
+
+    // counts are extrapolated to the whole result set
+    ASSERT_EQ("blue", res_obj["facet_counts"][0]["counts"][0]["value"].get<std::string>());
+    ASSERT_NEAR(750, res_obj["facet_counts"][0]["counts"][0]["count"].get<size_t>(), 100);
+    ASSERT_EQ("red", res_obj["facet_counts"][0]["counts"][1]["value"].get<std::string>());
+    ASSERT_NEAR(250, res_obj["facet_counts"][0]["counts"][1]["count"].get<size_t>(), 100);
+
+    // result set smaller than the threshold is counted exactly
+    req_params["facet_sample_threshold"] = "5000";
+    search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+    ASSERT_TRUE(search_op.ok());
+
+    res_obj = nlohmann::json::parse(json_res);
+    ASSERT_EQ(0, res_obj["facet_counts"][0].count("sampled"));
+    ASSERT_EQ(750, res_obj["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(250, res_obj["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+
+    req_params["facet_sample_percent"] = "0";
+    search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+    ASSERT_FALSE(search_op.ok());
+    ASSERT_EQ(400, search_op.code());
+    ASSERT_EQ("Value of `facet_sample_percent` must be between 1 and 100.", search_op.error());
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionFacetingTest, RangeFacets) {
+    std::vector<field> fields = {field("price", field_types::INT32, true),
+                                 field("sizes", field_types::INT32_ARRAY, true),
+                                 field("rating", field_types::FLOAT, true),
+                                 field("brand", field_types::STRING, true),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    for(size_t i = 0; i < 1000; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["price"] = i % 100;
+        doc["sizes"] = {i % 10, 10 + (i % 10)};
+        doc["rating"] = (i % 50) / 10.0;
+        doc["brand"] = "brand" + std::to_string(i % 3);
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    // large result set: counts come from the numerical index
+    auto results = coll1->search("*", {}, "", {"price(0..10, 10..50, 50..)", "brand"}, {}, {0},
+                                 10, 1, FREQUENCY, {true}, 10).get();
+
+    ASSERT_EQ(1000, results["found"].get<size_t>());
+    ASSERT_EQ(2, results["facet_counts"].size());
+    ASSERT_EQ("price", results["facet_counts"][0]["field_name"].get<std::string>());
+    ASSERT_EQ(3, results["facet_counts"][0]["counts"].size());
+    ASSERT_EQ("0..10", results["facet_counts"][0]["counts"][0]["value"].get<std::string>());
+    ASSERT_EQ(100, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ("10..50", results["facet_counts"][0]["counts"][1]["value"].get<std::string>());
+    ASSERT_EQ(400, results["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+    ASSERT_EQ("50..", results["facet_counts"][0]["counts"][2]["value"].get<std::string>());
+    ASSERT_EQ(500, results["facet_counts"][0]["counts"][2]["count"].get<size_t>());
+
+    // other facets are unaffected
+    ASSERT_EQ("brand", results["facet_counts"][1]["field_name"].get<std::string>());
+    ASSERT_EQ(3, results["facet_counts"][1]["counts"].size());
+
+    // small result set: counts come from the values of each result
+    results = coll1->search("*", {}, "points:<20", {"price(..5, 5..15, 90..)"}, {}, {0},
+                            10, 1, FREQUENCY, {true}, 10).get();
+
+    ASSERT_EQ(20, results["found"].get<size_t>());
+    ASSERT_EQ(5, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(10, results["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+    ASSERT_EQ(0, results["facet_counts"][0]["counts"][2]["count"].get<size_t>());
+
+    // a document is counted once in every range that one of its values falls in
+    results = coll1->search("*", {}, "points:<20", {"sizes(0..5, 5..15)"}, {}, {0},
+                            10, 1, FREQUENCY, {true}, 10).get();
+
+    ASSERT_EQ(10, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(20, results["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+
+    results = coll1->search("*", {}, "", {"rating(0..1.5, 1.5..4.5)"}, {}, {0},
+                            10, 1, FREQUENCY, {true}, 10).get();
+
+    ASSERT_EQ(300, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(600, results["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+
+    // invalid ranges
+    auto res_op = coll1->search("*", {}, "", {"price(0..10"}, {}, {0}, 10, 1, FREQUENCY, {true}, 10);
+    ASSERT_FALSE(res_op.ok());
+    ASSERT_EQ("Range facet `price(0..10` must be in the `field(start..end, ...)` format.", res_op.error());
+
+    res_op = coll1->search("*", {}, "", {"price(10..0)"}, {}, {0}, 10, 1, FREQUENCY, {true}, 10);
+    ASSERT_FALSE(res_op.ok());
+    ASSERT_EQ("Range `10..0` of facet `price` is empty.", res_op.error());
+
+    res_op = coll1->search("*", {}, "", {"price(1.5..10)"}, {}, {0}, 10, 1, FREQUENCY, {true}, 10);
+    ASSERT_FALSE(res_op.ok());
+    ASSERT_EQ("Range `1.5..10` of facet `price` has an invalid start value.", res_op.error());
+
+    res_op = coll1->search("*", {}, "", {"brand(0..10)"}, {}, {0}, 10, 1, FREQUENCY, {true}, 10);
+    ASSERT_FALSE(res_op.ok());
+    ASSERT_EQ("Range facet field `brand` must be an integer or a float field.", res_op.error());
+
+    res_op = coll1->search("*", {}, "", {"points(0..10)"}, {}, {0}, 10, 1, FREQUENCY, {true}, 10);
+    ASSERT_FALSE(res_op.ok());
+    ASSERT_EQ(404, res_op.code());
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionFacetingTest, CachedFacetCountsOfWildcardQueries) {
+    std::vector<field> fields = {field("color", field_types::STRING, true),
+                                 field("size", field_types::INT32, true),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    for(size_t i = 0; i < 100; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["color"] = (i % 2 == 0) ? "red" : "blue";
+        doc["size"] = i % 10;
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    std::vector<sort_by> sort_fields = {sort_by("points", "DESC")};
+
+    auto results = coll1->search("*", {}, "size:<5 && points:>=10", {"color", "size(0..2,2..)"}, sort_fields, {0},
+                                 10, 1, FREQUENCY, {true}, 10).get();
+
+    ASSERT_EQ(45, results["found"].get<size_t>());
+    ASSERT_EQ(2, results["facet_counts"][0]["counts"].size());
+    ASSERT_EQ(27, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(18, results["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+    ASSERT_EQ(18, results["facet_counts"][1]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(27, results["facet_counts"][1]["counts"][1]["count"].get<size_t>());
+
+    // same counts for another page, sort order and order of filter clauses
+    sort_fields = {sort_by("points", "ASC")};
+    results = coll1->search("*", {}, "points:>=10 && size:<5", {"color", "size(0..2,2..)"}, sort_fields, {0},
+                            10, 2, FREQUENCY, {true}, 10).get();
+
+    ASSERT_EQ(45, results["found"].get<size_t>());
+    ASSERT_EQ(10, results["hits"].size());
+    ASSERT_EQ("red", results["facet_counts"][0]["counts"][0]["value"].get<std::string>());
+    ASSERT_EQ(27, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(18, results["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+    ASSERT_EQ(18, results["facet_counts"][1]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(27, results["facet_counts"][1]["counts"][1]["count"].get<size_t>());
+
+    // writes invalidate the counts
+    nlohmann::json doc;
+    doc["id"] = "100";
+    doc["color"] = "blue";
+    doc["size"] = 0;
+    doc["points"] = 100;
+    ASSERT_TRUE(coll1->add(doc.dump()).ok());
+
+    results = coll1->search("*", {}, "size:<5 && points:>=10", {"color", "size(0..2,2..)"}, sort_fields, {0},
+                            10, 1, FREQUENCY, {true}, 10).get();
+
+    ASSERT_EQ(46, results["found"].get<size_t>());
+    ASSERT_EQ(27, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(19, results["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+    ASSERT_EQ(19, results["facet_counts"][1]["counts"][0]["count"].get<size_t>());
+
+    ASSERT_TRUE(coll1->remove("0").ok());
+    ASSERT_TRUE(coll1->remove("10").ok());
+
+    results = coll1->search("*", {}, "size:<5 && points:>=10", {"color", "size(0..2,2..)"}, sort_fields, {0},
+                            10, 1, FREQUENCY, {true}, 10).get();
+
+    ASSERT_EQ(45, results["found"].get<size_t>());
+    ASSERT_EQ(26, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(18, results["facet_counts"][1]["counts"][0]["count"].get<size_t>());
+
+    // facet query is not served from the cache
+    results = coll1->search("*", {}, "size:<5 && points:>=10", {"color"}, sort_fields, {0},
+                            10, 1, FREQUENCY, {true}, 10, {}, {}, 10, "color: bl").get();
+
+    ASSERT_EQ(1, results["facet_counts"][0]["counts"].size());
+    ASSERT_EQ("<mark>bl</mark>ue", results["facet_counts"][0]["counts"][0]["highlighted"].get<std::string>());
+    ASSERT_EQ(19, results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionFacetingTest, CountOnlySearchMatchesRegularSearch) {
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("color", field_types::STRING, true),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    for(size_t i = 0; i < 100; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = (i % 3 == 0) ? "the quick brown fox" : "the lazy dog";
+        doc["color"] = (i % 2 == 0) ? "red" : "blue";
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    std::vector<std::pair<std::string, std::string>> queries = {
+        {"fox", ""}, {"the", ""}, {"quick fox", ""}, {"lazy", "points:>50"}, {"*", "points:<30"}, {"brwn", ""}
+    };
+
+    for(const auto& query: queries) {
+        std::vector<std::vector<std::string>> facet_fields = {{}, {"color"}};
+        for(const auto& facets: facet_fields) {
+            auto results = coll1->search(query.first, {"title"}, query.second, facets, {}, {2},
+                                         10, 1, FREQUENCY, {false}, 1).get();
+            auto count_results = coll1->search(query.first, {"title"}, query.second, facets, {}, {2},
+                                               0, 1, FREQUENCY, {false}, 1).get();
+
+            ASSERT_EQ(results["found"].get<size_t>(), count_results["found"].get<size_t>());
+            ASSERT_EQ(0, count_results["hits"].size());
+            ASSERT_EQ(results["facet_counts"], count_results["facet_counts"]);
+        }
+    }
+
+    auto count_results = coll1->search("fox", {"title"}, "", {"color"}, {}, {0}, 0, 1, FREQUENCY, {false}, 1).get();
+    ASSERT_EQ(34, count_results["found"].get<size_t>());
+    ASSERT_EQ(17, count_results["facet_counts"][0]["counts"][0]["count"].get<size_t>());
+    ASSERT_EQ(17, count_results["facet_counts"][0]["counts"][1]["count"].get<size_t>());
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionFacetingTest, CountOnlySearchOfPhraseAndToken) {
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    for(size_t i = 0; i < 100; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = (i % 4 == 0) ? "red shoe by nike" : "nike shoe in red";
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    // the phrase must still be applied when a single token is counted
+    auto results = coll1->search("\"red shoe\" nike", {"title"}, "", {}, {}, {0},
+                                 10, 1, FREQUENCY, {false}, 1).get();
+    auto count_results = coll1->search("\"red shoe\" nike", {"title"}, "", {}, {}, {0},
+                                       0, 1, FREQUENCY, {false}, 1).get();
+
+    ASSERT_EQ(25, results["found"].get<size_t>());
+    ASSERT_EQ(25, count_results["found"].get<size_t>());
+    ASSERT_EQ(0, count_results["hits"].size());
+
+    collectionManager.drop_collection("coll1");
+}
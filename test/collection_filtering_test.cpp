@@ -2399,3 +2399,265 @@ TEST_F(CollectionFilteringTest, FilteringAfterUpsertOnArrayWithSymbolsToIndex) {
 
     collectionManager.drop_collection("coll1");
 }
+
+TEST_F(CollectionFilteringTest, FilterOnDenseValues) {
+    // values shared by most documents are stored as bitmaps
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("in_stock", field_types::BOOL, false),
+                                 field("points", field_types::INT32, false),
+                                 field("country", field_types::STRING, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    const size_t num_docs = 20000;
+    std::vector<std::string> json_lines;
+
+    for(size_t i = 0; i < num_docs; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = "Title " + std::to_string(i);
+        doc["in_stock"] = (i % 10 != 0);
+        doc["points"] = int32_t(i % 3);
+        doc["country"] = (i % 5 == 0) ? "UK" : "US";
+        json_lines.push_back(doc.dump());
+    }
+
+    nlohmann::json document;
+    nlohmann::json import_response = coll1->add_many(json_lines, document);
+    ASSERT_TRUE(import_response["success"].get<bool>());
+
+    size_t expected_found = 0;
+    for(size_t i = 0; i < num_docs; i++) {
+        if(i % 10 != 0 && i % 3 != 0 && i % 5 != 0) {
+            expected_found++;
+        }
+    }
+
+    auto results = coll1->search("*", {}, "in_stock:true && points:>0 && country:US", {}, {}, {0}).get();
+    ASSERT_EQ(expected_found, results["found"].get<size_t>());
+
+    results = coll1->search("*", {}, "in_stock:true && points:>0 && country:!=UK", {}, {}, {0}).get();
+    ASSERT_EQ(expected_found, results["found"].get<size_t>());
+
+    results = coll1->search("*", {}, "in_stock:!=false && points:[1, 2] && country:US", {}, {}, {0}).get();
+    ASSERT_EQ(expected_found, results["found"].get<size_t>());
+
+    // removing documents must keep the bitmaps in sync
+    for(size_t i = 0; i < num_docs; i += 2) {
+        ASSERT_TRUE(coll1->remove(std::to_string(i)).ok());
+    }
+
+    expected_found = 0;
+    for(size_t i = 1; i < num_docs; i += 2) {
+        if(i % 10 != 0 && i % 3 != 0 && i % 5 != 0) {
+            expected_found++;
+        }
+    }
+
+    results = coll1->search("*", {}, "in_stock:true && points:>0 && country:US", {}, {}, {0}).get();
+    ASSERT_EQ(expected_found, results["found"].get<size_t>());
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionFilteringTest, RareClauseCombinedWithBroadClauses) {
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("brand", field_types::STRING, false),
+                                 field("in_stock", field_types::BOOL, false),
+                                 field("price", field_types::FLOAT, false),
+                                 field("tags", field_types::INT32_ARRAY, false),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    std::vector<std::string> json_lines;
+
+    for(size_t i = 0; i < 1000; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = "Title " + std::to_string(i);
+        doc["brand"] = (i % 100 == 7) ? "Acme" : "Generic";
+        doc["in_stock"] = (i % 2 == 1);
+        doc["price"] = float(i) / 10;
+        doc["tags"] = std::vector<int32_t>{int32_t(i % 3), 10};
+        doc["points"] = int32_t(i);
+        json_lines.push_back(doc.dump());
+    }
+
+    nlohmann::json document;
+    nlohmann::json import_response = coll1->add_many(json_lines, document);
+    ASSERT_TRUE(import_response["success"].get<bool>());
+
+    // Acme documents: 7, 107, 207, ..., 907 (all in stock)
+    auto results = coll1->search("*", {}, "brand:=Acme && in_stock:true && price:<50.0",
+                                 {}, {sort_by("points", "ASC")}, {0}).get();
+    ASSERT_EQ(5, results["found"].get<size_t>());
+    ASSERT_EQ("7", results["hits"][0]["document"]["id"].get<std::string>());
+    ASSERT_EQ("407", results["hits"][4]["document"]["id"].get<std::string>());
+
+    results = coll1->search("*", {}, "brand:=Acme && price:[10.0..30.0, 90.0..95.0] && tags:=1",
+                            {}, {sort_by("points", "ASC")}, {0}).get();
+
+    // 107 % 3 == 2, 207 % 3 == 0, 907 % 3 == 1
+    ASSERT_EQ(1, results["found"].get<size_t>());
+    ASSERT_EQ("907", results["hits"][0]["document"]["id"].get<std::string>());
+
+    results = coll1->search("title", {"title"}, "brand:!=Generic && in_stock:false", {}, {}, {0}).get();
+    ASSERT_EQ(0, results["found"].get<size_t>());
+
+    results = coll1->search("title", {"title"}, "brand:!=Generic && id:[7, 8, 107]", {}, {}, {0}).get();
+    ASSERT_EQ(2, results["found"].get<size_t>());
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionFilteringTest, FilterClausesOrderedBySelectivity) {
+    std::vector<field> fields = {field("brand", field_types::STRING, false),
+                                 field("in_stock", field_types::BOOL, false),
+                                 field("price", field_types::FLOAT, false),
+                                 field("tags", field_types::INT32_ARRAY, false),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    std::vector<std::string> json_lines;
+
+    for(size_t i = 0; i < 1000; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["brand"] = (i % 100 == 7) ? "Acme" : "Generic";
+        doc["in_stock"] = (i % 2 == 1);
+        doc["price"] = float(i) / 10;
+        doc["tags"] = std::vector<int32_t>{int32_t(i % 3)};
+        doc["points"] = int32_t(i);
+        json_lines.push_back(doc.dump());
+    }
+
+    nlohmann::json document;
+    nlohmann::json import_response = coll1->add_many(json_lines, document);
+    ASSERT_TRUE(import_response["success"].get<bool>());
+
+    std::map<std::string, std::string> req_params = {
+        {"collection", "coll1"},
+        {"q", "*"},
+        {"filter_by", "in_stock:true && tags:=1 && brand:=Acme && price:<50.0"},
+        {"sort_by", "points:asc"},
+        {"explain_filter", "true"},
+    };
+
+    nlohmann::json embedded_params;
+    std::string json_res;
+    ASSERT_TRUE(collectionManager.do_search(req_params, embedded_params, json_res).ok());
+
+    nlohmann::json results = nlohmann::json::parse(json_res);
+    ASSERT_EQ(2, results["found"].get<size_t>());
+    ASSERT_EQ("7", results["hits"][0]["document"]["id"].get<std::string>());
+    ASSERT_EQ("307", results["hits"][1]["document"]["id"].get<std::string>());
+
+    // most selective clause is scanned first, and the single valued fields are verified per document
+    const auto& filter_plan = results["filter_plan"];
+    ASSERT_EQ(4, filter_plan.size());
+
+    ASSERT_EQ("brand", filter_plan[0]["field"].get<std::string>());
+    ASSERT_EQ(10, filter_plan[0]["estimated_ids"].get<size_t>());
+    ASSERT_EQ("scan", filter_plan[0]["strategy"].get<std::string>());
+
+    ASSERT_EQ("tags", filter_plan[1]["field"].get<std::string>());
+    ASSERT_EQ(333, filter_plan[1]["estimated_ids"].get<size_t>());
+    ASSERT_EQ("materialize", filter_plan[1]["strategy"].get<std::string>());
+
+    ASSERT_EQ("in_stock", filter_plan[2]["field"].get<std::string>());
+    ASSERT_EQ(500, filter_plan[2]["estimated_ids"].get<size_t>());
+    ASSERT_EQ("verify", filter_plan[2]["strategy"].get<std::string>());
+
+    ASSERT_EQ("price", filter_plan[3]["field"].get<std::string>());
+    ASSERT_EQ(500, filter_plan[3]["estimated_ids"].get<size_t>());
+    ASSERT_EQ("verify", filter_plan[3]["strategy"].get<std::string>());
+
+    // plan is reported only when asked for
+    results = coll1->search("*", {}, "in_stock:true && tags:=1 && brand:=Acme && price:<50.0",
+                            {}, {sort_by("points", "ASC")}, {0}).get();
+    ASSERT_EQ(2, results["found"].get<size_t>());
+    ASSERT_EQ(0, results.count("filter_plan"));
+
+    req_params["filter_by"] = "";
+    ASSERT_TRUE(collectionManager.do_search(req_params, embedded_params, json_res).ok());
+    results = nlohmann::json::parse(json_res);
+    ASSERT_EQ(0, results.count("filter_plan"));
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionFilteringTest, FilterResultCacheInvalidatedOnWrites) {
+    std::vector<field> fields = {field("tenant", field_types::STRING, false),
+                                 field("visible", field_types::BOOL, false, true),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    for(size_t i = 0; i < 10; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["tenant"] = (i < 5) ? "alpha" : "beta";
+        doc["visible"] = true;
+        doc["points"] = int32_t(i);
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    auto get_stats = [&]() {
+        filter_cache_stats_t stats;
+        coll1->get_filter_cache_stats(stats);
+        return stats;
+    };
+
+    auto results = coll1->search("*", {}, "tenant:=alpha && visible:true", {}, {}, {0}).get();
+    ASSERT_EQ(5, results["found"].get<size_t>());
+    ASSERT_EQ(0, get_stats().hits);
+
+    // the broader clause is only checked against the ids of the narrower one, so it's neither cached nor a miss
+    ASSERT_EQ(1, get_stats().misses);
+
+    // order of the clauses and of the values don't matter
+    results = coll1->search("*", {}, "visible:true && tenant:=alpha", {}, {}, {0}).get();
+    ASSERT_EQ(5, results["found"].get<size_t>());
+
+    results = coll1->search("*", {}, "tenant:=[beta, alpha]", {}, {}, {0}).get();
+    ASSERT_EQ(10, results["found"].get<size_t>());
+    results = coll1->search("*", {}, "tenant:=[alpha, beta]", {}, {}, {0}).get();
+    ASSERT_EQ(10, results["found"].get<size_t>());
+
+    size_t hits = get_stats().hits;
+    ASSERT_LE(2, hits);
+    ASSERT_LT(0, get_stats().num_entries);
+    ASSERT_LT(0, get_stats().memory_used_bytes);
+
+    // writes to the field invalidate the cached results
+    nlohmann::json doc;
+    doc["id"] = "10";
+    doc["tenant"] = "alpha";
+    doc["points"] = 10;
+    ASSERT_TRUE(coll1->add(doc.dump()).ok());
+
+    results = coll1->search("*", {}, "tenant:=alpha", {}, {}, {0}).get();
+    ASSERT_EQ(6, results["found"].get<size_t>());
+
+    // document without `visible` is included in the negated clause
+    results = coll1->search("*", {}, "visible:!=false", {}, {}, {0}).get();
+    ASSERT_EQ(11, results["found"].get<size_t>());
+
+    coll1->remove("0");
+
+    results = coll1->search("*", {}, "tenant:=alpha", {}, {}, {0}).get();
+    ASSERT_EQ(5, results["found"].get<size_t>());
+
+    results = coll1->search("*", {}, "visible:!=false", {}, {}, {0}).get();
+    ASSERT_EQ(10, results["found"].get<size_t>());
+
+    // unchanged fields are still served from the cache
+    hits = get_stats().hits;
+    results = coll1->search("*", {}, "visible:!=false", {}, {}, {0}).get();
+    ASSERT_EQ(10, results["found"].get<size_t>());
+    ASSERT_EQ(hits + 1, get_stats().hits);
+
+    collectionManager.drop_collection("coll1");
+}
@@ -534,3 +534,51 @@ TEST_F(CollectionGroupingTest, UseHighestValueInGroupForOrdering) {
     ASSERT_STREQ("249", res["grouped_hits"][0]["group_key"][0].get<std::string>().c_str());
     ASSERT_EQ(2, res["grouped_hits"][0]["hits"].size());
 }
+
+TEST_F(CollectionGroupingTest, GroupIdsFollowWrites) {
+    auto search_by_size = [&]() {
+        return coll_group->search("*", {}, "", {}, {}, {0}, 50, 1, FREQUENCY,
+                                  {false}, Index::DROP_TOKENS_THRESHOLD,
+                                  spp::sparse_hash_set<std::string>(),
+                                  spp::sparse_hash_set<std::string>(), 10, "", 30, 5,
+                                  "", 10,
+                                  {}, {}, {"size"}, 10).get();
+    };
+
+    auto res = search_by_size();
+    ASSERT_EQ(3, res["found"].get<size_t>());
+
+    // group ids of updated documents are recomputed
+    ASSERT_TRUE(coll_group->add(R"({"id": "5", "size": 13})", UPDATE).ok());
+
+    res = search_by_size();
+    ASSERT_EQ(4, res["found"].get<size_t>());
+
+    size_t num_size_13_groups = 0;
+    for(const auto& group: res["grouped_hits"]) {
+        if(group["group_key"][0].get<size_t>() == 13) {
+            num_size_13_groups++;
+            ASSERT_EQ(1, group["hits"].size());
+            ASSERT_EQ("5", group["hits"][0]["document"]["id"].get<std::string>());
+        }
+    }
+
+    ASSERT_EQ(1, num_size_13_groups);
+
+    // and removed documents no longer form groups
+    ASSERT_TRUE(coll_group->remove("5").ok());
+    ASSERT_TRUE(coll_group->remove("1").ok());
+
+    res = search_by_size();
+    ASSERT_EQ(2, res["found"].get<size_t>());
+
+    // new documents are placed in existing groups
+    ASSERT_TRUE(coll_group->add(R"({"id": "100", "title": "Omega Shirt", "brand": "Omega", "size": 12,
+                                    "colors": ["blue"], "rating": 4.9})").ok());
+
+    res = search_by_size();
+    ASSERT_EQ(2, res["found"].get<size_t>());
+    ASSERT_EQ(12, res["grouped_hits"][0]["group_key"][0].get<size_t>());
+    ASSERT_EQ(4, res["grouped_hits"][0]["hits"].size());
+    ASSERT_EQ("100", res["grouped_hits"][0]["hits"][0]["document"]["id"].get<std::string>());
+}
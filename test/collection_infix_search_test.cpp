@@ -355,9 +355,8 @@ TEST_F(CollectionInfixSearchTest, InfixDeleteAndUpdate) {
 
     coll1->remove("0");
 
-    for(size_t i = 0; i < coll1->_get_index()->_get_infix_index().at("title").size(); i++) {
-        ASSERT_EQ(0, coll1->_get_index()->_get_infix_index().at("title").at(i)->size());
-    }
+    ASSERT_EQ(0, coll1->_get_index()->_get_infix_index().at("title")->size());
+    ASSERT_EQ(0, coll1->_get_index()->_get_infix_index().at("title")->num_grams());
 
     results = coll1->search("100037",
                         {"title"}, "", {}, {}, {0}, 3, 1, FREQUENCY, {true}, 5,
@@ -406,16 +405,13 @@ TEST_F(CollectionInfixSearchTest, InfixDeleteAndUpdate) {
     ASSERT_EQ(0, results["found"].get<size_t>());
     ASSERT_EQ(0, results["hits"].size());
 
-    std::string key = "yhd3342d78912";
-    auto strhash = StringUtils::hash_wy(key.c_str(), key.size());
-    const auto& infix_sets = coll1->_get_index()->_get_infix_index().at("title");
-    ASSERT_EQ(1, infix_sets[strhash % 4]->size());
+    const auto field_infix_index = coll1->_get_index()->_get_infix_index().at("title");
+    ASSERT_EQ(1, field_infix_index->size());
 
-    for(size_t i = 0; i < infix_sets.size(); i++) {
-        if(i != strhash % 4) {
-            ASSERT_EQ(0, infix_sets[i]->size());
-        }
-    }
+    std::vector<uint32_t> candidate_ids;
+    ASSERT_TRUE(field_infix_index->get_candidates("342d78", candidate_ids));
+    ASSERT_EQ(1, candidate_ids.size());
+    ASSERT_EQ("yhd3342d78912", field_infix_index->get_token(candidate_ids[0]));
 
     collectionManager.drop_collection("coll1");
 }
@@ -452,3 +448,53 @@ TEST_F(CollectionInfixSearchTest, MultiFielInfixSearch) {
 
     collectionManager.drop_collection("coll1");
 }
+
+TEST_F(CollectionInfixSearchTest, InfixTokenSharedByDocuments) {
+    std::vector<field> fields = {field("title", field_types::STRING, false, false, true, "", -1, 1),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    for(size_t i = 0; i < 3; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = (i == 2) ? "XZ100037" : "GH100037IN8900X";
+        doc["points"] = 100;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    auto results = coll1->search("0003",
+                                 {"title"}, "", {}, {}, {0}, 3, 1, FREQUENCY, {true}, 5,
+                                 spp::sparse_hash_set<std::string>(),
+                                 spp::sparse_hash_set<std::string>(), 10, "", 30, 4, "title", 20, {}, {}, {}, 0,
+                                 "<mark>", "</mark>", {}, 1000, true, false, true, "", false, 6000 * 1000, 4, 7, true,
+                                 4, {always}).get();
+
+    ASSERT_EQ(3, results["found"].get<size_t>());
+
+    // the token must stay searchable while another document still contains it
+    coll1->remove("0");
+
+    results = coll1->search("0003",
+                            {"title"}, "", {}, {}, {0}, 3, 1, FREQUENCY, {true}, 5,
+                            spp::sparse_hash_set<std::string>(),
+                            spp::sparse_hash_set<std::string>(), 10, "", 30, 4, "title", 20, {}, {}, {}, 0,
+                            "<mark>", "</mark>", {}, 1000, true, false, true, "", false, 6000 * 1000, 4, 7, true,
+                            4, {always}).get();
+
+    ASSERT_EQ(2, results["found"].get<size_t>());
+    ASSERT_EQ(2, coll1->_get_index()->_get_infix_index().at("title")->size());
+
+    // queries shorter than a trigram look at every token
+    results = coll1->search("xz",
+                            {"title"}, "", {}, {}, {0}, 3, 1, FREQUENCY, {true}, 5,
+                            spp::sparse_hash_set<std::string>(),
+                            spp::sparse_hash_set<std::string>(), 10, "", 30, 4, "title", 20, {}, {}, {}, 0,
+                            "<mark>", "</mark>", {}, 1000, true, false, true, "", false, 6000 * 1000, 4, 7, true,
+                            4, {always}).get();
+
+    ASSERT_EQ(1, results["found"].get<size_t>());
+    ASSERT_EQ("2", results["hits"][0]["document"]["id"].get<std::string>());
+
+    collectionManager.drop_collection("coll1");
+}
@@ -1778,3 +1778,141 @@ TEST_F(CollectionSortingTest, IntegerFloatAndBoolShouldDefaultSortTrue) {
 
     collectionManager.drop_collection("coll1");
 }
+
+TEST_F(CollectionSortingTest, SkipBlocksThatCannotEnterTopster) {
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("points", field_types::INT32, true),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields).get();
+
+    for(size_t i = 0; i < 1000; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = "Title " + std::to_string(i);
+        doc["points"] = 1000 - i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    sort_fields = { sort_by("points", "DESC") };
+
+    auto results = coll1->search("title", {"title"}, "", {"points"}, sort_fields, {0}, 10).get();
+
+    auto exhaustive_results = coll1->search("title", {"title"}, "", {"points"}, sort_fields, {0}, 10,
+                                            1, FREQUENCY, {true},
+                                            10, spp::sparse_hash_set<std::string>(),
+                                            spp::sparse_hash_set<std::string>(), 10, "", 30, 4, "", 20, {}, {}, {}, 0,
+                                            "<mark>", "</mark>", {}, UINT32_MAX, true, false, true, "", true).get();
+
+    // pruned candidates are still counted and faceted
+    ASSERT_EQ(1000, results["found"].get<size_t>());
+    ASSERT_EQ(exhaustive_results["facet_counts"], results["facet_counts"]);
+    ASSERT_LT(0, results["blocks_skipped"].get<size_t>());
+    ASSERT_EQ(0, exhaustive_results["blocks_skipped"].get<size_t>());
+
+    ASSERT_EQ(10, results["hits"].size());
+    for(size_t i = 0; i < results["hits"].size(); i++) {
+        ASSERT_EQ(std::to_string(i), results["hits"][i]["document"]["id"].get<std::string>());
+        ASSERT_EQ(exhaustive_results["hits"][i]["document"]["id"], results["hits"][i]["document"]["id"]);
+    }
+
+    collectionManager.drop_collection("coll1");
+}
+
+TEST_F(CollectionSortingTest, WildcardSortOnPresortedField) {
+    nlohmann::json schema = R"({
+        "name": "coll1",
+        "fields": [
+          {"name": "category", "type": "string", "facet": true},
+          {"name": "popularity", "type": "int32", "optional": true, "sort_index": "presorted"},
+          {"name": "points", "type": "int32"}
+        ],
+        "default_sorting_field": "points"
+    })"_json;
+
+    Collection* coll1 = collectionManager.create_collection(schema).get();
+    ASSERT_EQ("presorted", coll1->get_summary_json()["fields"][1]["sort_index"].get<std::string>());
+
+    // same documents, scored without the presorted index
+    schema["name"] = "coll2";
+    schema["fields"][1].erase("sort_index");
+    Collection* coll2 = collectionManager.create_collection(schema).get();
+    ASSERT_EQ(0, coll2->get_summary_json()["fields"][1].count("sort_index"));
+
+    for(size_t i = 0; i < 500; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["category"] = (i % 3 == 0) ? "shoes" : "shirts";
+        doc["points"] = int32_t(i);
+
+        if(i % 10 != 0) {
+            doc["popularity"] = int32_t((i * 7) % 37);
+        }
+
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+        ASSERT_TRUE(coll2->add(doc.dump()).ok());
+    }
+
+    auto assert_same_hits = [&](const std::string& filter, const std::string& order, size_t per_page, size_t page) {
+        std::vector<sort_by> sort_fields = { sort_by("popularity", order) };
+        auto results = coll1->search("*", {}, filter, {"category"}, sort_fields, {0}, per_page, page).get();
+        auto expected_results = coll2->search("*", {}, filter, {"category"}, sort_fields, {0}, per_page, page).get();
+
+        ASSERT_EQ(expected_results["found"], results["found"]);
+        ASSERT_EQ(expected_results["facet_counts"], results["facet_counts"]);
+        ASSERT_EQ(expected_results["hits"].size(), results["hits"].size());
+
+        for(size_t i = 0; i < results["hits"].size(); i++) {
+            ASSERT_EQ(expected_results["hits"][i]["document"]["id"], results["hits"][i]["document"]["id"]);
+        }
+    };
+
+    assert_same_hits("", "DESC", 10, 1);
+    assert_same_hits("", "ASC", 10, 1);
+    assert_same_hits("", "DESC", 15, 3);
+    assert_same_hits("category:shirts", "DESC", 10, 2);
+    assert_same_hits("category:shoes", "ASC", 20, 1);
+
+    // documents without a value have to be ordered last
+    assert_same_hits("", "DESC", 100, 5);
+
+    // updates and deletions are reflected in the presorted index
+    for(size_t i = 0; i < 500; i += 7) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["popularity"] = 100 + int32_t(i % 5);
+        ASSERT_TRUE(coll1->add(doc.dump(), UPDATE).ok());
+        ASSERT_TRUE(coll2->add(doc.dump(), UPDATE).ok());
+    }
+
+    for(size_t i = 1; i < 500; i += 11) {
+        coll1->remove(std::to_string(i));
+        coll2->remove(std::to_string(i));
+    }
+
+    assert_same_hits("", "DESC", 10, 1);
+    assert_same_hits("", "ASC", 10, 1);
+    assert_same_hits("category:shirts", "DESC", 25, 2);
+
+    collectionManager.drop_collection("coll1");
+    collectionManager.drop_collection("coll2");
+
+    // only single valued numerical fields can be presorted
+    schema = R"({
+        "name": "coll3",
+        "fields": [
+          {"name": "category", "type": "string", "sort_index": "presorted"}
+        ]
+    })"_json;
+
+    auto create_op = collectionManager.create_collection(schema);
+    ASSERT_FALSE(create_op.ok());
+    ASSERT_EQ("The `sort_index` property of the field `category` is only supported for single valued numerical "
+              "fields.", create_op.error());
+
+    schema["fields"][0]["type"] = "int32";
+    schema["fields"][0]["sort_index"] = "btree";
+
+    create_op = collectionManager.create_collection(schema);
+    ASSERT_FALSE(create_op.ok());
+    ASSERT_EQ("The `sort_index` property of the field `category` should be `presorted`.", create_op.error());
+}
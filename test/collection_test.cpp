@@ -404,6 +404,72 @@ TEST_F(CollectionTest, QueryWithTypo) {
     }
 }
 
+TEST_F(CollectionTest, FuzzyCandidateCacheInvalidatedOnNewTokens) {
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    std::vector<std::string> titles = {"the rocket launch", "a rocket engine", "launch window"};
+    for(size_t i = 0; i < titles.size(); i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = titles[i];
+        doc["points"] = int32_t(i);
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    auto get_stats = [&]() {
+        fuzzy_cache_stats_t stats;
+        coll1->get_fuzzy_cache_stats(stats);
+        return stats;
+    };
+
+    auto results = coll1->search("rockt", {"title"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {false}).get();
+    ASSERT_EQ(2, results["found"].get<size_t>());
+    ASSERT_EQ(0, get_stats().hits);
+    ASSERT_LT(0, get_stats().num_entries);
+    ASSERT_LT(0, get_stats().memory_used_bytes);
+
+    size_t misses = get_stats().misses;
+    results = coll1->search("rockt", {"title"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {false}).get();
+    ASSERT_EQ(2, results["found"].get<size_t>());
+    ASSERT_LT(0, get_stats().hits);
+    ASSERT_EQ(misses, get_stats().misses);
+
+    // documents of known tokens are found without invalidating the candidates
+    nlohmann::json doc;
+    doc["id"] = "3";
+    doc["title"] = "rocket";
+    doc["points"] = 3;
+    ASSERT_TRUE(coll1->add(doc.dump()).ok());
+
+    results = coll1->search("rockt", {"title"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {false}).get();
+    ASSERT_EQ(3, results["found"].get<size_t>());
+    ASSERT_EQ(misses, get_stats().misses);
+
+    // a new token invalidates the candidates of the field
+    doc["id"] = "4";
+    doc["title"] = "rock";
+    doc["points"] = 4;
+    ASSERT_TRUE(coll1->add(doc.dump()).ok());
+
+    results = coll1->search("rockt", {"title"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {false}).get();
+    ASSERT_EQ(4, results["found"].get<size_t>());
+    ASSERT_LT(misses, get_stats().misses);
+
+    // so does the removal of the last document of a token
+    coll1->remove("4");
+    results = coll1->search("rockt", {"title"}, "", {}, {}, {1}, 10, 1, FREQUENCY, {false}).get();
+    ASSERT_EQ(3, results["found"].get<size_t>());
+
+    nlohmann::json stats = collectionManager.get_fuzzy_cache_stats();
+    ASSERT_LT(0, stats["hits"].get<size_t>());
+    ASSERT_LT(0, stats["hit_rate"].get<double>());
+
+    collectionManager.drop_collection("coll1");
+}
+
 TEST_F(CollectionTest, TypoTokenRankedByScoreAndFrequency) {
     std::vector<std::string> facets;
     nlohmann::json results = collection->search("loox", query_fields, "", facets, sort_fields, {1}, 2, 1, MAX_SCORE, {false}).get();
@@ -542,6 +608,134 @@ TEST_F(CollectionTest, Pagination) {
     }
 }
 
+TEST_F(CollectionTest, PaginationWithSearchAfter) {
+    std::map<std::string, std::string> req_params = {
+        {"collection", "collection"},
+        {"q", "the"},
+        {"query_by", "title"},
+        {"sort_by", "_text_match:desc,points:desc"},
+        {"num_typos", "0"},
+        {"prefix", "false"},
+        {"per_page", "3"},
+    };
+
+    nlohmann::json embedded_params;
+    std::string json_res;
+
+    // same hits as paging by page number
+    std::vector<std::string> ids;
+
+    for(size_t page = 1; page <= 3; page++) {
+        req_params["page"] = std::to_string(page);
+        ASSERT_TRUE(collectionManager.do_search(req_params, embedded_params, json_res).ok());
+        nlohmann::json res_obj = nlohmann::json::parse(json_res);
+        for(const auto& hit: res_obj["hits"]) {
+            ids.push_back(hit["document"]["id"].get<std::string>());
+        }
+    }
+
+    ASSERT_EQ(7, ids.size());
+    req_params.erase("page");
+
+    std::vector<std::string> paged_ids;
+
+    for(size_t page = 1; page <= 3; page++) {
+        auto search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+        ASSERT_TRUE(search_op.ok());
+
+        nlohmann::json res_obj = nlohmann::json::parse(json_res);
+        ASSERT_EQ(7, res_obj["found"].get<size_t>());
+
+        for(const auto& hit: res_obj["hits"]) {
+            paged_ids.push_back(hit["document"]["id"].get<std::string>());
+        }
+
+        if(page < 3) {
+            ASSERT_EQ(3, res_obj["hits"].size());
+            req_params["search_after"] = res_obj["search_after"].get<std::string>();
+        } else {
+            // last page is not full
+            ASSERT_EQ(1, res_obj["hits"].size());
+            ASSERT_EQ(0, res_obj.count("search_after"));
+        }
+    }
+
+    ASSERT_EQ(ids, paged_ids);
+
+    // wildcard query, ordered by a sort field
+    req_params["q"] = "*";
+    req_params["sort_by"] = "points:asc";
+    req_params["per_page"] = "4";
+    req_params.erase("search_after");
+
+    std::vector<std::string> all_ids;
+    auto results = collection->search("*", {}, "", {}, {sort_by("points", "ASC")}, {0}, 100, 1, FREQUENCY,
+                                      {false}).get();
+    for(const auto& hit: results["hits"]) {
+        all_ids.push_back(hit["document"]["id"].get<std::string>());
+    }
+
+    paged_ids.clear();
+
+    while(true) {
+        auto search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+        ASSERT_TRUE(search_op.ok());
+
+        nlohmann::json res_obj = nlohmann::json::parse(json_res);
+        for(const auto& hit: res_obj["hits"]) {
+            paged_ids.push_back(hit["document"]["id"].get<std::string>());
+        }
+
+        if(res_obj.count("search_after") == 0) {
+            break;
+        }
+
+        req_params["search_after"] = res_obj["search_after"].get<std::string>();
+    }
+
+    ASSERT_EQ(all_ids, paged_ids);
+
+    // a pinned hit is shown on the first page only
+    req_params["pinned_hits"] = all_ids.back() + ":1";
+    req_params.erase("search_after");
+    paged_ids.clear();
+
+    while(true) {
+        auto search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+        ASSERT_TRUE(search_op.ok());
+
+        nlohmann::json res_obj = nlohmann::json::parse(json_res);
+        for(const auto& hit: res_obj["hits"]) {
+            paged_ids.push_back(hit["document"]["id"].get<std::string>());
+        }
+
+        if(res_obj.count("search_after") == 0) {
+            break;
+        }
+
+        req_params["search_after"] = res_obj["search_after"].get<std::string>();
+    }
+
+    std::vector<std::string> pinned_ids = {all_ids.back()};
+    pinned_ids.insert(pinned_ids.end(), all_ids.begin(), all_ids.end() - 1);
+    ASSERT_EQ(pinned_ids, paged_ids);
+
+    req_params.erase("pinned_hits");
+
+    // bad cursor
+    req_params["search_after"] = "foo";
+    auto search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+    ASSERT_FALSE(search_op.ok());
+    ASSERT_EQ(400, search_op.code());
+    ASSERT_EQ("Value of `search_after` is not a valid cursor.", search_op.error());
+
+    req_params["search_after"] = StringUtils::base64_encode("10,20,30,4");
+    req_params["page"] = "2";
+    search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+    ASSERT_FALSE(search_op.ok());
+    ASSERT_EQ("Parameter `search_after` cannot be used with `page`.", search_op.error());
+}
+
 TEST_F(CollectionTest, WildcardQuery) {
     nlohmann::json results = collection->search("*", query_fields, "points:>0", {}, sort_fields, {0}, 3, 1, FREQUENCY,
                                                 {false}).get();
@@ -666,6 +860,62 @@ TEST_F(CollectionTest, PrefixSearching) {
     ASSERT_EQ("16", results["hits"].at(0)["document"]["id"]);
 }
 
+TEST_F(CollectionTest, TypeaheadSessionAcrossKeystrokes) {
+    std::map<std::string, std::string> req_params = {
+        {"collection", "collection"},
+        {"query_by", "title"},
+        {"filter_by", "points:>5"},
+        {"num_typos", "1"},
+    };
+
+    nlohmann::json embedded_params;
+    std::string json_res;
+
+    auto get_ids = [&](const std::string& q, const std::string& session) {
+        req_params["q"] = q;
+        if(session.empty()) {
+            req_params.erase("typeahead_session");
+        } else {
+            req_params["typeahead_session"] = session;
+        }
+
+        std::vector<std::string> ids;
+        auto search_op = collectionManager.do_search(req_params, embedded_params, json_res);
+        if(!search_op.ok()) {
+            return ids;
+        }
+
+        nlohmann::json res_obj = nlohmann::json::parse(json_res);
+        ids.push_back(std::to_string(res_obj["found"].get<size_t>()));
+        for(const auto& hit: res_obj["hits"]) {
+            ids.push_back(hit["document"]["id"].get<std::string>());
+        }
+        return ids;
+    };
+
+    // keystrokes of a session must find the same hits as independent queries
+    for(const std::string& q: {"r", "ro", "roc", "rock", "rocke", "rocket", "rocket l", "rocket la"}) {
+        auto expected_ids = get_ids(q, "");
+        ASSERT_FALSE(expected_ids.empty());
+        ASSERT_EQ(expected_ids, get_ids(q, "session1"));
+    }
+
+    // backspace
+    ASSERT_EQ(get_ids("roc", ""), get_ids("roc", "session1"));
+
+    // changing the filter between keystrokes
+    req_params["filter_by"] = "points:>15";
+    ASSERT_EQ(get_ids("rocke", ""), get_ids("rocke", "session1"));
+
+    // a write between keystrokes invalidates the session
+    auto prev_ids = get_ids("rock", "session1");
+    ASSERT_TRUE(collection->add(R"({"id": "1000", "title": "Rocketry in the early days", "points": 100})").ok());
+
+    auto ids = get_ids("rocke", "session1");
+    ASSERT_EQ(get_ids("rocke", ""), ids);
+    ASSERT_EQ("1000", ids[1]);
+}
+
 TEST_F(CollectionTest, TypoTokensThreshold) {
     // Query expansion should happen only based on the `typo_tokens_threshold` value
     auto results = collection->search("launch", {"title"}, "", {}, sort_fields, {2}, 10, 1,
@@ -30,6 +30,7 @@ TEST(ConfigTest, LoadCmdLineArguments) {
         "--data-dir=/tmp/data",
         "--api-key=abcd",
         "--listen-port=8080",
+        "--multi-search-concurrency=8",
     };
 
     std::vector<char*> argv = get_argv(args);
@@ -44,6 +45,7 @@ TEST(ConfigTest, LoadCmdLineArguments) {
     ASSERT_EQ(8080, config.get_api_port());
     ASSERT_EQ("/tmp/data", config.get_data_dir());
     ASSERT_EQ(true, config.get_enable_cors());
+    ASSERT_EQ(8, config.get_multi_search_concurrency());
 }
 
 TEST(ConfigTest, LoadEnvVars) {
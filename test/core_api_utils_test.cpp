@@ -220,6 +220,62 @@ TEST_F(CoreAPIUtilsTest, MultiSearchEmbeddedKeys) {
 
 }
 
+TEST_F(CoreAPIUtilsTest, ConcurrentMultiSearchesKeepTheirOrder) {
+    std::vector<field> fields = {field("title", field_types::STRING, false),
+                                 field("points", field_types::INT32, false),};
+
+    Collection* coll1 = collectionManager.create_collection("coll1", 1, fields, "points").get();
+
+    for(size_t i = 0; i < 20; i++) {
+        nlohmann::json doc;
+        doc["id"] = std::to_string(i);
+        doc["title"] = "Title " + std::to_string(i);
+        doc["points"] = i;
+        ASSERT_TRUE(coll1->add(doc.dump()).ok());
+    }
+
+    // every search matches a different document, while two of the searches fail
+    std::vector<std::map<std::string, std::string>> search_req_params;
+    std::vector<nlohmann::json> embedded_params_vec;
+
+    for(size_t i = 0; i < 12; i++) {
+        std::map<std::string, std::string> req_params;
+        req_params["collection"] = (i == 3) ? "coll2" : "coll1";
+        req_params["q"] = "title";
+        req_params["query_by"] = (i == 8) ? "description" : "title";
+        req_params["filter_by"] = "points: " + std::to_string(i);
+
+        search_req_params.push_back(req_params);
+        embedded_params_vec.push_back(nlohmann::json::object());
+    }
+
+    ThreadPool thread_pool(4);
+    std::vector<nlohmann::json> search_results;
+    run_multi_searches(search_req_params, embedded_params_vec, &thread_pool, 4, search_results);
+
+    ASSERT_EQ(12, search_results.size());
+    ASSERT_EQ(12, search_req_params.size());
+
+    for(size_t i = 0; i < search_results.size(); i++) {
+        if(i == 3) {
+            ASSERT_EQ(404, search_results[i]["code"].get<size_t>());
+            ASSERT_EQ("Not found.", search_results[i]["error"].get<std::string>());
+            ASSERT_EQ(1, search_results[i].count("search_time_ms"));
+        } else if(i == 8) {
+            ASSERT_EQ(404, search_results[i]["code"].get<size_t>());
+            ASSERT_EQ("Could not find a field named `description` in the schema.",
+                      search_results[i]["error"].get<std::string>());
+        } else {
+            ASSERT_EQ(0, search_results[i].count("error"));
+            ASSERT_EQ(1, search_results[i]["found"].get<size_t>());
+            ASSERT_EQ(std::to_string(i), search_results[i]["hits"][0]["document"]["id"].get<std::string>());
+        }
+    }
+
+    thread_pool.shutdown();
+    collectionManager.drop_collection("coll1");
+}
+
 TEST_F(CoreAPIUtilsTest, ExtractCollectionsFromRequestBody) {
     std::map<std::string, std::string> req_params;
     std::string body = R"(
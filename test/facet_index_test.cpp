@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include "facet_index.h"
+
+static std::vector<uint64_t> get_hashes(const facet_index_t& facet_index, const uint32_t seq_id) {
+    uint32_t num_values = 0;
+    const uint32_t* ordinals = facet_index.get_ordinals(seq_id, num_values);
+
+    std::vector<uint64_t> hashes;
+    for(size_t i = 0; i < num_values; i++) {
+        hashes.push_back(facet_index.get_hash(ordinals[i]));
+    }
+
+    return hashes;
+}
+
+TEST(FacetIndexTest, UpsertAndErase) {
+    facet_index_t facet_index;
+
+    facet_index.upsert(0, {100, 200}, {"v100", "v200"});
+    facet_index.upsert(5, {200}, {"v200"});
+    facet_index.upsert(2000, {300, 100, 300}, {"v300", "v100", "v300"});
+    facet_index.upsert(7, {}, {});
+
+    ASSERT_EQ(4, facet_index.num_docs());
+    ASSERT_EQ(3, facet_index.num_values());
+    ASSERT_EQ(3, facet_index.ordinal_space());
+
+    ASSERT_EQ(std::vector<uint64_t>({100, 200}), get_hashes(facet_index, 0));
+    ASSERT_EQ(std::vector<uint64_t>({200}), get_hashes(facet_index, 5));
+    ASSERT_EQ(std::vector<uint64_t>({300, 100, 300}), get_hashes(facet_index, 2000));
+
+    // an empty entry is still an entry
+    ASSERT_TRUE(facet_index.contains(7));
+    ASSERT_TRUE(get_hashes(facet_index, 7).empty());
+    ASSERT_FALSE(facet_index.contains(6));
+    ASSERT_FALSE(facet_index.contains(50000));
+
+    // same ordinals are shared across documents
+    uint32_t num_values;
+    ASSERT_EQ(facet_index.get_ordinals(0, num_values)[1], facet_index.get_ordinals(5, num_values)[0]);
+
+    // updating a document keeps the values of its neighbours intact
+    facet_index.upsert(0, {400}, {"v400"});
+    ASSERT_EQ(std::vector<uint64_t>({400}), get_hashes(facet_index, 0));
+    ASSERT_EQ(std::vector<uint64_t>({200}), get_hashes(facet_index, 5));
+    ASSERT_EQ(4, facet_index.num_docs());
+    ASSERT_EQ(4, facet_index.num_values());
+
+    // text of a value lives as long as some document has the value
+    std::string value;
+    ASSERT_TRUE(facet_index.get_value(300, value));
+    ASSERT_EQ("v300", value);
+
+    // ordinal of a value that is gone is reused
+    facet_index.erase(2000);
+    ASSERT_EQ(2, facet_index.num_values());
+    ASSERT_FALSE(facet_index.get_value(300, value));
+    ASSERT_FALSE(facet_index.get_value(100, value));
+    ASSERT_FALSE(facet_index.contains(2000));
+    ASSERT_EQ(nullptr, facet_index.get_ordinals(2000, num_values));
+    ASSERT_EQ(0, num_values);
+
+    facet_index.upsert(10, {500, 600}, {"v500", "v600"});
+    ASSERT_EQ(4, facet_index.ordinal_space());
+    ASSERT_EQ(std::vector<uint64_t>({500, 600}), get_hashes(facet_index, 10));
+    ASSERT_TRUE(facet_index.get_value(600, value));
+    ASSERT_EQ("v600", value);
+
+    // erasing a missing document is a no-op
+    facet_index.erase(11);
+    facet_index.erase(123456);
+    ASSERT_EQ(4, facet_index.num_docs());
+}
+
+TEST(FacetIndexTest, MatchesMapOfHashes) {
+    std::mt19937 gen(137);
+    std::uniform_int_distribution<uint32_t> seq_id_dist(0, 5000);
+    std::uniform_int_distribution<uint32_t> num_values_dist(0, 4);
+    std::uniform_int_distribution<uint64_t> hash_dist(0, 300);
+
+    facet_index_t facet_index;
+    std::map<uint32_t, std::vector<uint64_t>> expected;
+
+    for(size_t round = 0; round < 50000; round++) {
+        const uint32_t seq_id = seq_id_dist(gen);
+
+        if(round % 3 == 0) {
+            facet_index.erase(seq_id);
+            expected.erase(seq_id);
+        } else {
+            std::vector<uint64_t> hashes(num_values_dist(gen));
+            for(auto& hash: hashes) {
+                hash = hash_dist(gen);
+            }
+
+            std::vector<std::string> values;
+            for(auto hash: hashes) {
+                values.push_back(std::to_string(hash));
+            }
+
+            facet_index.upsert(seq_id, hashes, values);
+            expected[seq_id] = hashes;
+        }
+    }
+
+    ASSERT_EQ(expected.size(), facet_index.num_docs());
+
+    std::map<uint64_t, size_t> distinct_hashes;
+    for(const auto& kv: expected) {
+        for(auto hash: kv.second) {
+            distinct_hashes[hash]++;
+        }
+    }
+
+    ASSERT_EQ(distinct_hashes.size(), facet_index.num_values());
+    ASSERT_LE(facet_index.num_values(), facet_index.ordinal_space());
+
+    for(uint32_t seq_id = 0; seq_id <= 5001; seq_id++) {
+        const auto it = expected.find(seq_id);
+        ASSERT_EQ(it != expected.end(), facet_index.contains(seq_id));
+        if(it != expected.end()) {
+            ASSERT_EQ(it->second, get_hashes(facet_index, seq_id));
+        }
+    }
+
+    for(uint64_t hash = 0; hash <= 300; hash++) {
+        std::string value;
+        ASSERT_EQ(distinct_hashes.count(hash) != 0, facet_index.get_value(hash, value));
+        if(distinct_hashes.count(hash) != 0) {
+            ASSERT_EQ(std::to_string(hash), value);
+        }
+    }
+}
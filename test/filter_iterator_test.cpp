@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "filter_iterator.h"
+
+namespace {
+    std::unique_ptr<filter_iterator_t> new_leaf(const std::vector<uint32_t>& ids, bool with_checker,
+                                                size_t& num_materializations, size_t& num_checks) {
+        filter_leaf_iterator_t::checker_t checker;
+        if(with_checker) {
+            checker = [ids, &num_checks](uint32_t id) {
+                num_checks++;
+                return std::binary_search(ids.begin(), ids.end(), id);
+            };
+        }
+
+        return std::make_unique<filter_leaf_iterator_t>(
+            [ids, &num_materializations](id_bitmap_t& result) {
+                num_materializations++;
+                result.add_many(ids.data(), ids.size());
+            },
+            checker,
+            ids.size()
+        );
+    }
+}
+
+TEST(FilterIteratorTest, AndDrivenBySmallestLeaf) {
+    std::vector<uint32_t> rare_ids = {5, 100, 2000, 40000};
+    std::vector<uint32_t> broad_ids, other_broad_ids;
+    for(uint32_t id = 0; id < 50000; id++) {
+        if(id % 2 == 0) {
+            broad_ids.push_back(id);
+        }
+        if(id % 5 == 0) {
+            other_broad_ids.push_back(id);
+        }
+    }
+
+    size_t rare_materializations = 0, rare_checks = 0;
+    size_t broad_materializations = 0, broad_checks = 0;
+    size_t other_materializations = 0, other_checks = 0;
+
+    std::vector<std::unique_ptr<filter_iterator_t>> children;
+    children.push_back(new_leaf(broad_ids, true, broad_materializations, broad_checks));
+    children.push_back(new_leaf(rare_ids, false, rare_materializations, rare_checks));
+    children.push_back(new_leaf(other_broad_ids, false, other_materializations, other_checks));
+
+    filter_and_iterator_t and_it(std::move(children));
+
+    std::vector<uint32_t> ids;
+    and_it.to_vector(ids);
+
+    ASSERT_EQ(std::vector<uint32_t>({100, 2000, 40000}), ids);
+
+    // broad leaf with a checker is never materialized
+    ASSERT_EQ(1, rare_materializations);
+    ASSERT_EQ(0, broad_materializations);
+    ASSERT_EQ(4, broad_checks);
+
+    // a leaf without a checker is materialized to verify the candidates
+    ASSERT_EQ(1, other_materializations);
+}
+
+TEST(FilterIteratorTest, AndSkipToAndReset) {
+    size_t num_materializations = 0, num_checks = 0;
+
+    std::vector<std::unique_ptr<filter_iterator_t>> and_children;
+    and_children.push_back(new_leaf({1, 2, 4, 9, 10, 20, 30}, false, num_materializations, num_checks));
+    and_children.push_back(new_leaf({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}, true,
+                                    num_materializations, num_checks));
+
+    filter_and_iterator_t and_it(std::move(and_children));
+    ASSERT_EQ(7, and_it.estimate());
+
+    ASSERT_TRUE(and_it.valid());
+    ASSERT_EQ(1, and_it.id());
+
+    and_it.skip_to(3);
+    ASSERT_TRUE(and_it.valid());
+    ASSERT_EQ(4, and_it.id());
+
+    std::vector<uint32_t> ids;
+    and_it.to_vector(ids);
+    ASSERT_EQ(std::vector<uint32_t>({4, 9, 10}), ids);
+    ASSERT_FALSE(and_it.valid());
+
+    and_it.reset();
+    ids.clear();
+    and_it.to_vector(ids);
+    ASSERT_EQ(std::vector<uint32_t>({1, 2, 4, 9, 10}), ids);
+    ASSERT_EQ(1, num_materializations);
+
+    // checking IDs does not move the iterator
+    and_it.reset();
+    and_it.skip_to(9);
+    ASSERT_TRUE(and_it.contains(2));
+    ASSERT_FALSE(and_it.contains(3));
+    ASSERT_EQ(9, and_it.id());
+
+    // empty AND matches nothing
+    filter_and_iterator_t empty_it({});
+    ASSERT_FALSE(empty_it.valid());
+    ASSERT_FALSE(empty_it.contains(1));
+}
+
+TEST(FilterIteratorTest, CheckingDoesNotMaterializeUntilCostly) {
+    std::vector<uint32_t> ids;
+    for(uint32_t id = 0; id < 100; id++) {
+        ids.push_back(id * 2);
+    }
+
+    size_t num_materializations = 0, num_checks = 0;
+
+    std::vector<std::unique_ptr<filter_iterator_t>> children;
+    children.push_back(new_leaf(ids, true, num_materializations, num_checks));
+    filter_and_iterator_t and_it(std::move(children));
+
+    // an iterator that is only used for checking is not materialized upfront
+    ASSERT_EQ(0, num_materializations);
+
+    for(uint32_t id = 0; id < 50; id++) {
+        ASSERT_EQ(id % 2 == 0, and_it.contains(id));
+    }
+
+    ASSERT_EQ(0, num_materializations);
+    ASSERT_EQ(50, num_checks);
+
+    // once checks have cost about as much as producing the IDs, the leaf is materialized instead
+    for(uint32_t id = 50; id < 1000; id++) {
+        ASSERT_EQ(id % 2 == 0 && id < 200, and_it.contains(id));
+    }
+
+    ASSERT_EQ(1, num_materializations);
+    ASSERT_EQ(101, num_checks);
+
+    // leaf over known IDs
+    filter_leaf_iterator_t known_it(std::make_shared<const id_bitmap_t>(ids.data(), ids.size()));
+    ASSERT_TRUE(known_it.is_materialized());
+    ASSERT_EQ(100, known_it.estimate());
+    ASSERT_TRUE(known_it.contains(198));
+
+    std::vector<uint32_t> known_ids;
+    known_it.to_vector(known_ids);
+    ASSERT_EQ(ids, known_ids);
+}
+
+TEST(FilterIteratorTest, CostlyChecksFallBackToMaterialization) {
+    std::vector<uint32_t> driver_ids, checked_ids;
+    for(uint32_t id = 0; id < 1000; id++) {
+        driver_ids.push_back(id * 2);
+        checked_ids.push_back(id * 3);
+    }
+
+    size_t num_checks = 0, num_materializations = 0;
+
+    const auto new_checked_leaf = [&](size_t check_cost) {
+        return std::make_unique<filter_leaf_iterator_t>(
+            [&checked_ids, &num_materializations](id_bitmap_t& result) {
+                num_materializations++;
+                result.add_many(checked_ids.data(), checked_ids.size());
+            },
+            [&checked_ids, &num_checks](uint32_t id) {
+                num_checks++;
+                return std::binary_search(checked_ids.begin(), checked_ids.end(), id);
+            },
+            checked_ids.size() + 1,
+            check_cost
+        );
+    };
+
+    // checking every candidate costs about as much as producing the leaf's IDs: check them
+    std::vector<std::unique_ptr<filter_iterator_t>> children;
+    children.push_back(new_leaf(driver_ids, false, num_materializations, num_checks));
+    children.push_back(new_checked_leaf(1));
+    auto checked_leaf = static_cast<filter_leaf_iterator_t*>(children.back().get());
+
+    filter_and_iterator_t and_it(std::move(children));
+    ASSERT_TRUE(checked_leaf->uses_checker());
+
+    std::vector<uint32_t> ids;
+    and_it.to_vector(ids);
+    ASSERT_EQ(334, ids.size());
+    ASSERT_EQ(1, num_materializations);
+    ASSERT_EQ(1000, num_checks);
+
+    // costly checks: the leaf is materialized instead
+    num_checks = 0;
+    num_materializations = 0;
+
+    children.clear();
+    children.push_back(new_leaf(driver_ids, false, num_materializations, num_checks));
+    children.push_back(new_checked_leaf(4));
+    checked_leaf = static_cast<filter_leaf_iterator_t*>(children.back().get());
+
+    filter_and_iterator_t costly_and_it(std::move(children));
+    ASSERT_FALSE(checked_leaf->uses_checker());
+
+    ids.clear();
+    costly_and_it.to_vector(ids);
+    ASSERT_EQ(334, ids.size());
+    ASSERT_EQ(2, num_materializations);
+    ASSERT_EQ(0, num_checks);
+}
@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include "id_bitmap.h"
+#include "ids_t.h"
+
+namespace {
+    std::vector<uint32_t> random_ids(std::mt19937& gen, size_t num_ids, uint32_t max_id) {
+        std::uniform_int_distribution<uint32_t> dist(0, max_id);
+        std::set<uint32_t> ids;
+        while(ids.size() < num_ids) {
+            ids.insert(dist(gen));
+        }
+
+        return std::vector<uint32_t>(ids.begin(), ids.end());
+    }
+
+    std::vector<uint32_t> to_vector(const id_bitmap_t& bitmap) {
+        std::vector<uint32_t> ids;
+        bitmap.to_vector(ids);
+        return ids;
+    }
+}
+
+TEST(IdBitmapTest, AddRemoveAndContains) {
+    id_bitmap_t bitmap;
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_EQ(0, bitmap.first_id());
+    ASSERT_EQ(UINT32_MAX, bitmap.last_id());
+
+    bitmap.add(100);
+    bitmap.add(5);
+    bitmap.add(70000);
+    bitmap.add(5);
+
+    ASSERT_EQ(3, bitmap.cardinality());
+    ASSERT_EQ(2, bitmap.num_containers());
+    ASSERT_EQ(5, bitmap.first_id());
+    ASSERT_EQ(70000, bitmap.last_id());
+    ASSERT_TRUE(bitmap.contains(100));
+    ASSERT_FALSE(bitmap.contains(101));
+
+    bitmap.remove(70000);
+    ASSERT_EQ(1, bitmap.num_containers());
+    ASSERT_EQ(100, bitmap.last_id());
+
+    // crossing the array container limit turns the chunk into a bit set and back
+    for(uint32_t i = 0; i < 5000; i++) {
+        bitmap.add(i * 2);
+    }
+
+    ASSERT_EQ(5001, bitmap.cardinality());
+    ASSERT_TRUE(bitmap.contains(9998));
+    ASSERT_TRUE(bitmap.contains(5));
+    ASSERT_FALSE(bitmap.contains(9999));
+    ASSERT_EQ(9998, bitmap.last_id());
+
+    for(uint32_t i = 0; i < 4000; i++) {
+        bitmap.remove(i * 2);
+    }
+
+    ASSERT_EQ(1001, bitmap.cardinality());
+    ASSERT_EQ(5, bitmap.first_id());
+
+    std::vector<uint32_t> ids = to_vector(bitmap);
+    ASSERT_EQ(1001, ids.size());
+    ASSERT_EQ(5, ids[0]);
+    ASSERT_EQ(8000, ids[1]);
+    ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+}
+
+TEST(IdBitmapTest, SetOperationsMatchSortedArrays) {
+    std::mt19937 gen(137723);
+
+    // mix of sparse and dense chunks
+    const std::vector<std::pair<size_t, uint32_t>> shapes = {
+        {100, 1000000}, {20000, 100000}, {60000, 70000}, {3000, 200000}
+    };
+
+    for(const auto& shape_a: shapes) {
+        for(const auto& shape_b: shapes) {
+            std::vector<uint32_t> a = random_ids(gen, shape_a.first, shape_a.second);
+            std::vector<uint32_t> b = random_ids(gen, shape_b.first, shape_b.second);
+
+            std::vector<uint32_t> expected_or, expected_and, expected_and_not;
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_or));
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_and));
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_and_not));
+
+            const id_bitmap_t bitmap_b(b.data(), b.size());
+
+            id_bitmap_t bitmap_or(a.data(), a.size());
+            bitmap_or.or_with(bitmap_b);
+            ASSERT_EQ(expected_or, to_vector(bitmap_or));
+            ASSERT_EQ(expected_or.size(), bitmap_or.cardinality());
+
+            id_bitmap_t bitmap_and(a.data(), a.size());
+            bitmap_and.and_with(bitmap_b);
+            ASSERT_EQ(expected_and, to_vector(bitmap_and));
+            ASSERT_EQ(expected_and.size(), bitmap_and.cardinality());
+
+            id_bitmap_t bitmap_and_not(a.data(), a.size());
+            bitmap_and_not.and_not(bitmap_b);
+            ASSERT_EQ(expected_and_not, to_vector(bitmap_and_not));
+            ASSERT_EQ(expected_and_not.size(), bitmap_and_not.cardinality());
+
+            uint32_t* uncompressed = bitmap_and_not.uncompress();
+            ASSERT_TRUE(std::equal(expected_and_not.begin(), expected_and_not.end(), uncompressed));
+            delete [] uncompressed;
+        }
+    }
+}
+
+TEST(IdBitmapTest, IteratorWalksAndSkipsAcrossContainers) {
+    std::mt19937 gen(137723);
+
+    // sparse chunk, dense chunk and a chunk with a gap of empty chunks before it
+    std::vector<uint32_t> ids = random_ids(gen, 100, 60000);
+    std::vector<uint32_t> dense_ids = random_ids(gen, 20000, 65535);
+    for(uint32_t id: dense_ids) {
+        ids.push_back(id + (1 << 16));
+    }
+    ids.push_back(10 << 16);
+    ids.push_back((10 << 16) + 65535);
+
+    const id_bitmap_t bitmap(ids.data(), ids.size());
+    ASSERT_EQ(ids, to_vector(bitmap));
+
+    std::vector<uint32_t> iterated_ids;
+    for(auto it = bitmap.new_iterator(); it.valid(); it.next()) {
+        iterated_ids.push_back(it.id());
+    }
+
+    ASSERT_EQ(ids, iterated_ids);
+
+    std::uniform_int_distribution<uint32_t> dist(0, ids.back() + 1);
+
+    for(size_t i = 0; i < 1000; i++) {
+        auto it = bitmap.new_iterator();
+        uint32_t target = 0;
+
+        // skip forward a few times from the same iterator
+        for(size_t j = 0; j < 3; j++) {
+            target = std::max(target, dist(gen));
+            it.skip_to(target);
+
+            auto expected = std::lower_bound(ids.begin(), ids.end(), target);
+            ASSERT_EQ(expected != ids.end(), it.valid());
+            if(expected != ids.end()) {
+                ASSERT_EQ(*expected, it.id());
+            }
+        }
+    }
+
+    ASSERT_FALSE(id_bitmap_t().new_iterator().valid());
+}
+
+TEST(IdBitmapTest, IteratorSkipsToChunkBoundaryOfBitset) {
+    // a sparse chunk followed by a dense chunk that doesn't hold the first ID of its range
+    std::vector<uint32_t> ids = {5, 100};
+    for(uint32_t id = 1; id < 20000; id++) {
+        ids.push_back((1 << 16) + id * 3);
+    }
+
+    const id_bitmap_t bitmap(ids.data(), ids.size());
+
+    auto it = bitmap.new_iterator();
+    it.skip_to(1 << 16);
+    ASSERT_TRUE(it.valid());
+    ASSERT_EQ((1 << 16) + 3, it.id());
+
+    it = bitmap.new_iterator();
+    it.skip_to(2 << 16);
+    ASSERT_FALSE(it.valid());
+}
+
+TEST(IdBitmapTest, IntersectAndMergeBitmapWithOtherLists) {
+    std::mt19937 gen(137723);
+
+    std::vector<uint32_t> dense_a = random_ids(gen, 20000, 100000);
+    std::vector<uint32_t> dense_b = random_ids(gen, 30000, 100000);
+    std::vector<uint32_t> sparse = random_ids(gen, 2000, 100000);
+
+    void* bitmap_a = SET_BITMAP_IDS(new id_bitmap_t(dense_a.data(), dense_a.size()));
+    void* bitmap_b = SET_BITMAP_IDS(new id_bitmap_t(dense_b.data(), dense_b.size()));
+    void* list = new id_list_t(ids_t::MAX_BLOCK_ELEMENTS);
+    for(uint32_t id: sparse) {
+        ids_t::upsert(list, id);
+    }
+
+    ASSERT_FALSE(IS_BITMAP_IDS(list));
+
+    std::vector<uint32_t> expected_and, expected_and_all, expected_or, expected_or_all;
+    std::set_intersection(dense_a.begin(), dense_a.end(), dense_b.begin(), dense_b.end(),
+                          std::back_inserter(expected_and));
+    std::set_intersection(expected_and.begin(), expected_and.end(), sparse.begin(), sparse.end(),
+                          std::back_inserter(expected_and_all));
+    std::set_union(dense_a.begin(), dense_a.end(), dense_b.begin(), dense_b.end(),
+                   std::back_inserter(expected_or));
+    std::set_union(expected_or.begin(), expected_or.end(), sparse.begin(), sparse.end(),
+                   std::back_inserter(expected_or_all));
+
+    std::vector<uint32_t> result_ids;
+    ids_t::intersect({bitmap_a, bitmap_b}, result_ids);
+    ASSERT_EQ(expected_and, result_ids);
+
+    result_ids.clear();
+    ids_t::intersect({bitmap_a, list, bitmap_b}, result_ids);
+    ASSERT_EQ(expected_and_all, result_ids);
+
+    result_ids.clear();
+    ids_t::merge({bitmap_a, bitmap_b}, result_ids);
+    ASSERT_EQ(expected_or, result_ids);
+
+    result_ids.clear();
+    ids_t::merge({list, bitmap_a, bitmap_b}, result_ids);
+    ASSERT_EQ(expected_or_all, result_ids);
+
+    ids_t::destroy_list(bitmap_a);
+    ids_t::destroy_list(bitmap_b);
+    ids_t::destroy_list(list);
+}
+
+TEST(IdBitmapTest, DenseIdsListSwitchesToBitmap) {
+    void* obj = SET_COMPACT_IDS(compact_id_list_t::create(1, std::vector<uint32_t>{0}));
+
+    for(uint32_t id = 0; id < ids_t::BITMAP_THRESHOLD_LENGTH; id++) {
+        ids_t::upsert(obj, id * 2);
+    }
+
+    ASSERT_TRUE(IS_BITMAP_IDS(obj));
+    ASSERT_EQ(ids_t::BITMAP_THRESHOLD_LENGTH, ids_t::num_ids(obj));
+    ASSERT_EQ(0, ids_t::first_id(obj));
+    ASSERT_TRUE(ids_t::contains(obj, 200));
+    ASSERT_FALSE(ids_t::contains(obj, 201));
+
+    id_bitmap_t merged;
+    ids_t::merge(obj, merged);
+    ASSERT_EQ(ids_t::BITMAP_THRESHOLD_LENGTH, merged.cardinality());
+
+    std::vector<uint32_t> intersected;
+    ids_t::intersect({obj}, intersected);
+    ASSERT_EQ(ids_t::BITMAP_THRESHOLD_LENGTH, intersected.size());
+
+    for(uint32_t id = 0; id < ids_t::BITMAP_THRESHOLD_LENGTH; id++) {
+        ids_t::erase(obj, id * 2);
+    }
+
+    ASSERT_FALSE(IS_BITMAP_IDS(obj));
+    ASSERT_EQ(0, ids_t::num_ids(obj));
+    ids_t::destroy_list(obj);
+
+    // sparse lists stay as block based lists
+    obj = SET_COMPACT_IDS(compact_id_list_t::create(1, std::vector<uint32_t>{0}));
+
+    for(uint32_t id = 0; id < ids_t::BITMAP_THRESHOLD_LENGTH; id++) {
+        ids_t::upsert(obj, id * 100);
+    }
+
+    ASSERT_FALSE(IS_BITMAP_IDS(obj));
+    ASSERT_FALSE(IS_COMPACT_IDS(obj));
+    ids_t::destroy_list(obj);
+}
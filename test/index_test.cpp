@@ -128,3 +128,13 @@ TEST(IndexTest, GeoPointPackUnpack) {
         ASSERT_FLOAT_EQ(latlng.second, s2LatLng.lng().degrees());
     }
 }
+
+TEST(IndexTest, FacetCacheKeyOfRanges) {
+    std::vector<filter> filters;
+    facet narrow_facet("price", {facet_range_t{"cheap", 0, 49}});
+    facet wide_facet("price", {facet_range_t{"cheap", 0, 99}});
+
+    ASSERT_NE(Index::get_facet_cache_key(filters, narrow_facet), Index::get_facet_cache_key(filters, wide_facet));
+    ASSERT_EQ(Index::get_facet_cache_key(filters, wide_facet),
+              Index::get_facet_cache_key(filters, facet("price", {facet_range_t{"cheap", 0, 99}})));
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "infix_index.h"
+
+TEST(InfixIndexTest, CandidatesShareAllTrigrams) {
+    infix_index_t infix_index;
+    infix_index.insert("gh100037in8900x");
+    infix_index.insert("yhd3342d78912");
+    infix_index.insert("100037");
+    infix_index.insert("37100");
+    infix_index.insert("ab");
+
+    // duplicate inserts are ignored
+    infix_index.insert("100037");
+    ASSERT_EQ(5, infix_index.size());
+
+    std::vector<uint32_t> candidate_ids;
+    ASSERT_TRUE(infix_index.get_candidates("100037", candidate_ids));
+    ASSERT_EQ(2, candidate_ids.size());
+    ASSERT_EQ("gh100037in8900x", infix_index.get_token(candidate_ids[0]));
+    ASSERT_EQ("100037", infix_index.get_token(candidate_ids[1]));
+
+    // "371" and "710" are shared, but not "100"
+    candidate_ids.clear();
+    ASSERT_TRUE(infix_index.get_candidates("3710", candidate_ids));
+    ASSERT_EQ(1, candidate_ids.size());
+    ASSERT_EQ("37100", infix_index.get_token(candidate_ids[0]));
+
+    candidate_ids.clear();
+    ASSERT_TRUE(infix_index.get_candidates("zzz", candidate_ids));
+    ASSERT_TRUE(candidate_ids.empty());
+
+    // queries shorter than a trigram have to look at every token
+    ASSERT_FALSE(infix_index.get_candidates("ab", candidate_ids));
+    ASSERT_EQ(5, infix_index.num_token_ids());
+
+    // erased ids are reused
+    infix_index.erase("100037");
+    infix_index.erase("100037");
+    ASSERT_EQ(4, infix_index.size());
+    ASSERT_EQ("", infix_index.get_token(2));
+
+    candidate_ids.clear();
+    ASSERT_TRUE(infix_index.get_candidates("100037", candidate_ids));
+    ASSERT_EQ(1, candidate_ids.size());
+    ASSERT_EQ("gh100037in8900x", infix_index.get_token(candidate_ids[0]));
+
+    infix_index.insert("1000");
+    ASSERT_EQ(5, infix_index.num_token_ids());
+    ASSERT_EQ("1000", infix_index.get_token(2));
+
+    for(const auto& token: {"gh100037in8900x", "yhd3342d78912", "37100", "ab", "1000"}) {
+        infix_index.erase(token);
+    }
+
+    ASSERT_EQ(0, infix_index.size());
+    ASSERT_EQ(0, infix_index.num_grams());
+}
+
+TEST(InfixIndexTest, CandidatesMatchFullScan) {
+    infix_index_t infix_index;
+    std::mt19937 rng(42);
+    std::vector<std::string> tokens;
+
+    for(size_t i = 0; i < 20000; i++) {
+        std::string token;
+        size_t len = 2 + rng() % 12;
+        for(size_t j = 0; j < len; j++) {
+            token += "abcd0123"[rng() % 8];
+        }
+
+        tokens.push_back(token);
+        infix_index.insert(token);
+    }
+
+    // erase every third token so that some ids are free
+    for(size_t i = 0; i < tokens.size(); i += 3) {
+        infix_index.erase(tokens[i]);
+    }
+
+    for(const std::string query: {"abc", "0123", "a0b1", "dddd", "c3c3c", "bad"}) {
+        std::vector<uint32_t> candidate_ids;
+        ASSERT_TRUE(infix_index.get_candidates(query, candidate_ids));
+
+        std::vector<std::string> matched_tokens;
+        for(auto id: candidate_ids) {
+            if(infix_index.get_token(id).find(query) != std::string::npos) {
+                matched_tokens.push_back(infix_index.get_token(id));
+            }
+        }
+
+        std::vector<std::string> expected_tokens;
+        for(size_t id = 0; id < infix_index.num_token_ids(); id++) {
+            if(infix_index.get_token(id).find(query) != std::string::npos) {
+                expected_tokens.push_back(infix_index.get_token(id));
+            }
+        }
+
+        std::sort(matched_tokens.begin(), matched_tokens.end());
+        std::sort(expected_tokens.begin(), expected_tokens.end());
+        ASSERT_FALSE(expected_tokens.empty());
+        ASSERT_EQ(expected_tokens, matched_tokens);
+    }
+}
@@ -885,6 +885,54 @@ TEST_F(PostingListTest, IntersectionSkipBlocks) {
     delete [] final_results;
 }
 
+TEST_F(PostingListTest, IntersectionOfTwoLargeLists) {
+    std::vector<uint32_t> offsets = {0, 1, 3};
+    std::vector<uint32_t> p1_ids, p2_ids, expected_ids;
+
+    for(uint32_t i = 0; i < 5000; i++) {
+        if(i % 3 == 0) {
+            p1_ids.push_back(i);
+        }
+
+        if(i % 5 == 0 || (i > 4000 && i % 7 == 0)) {
+            p2_ids.push_back(i);
+        }
+    }
+
+    std::set_intersection(p1_ids.begin(), p1_ids.end(), p2_ids.begin(), p2_ids.end(),
+                          std::back_inserter(expected_ids));
+
+    // uneven block sizes so that block boundaries don't line up
+    posting_list_t p1(100);
+    posting_list_t p2(37);
+
+    for(auto id: p1_ids) {
+        p1.upsert(id, offsets);
+    }
+
+    for(auto id: p2_ids) {
+        p2.upsert(id, offsets);
+    }
+
+    std::vector<posting_list_t*> lists = {&p1, &p2};
+    std::vector<uint32_t> result_ids;
+    posting_list_t::intersect(lists, result_ids);
+
+    ASSERT_EQ(expected_ids, result_ids);
+
+    // filtered block intersection must agree too
+    std::vector<uint32_t> filter_ids = {0, 15, 30, 31, 4095, 4200, 4935};
+    result_iter_state_t iter_state(nullptr, 0, &filter_ids[0], filter_ids.size());
+    std::vector<uint32_t> filtered_ids;
+
+    posting_t::block_intersector_t({&p1, &p2}, iter_state, pool).intersect(
+        [&](uint32_t id, std::vector<posting_list_t::iterator_t>& its, size_t index) {
+            filtered_ids.push_back(id);
+        }, 1);
+
+    ASSERT_EQ(std::vector<uint32_t>({0, 15, 30, 4095, 4200, 4935}), filtered_ids);
+}
+
 TEST_F(PostingListTest, PostingListContainsAtleastOne) {
     // when posting list is larger than target IDs
     posting_list_t p1(100);
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include "sort_values.h"
+
+TEST(SortValuesTest, DenseFieldSwitchesToChunks) {
+    sort_values_t values;
+
+    for(uint32_t seq_id = 0; seq_id < 10000; seq_id++) {
+        if(seq_id % 10 != 3) {
+            values.set(seq_id, int64_t(seq_id) * -7);
+        }
+    }
+
+    ASSERT_TRUE(values.is_dense());
+    ASSERT_EQ(9000, values.size());
+
+    int64_t value = 0;
+    ASSERT_TRUE(values.get(9999, value));
+    ASSERT_EQ(-69993, value);
+    ASSERT_FALSE(values.get(13, value));
+    ASSERT_FALSE(values.get(10000, value));
+    ASSERT_FALSE(values.get(UINT32_MAX, value));
+
+    // overwrite and erase
+    values.set(14, 100);
+    ASSERT_TRUE(values.get(14, value));
+    ASSERT_EQ(100, value);
+    ASSERT_EQ(9000, values.size());
+
+    values.erase(14);
+    values.erase(13);
+    ASSERT_FALSE(values.contains(14));
+    ASSERT_EQ(8999, values.size());
+
+    // removing most of the values turns the field sparse again
+    for(uint32_t seq_id = 0; seq_id < 9000; seq_id++) {
+        values.erase(seq_id);
+    }
+
+    ASSERT_FALSE(values.is_dense());
+    ASSERT_EQ(900, values.size());
+    ASSERT_TRUE(values.get(9999, value));
+    ASSERT_EQ(-69993, value);
+    ASSERT_FALSE(values.contains(9003));
+}
+
+TEST(SortValuesTest, SparseFieldStaysInMap) {
+    sort_values_t values;
+
+    for(uint32_t seq_id = 0; seq_id < 100000; seq_id += 50) {
+        values.set(seq_id, seq_id);
+    }
+
+    ASSERT_FALSE(values.is_dense());
+    ASSERT_EQ(2000, values.size());
+
+    int64_t value = 0;
+    ASSERT_TRUE(values.get(99950, value));
+    ASSERT_EQ(99950, value);
+    ASSERT_FALSE(values.contains(99951));
+}
+
+TEST(SortValuesTest, MatchesMapAcrossConversions) {
+    std::mt19937 gen(4231);
+    std::uniform_int_distribution<uint32_t> seq_id_dist(0, 20000);
+    std::uniform_int_distribution<int64_t> value_dist(INT64_MIN, INT64_MAX);
+
+    sort_values_t values;
+    std::map<uint32_t, int64_t> expected;
+
+    for(size_t round = 0; round < 200000; round++) {
+        const uint32_t seq_id = seq_id_dist(gen);
+
+        // inserts dominate early on and deletes later, to go through both conversions
+        if((round < 100000) == (round % 5 != 0)) {
+            const int64_t value = value_dist(gen);
+            values.set(seq_id, value);
+            expected[seq_id] = value;
+        } else {
+            values.erase(seq_id);
+            expected.erase(seq_id);
+        }
+    }
+
+    ASSERT_EQ(expected.size(), values.size());
+
+    for(uint32_t seq_id = 0; seq_id <= 20001; seq_id++) {
+        int64_t value;
+        const auto it = expected.find(seq_id);
+        ASSERT_EQ(it != expected.end(), values.get(seq_id, value));
+        if(it != expected.end()) {
+            ASSERT_EQ(it->second, value);
+        }
+    }
+}
@@ -165,4 +165,95 @@ TEST(StoreTest, Contains) {
     ASSERT_EQ(true, primary_store.contains("foo4"));
     ASSERT_EQ(false, primary_store.contains("foo"));
     ASSERT_EQ(false, primary_store.contains("foo5"));
-}
\ No newline at end of file
+}
+
+TEST(StoreTest, MultiGet) {
+    std::string primary_store_path = "/tmp/typesense_test/primary_store_test";
+    LOG(INFO) << "Truncating and creating: " << primary_store_path;
+    system(("rm -rf "+primary_store_path+" && mkdir -p "+primary_store_path).c_str());
+
+    Store primary_store(primary_store_path, 0, 0, true);  // disable WAL
+    primary_store.insert("foo1", "bar1");
+    primary_store.insert("foo2", "bar2");
+    primary_store.flush();
+
+    // values both in the memtable and on disk
+    primary_store.insert("foo3", "bar3");
+
+    std::vector<std::string> values;
+    std::vector<StoreStatus> statuses;
+    primary_store.multi_get({"foo3", "foo", "foo1", "foo2", "foo1"}, values, statuses);
+
+    ASSERT_EQ(5, values.size());
+    ASSERT_EQ(5, statuses.size());
+
+    std::vector<std::string> expected_values = {"bar3", "", "bar1", "bar2", "bar1"};
+    std::vector<StoreStatus> expected_statuses = {StoreStatus::FOUND, StoreStatus::NOT_FOUND, StoreStatus::FOUND,
+                                                  StoreStatus::FOUND, StoreStatus::FOUND};
+
+    for(size_t i = 0; i < expected_values.size(); i++) {
+        ASSERT_EQ(expected_values[i], values[i]);
+        ASSERT_EQ(expected_statuses[i], statuses[i]);
+    }
+
+    primary_store.multi_get({}, values, statuses);
+    ASSERT_TRUE(values.empty());
+    ASSERT_TRUE(statuses.empty());
+}
+
+TEST(StoreTest, DISABLED_BenchmarkMultiGet) {
+    std::string primary_store_path = "/tmp/typesense_test/primary_store_test";
+    LOG(INFO) << "Truncating and creating: " << primary_store_path;
+    system(("rm -rf "+primary_store_path+" && mkdir -p "+primary_store_path).c_str());
+
+    Store primary_store(primary_store_path, 0, 0, true);  // disable WAL
+
+    const size_t num_docs = 500000;
+    const std::string doc(1024, 'x');
+
+    for(size_t i = 0; i < num_docs; i++) {
+        primary_store.insert("doc_" + std::to_string(i), doc);
+    }
+
+    primary_store.flush();
+
+    // a page of 250 hits spread across the key space
+    srand(42);
+    std::vector<std::string> keys;
+    for(size_t i = 0; i < 250; i++) {
+        keys.push_back("doc_" + std::to_string(rand() % num_docs));
+    }
+
+    const size_t num_rounds = 1000;
+    size_t num_found = 0;
+
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    for(size_t round = 0; round < num_rounds; round++) {
+        for(const auto& key: keys) {
+            std::string value;
+            num_found += (primary_store.get(key, value) == StoreStatus::FOUND);
+        }
+    }
+
+    long long int timeMicros =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    LOG(INFO) << "Time taken for " << num_rounds << " pages of 250 single gets: " << timeMicros;
+
+    begin = std::chrono::high_resolution_clock::now();
+
+    for(size_t round = 0; round < num_rounds; round++) {
+        std::vector<std::string> values;
+        std::vector<StoreStatus> statuses;
+        primary_store.multi_get(keys, values, statuses);
+        num_found += std::count(statuses.begin(), statuses.end(), StoreStatus::FOUND);
+    }
+
+    timeMicros =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    LOG(INFO) << "Time taken for " << num_rounds << " pages of 250 keys with multi get: " << timeMicros;
+
+    ASSERT_EQ(2 * num_rounds * keys.size(), num_found);
+}
@@ -296,3 +296,17 @@ TEST(StringUtilsTest, ContainsWord) {
     ASSERT_FALSE(StringUtils::contains_word("foobar baz", "bar baz"));
     ASSERT_FALSE(StringUtils::contains_word("baz foobar", "foo"));
 }
+
+TEST(StringUtilsTest, SplitFacet) {
+    std::vector<std::string> facets;
+    StringUtils::split_facet("brand, price(0..10, 10..50,50..),rating", facets);
+    ASSERT_EQ(std::vector<std::string>({"brand", "price(0..10, 10..50,50..)", "rating"}), facets);
+
+    facets.clear();
+    StringUtils::split_facet("brand,, ", facets);
+    ASSERT_EQ(std::vector<std::string>({"brand"}), facets);
+
+    facets.clear();
+    StringUtils::split_facet("", facets);
+    ASSERT_TRUE(facets.empty());
+}
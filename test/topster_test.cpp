@@ -3,6 +3,8 @@
 #include "topster.h"
 #include "match_score.h"
 #include <fstream>
+#include <map>
+#include <random>
 
 TEST(TopsterTest, MaxIntValues) {
     Topster topster(5);
@@ -241,4 +243,219 @@ TEST(TopsterTest, DistinctIntValues) {
             EXPECT_EQ(9, dist_topster.group_kv_map[dist_topster.getDistinctKeyAt(i)]->getKV(1)->scores[0]);
         }
     }
-}
\ No newline at end of file
+}
+
+TEST(TopsterTest, MatchesNaiveTopKWithDuplicateKeys) {
+    std::mt19937 gen(137);
+    std::uniform_int_distribution<uint64_t> key_dist(0, 2000);
+    std::uniform_int_distribution<int64_t> score_dist(0, 500);
+
+    Topster topster(250);
+    std::map<uint64_t, std::tuple<int64_t, int64_t, int64_t>> best_scores;
+
+    for(size_t i = 0; i < 20000; i++) {
+        int64_t scores[3] = {score_dist(gen), score_dist(gen), 0};
+        const uint64_t key = key_dist(gen);
+
+        KV kv(0, 0, 0, key, key, 0, scores);
+        topster.add(&kv);
+
+        auto score_tuple = std::make_tuple(scores[0], scores[1], scores[2]);
+        auto it = best_scores.find(key);
+        if(it == best_scores.end() || it->second < score_tuple) {
+            best_scores[key] = score_tuple;
+        }
+
+        // keys evicted from the heap must be free to come back
+        if(i == 10000) {
+            topster.clear();
+            best_scores.clear();
+        }
+    }
+
+    std::vector<std::pair<std::tuple<int64_t, int64_t, int64_t>, uint64_t>> expected;
+    for(const auto& kv: best_scores) {
+        expected.emplace_back(kv.second, kv.first);
+    }
+
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    expected.resize(250);
+
+    topster.sort();
+    ASSERT_EQ(250, topster.size);
+
+    for(uint32_t i = 0; i < topster.size; i++) {
+        ASSERT_EQ(expected[i].second, topster.getKeyAt(i));
+        ASSERT_EQ(std::get<0>(expected[i].first), topster.getKV(i)->scores[0]);
+        ASSERT_EQ(std::get<1>(expected[i].first), topster.getKV(i)->scores[1]);
+    }
+
+    // merging the top-K of parts of the input gives the top-K of the whole
+    std::vector<Topster*> part_topsters;
+    for(size_t part = 0; part < 4; part++) {
+        part_topsters.push_back(new Topster(250));
+    }
+
+    size_t part = 0;
+    for(const auto& kv: best_scores) {
+        int64_t scores[3] = {std::get<0>(kv.second), std::get<1>(kv.second), std::get<2>(kv.second)};
+        KV part_kv(0, 0, 0, kv.first, kv.first, 0, scores);
+        part_topsters[part++ % 4]->add(&part_kv);
+    }
+
+    Topster agg_topster(250);
+    for(auto part_topster: part_topsters) {
+        Index::aggregate_topster(&agg_topster, part_topster);
+        delete part_topster;
+    }
+
+    agg_topster.sort();
+    ASSERT_EQ(250, agg_topster.size);
+
+    for(uint32_t i = 0; i < agg_topster.size; i++) {
+        ASSERT_EQ(expected[i].second, agg_topster.getKeyAt(i));
+    }
+}
+
+TEST(TopsterTest, PagingWithCursor) {
+    std::mt19937 gen(137);
+    std::uniform_int_distribution<uint64_t> key_dist(0, 500);
+    std::uniform_int_distribution<int64_t> score_dist(0, 50);
+
+    // documents are scored more than once, in no particular order
+    std::vector<KV> kvs;
+    std::map<uint64_t, std::tuple<int64_t, int64_t>> best_scores;
+
+    for(size_t i = 0; i < 5000; i++) {
+        int64_t scores[3] = {score_dist(gen), score_dist(gen), 0};
+        const uint64_t key = key_dist(gen);
+        kvs.emplace_back(0, 0, 0, key, key, 0, scores);
+
+        auto score_tuple = std::make_tuple(scores[0], scores[1]);
+        auto it = best_scores.find(key);
+        if(it == best_scores.end() || it->second < score_tuple) {
+            best_scores[key] = score_tuple;
+        }
+    }
+
+    std::vector<std::pair<std::tuple<int64_t, int64_t>, uint64_t>> expected;
+    for(const auto& kv: best_scores) {
+        expected.emplace_back(kv.second, kv.first);
+    }
+
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+
+    std::vector<uint64_t> paged_keys;
+    const KV* cursor_kv = nullptr;
+    KV last_kv;
+
+    const auto search_page = [&](const size_t capacity) {
+        // split across "threads" that are aggregated, like a search does
+        Topster* topster = new Topster(capacity);
+        std::vector<Topster*> thread_topsters;
+
+        for(size_t i = 0; i < 3; i++) {
+            thread_topsters.push_back(new Topster(capacity));
+            if(cursor_kv != nullptr) {
+                thread_topsters[i]->set_cursor(cursor_kv->scores, cursor_kv->key);
+            }
+        }
+
+        for(size_t i = 0; i < kvs.size(); i++) {
+            KV kv(0, 0, 0, kvs[i].key, kvs[i].key, 0, kvs[i].scores);
+            thread_topsters[(i / 7) % 3]->add(&kv);
+        }
+
+        if(cursor_kv != nullptr) {
+            topster->set_cursor(cursor_kv->scores, cursor_kv->key);
+        }
+
+        for(auto thread_topster: thread_topsters) {
+            Index::aggregate_topster(topster, thread_topster);
+            delete thread_topster;
+        }
+
+        topster->sort();
+        return topster;
+    };
+
+    size_t num_lossy_pages = 0;
+
+    while(true) {
+        Topster* topster = search_page(20);
+
+        if(topster->is_cursor_lossy()) {
+            num_lossy_pages++;
+            const size_t capacity = 20 + topster->num_cursor_skipped();
+            delete topster;
+            topster = search_page(capacity);
+        }
+
+        for(uint32_t i = 0; i < std::min<uint32_t>(20, topster->size); i++) {
+            paged_keys.push_back(topster->getKeyAt(i));
+        }
+
+        if(topster->size < 20) {
+            delete topster;
+            break;
+        }
+
+        last_kv = *topster->getKV(19);
+        cursor_kv = &last_kv;
+        delete topster;
+    }
+
+    ASSERT_LT(0, num_lossy_pages);
+    ASSERT_EQ(expected.size(), paged_keys.size());
+
+    for(size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(expected[i].second, paged_keys[i]);
+    }
+}
+
+TEST(TopsterTest, DISABLED_BenchmarkAdd) {
+    std::mt19937 gen(137);
+    std::uniform_int_distribution<uint64_t> key_dist(0, 1000000);
+    std::uniform_int_distribution<int64_t> score_dist(0, 1000000);
+
+    std::vector<KV> kvs;
+    for(size_t i = 0; i < 5000000; i++) {
+        int64_t scores[3] = {score_dist(gen), score_dist(gen), 0};
+        const uint64_t key = key_dist(gen);
+        kvs.emplace_back(0, 0, 0, key, key, 0, scores);
+    }
+
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    Topster topster(250);
+    for(auto& kv: kvs) {
+        topster.add(&kv);
+    }
+
+    long long int timeMicros =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    LOG(INFO) << "Time taken for " << kvs.size() << " topster additions: " << timeMicros;
+
+    std::vector<Topster*> thread_topsters;
+    for(size_t i = 0; i < 8; i++) {
+        thread_topsters.push_back(new Topster(250));
+    }
+
+    for(size_t i = 0; i < kvs.size(); i++) {
+        thread_topsters[i % 8]->add(&kvs[i]);
+    }
+
+    begin = std::chrono::high_resolution_clock::now();
+
+    Topster agg_topster(250);
+    for(auto thread_topster: thread_topsters) {
+        Index::aggregate_topster(&agg_topster, thread_topster);
+        delete thread_topster;
+    }
+
+    timeMicros =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    LOG(INFO) << "Time taken for aggregating " << thread_topsters.size() << " topsters: " << timeMicros;
+}